@@ -0,0 +1,1305 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+/*
+ *  Headless benchmark of the processing behind the probe viewer: the
+ *  referencing, ring writes and reductions done on the audio thread, the
+ *  StreamAnalyser pass of the analysis thread (ring reads, pixel
+ *  reduction, filtering and band power), that reduction compiled for each
+ *  sample storage and filter state against one loop testing both at run
+ *  time, the band power FFTs through kiss_fftr as the canvas once took
+ *  them and through BatchedFFT, and the colour mapping of the renderer.
+ *
+ *  Everything here is free of JUCE, so it builds and runs without the GUI
+ *  (see CMakeLists.txt in this directory). The stages call the same classes
+ *  the plugin does. The input is a synthetic 384-channel probe at 30 kHz,
+ *  and every stage reports the channel samples it handles per second, its
+ *  speed relative to real time, the time per pixel of one channel where it
+ *  produces pixels, and the operator new calls it made once warmed up,
+ *  which should stay at zero.
+ *
+ *  Before that it checks the sliding DFT band power against kiss_fftr, and
+ *  the spectral decimator's filters and output rates, and exits with 1 if
+ *  any check fails. It also exits with 1 if any stage allocates once
+ *  warmed up.
+ *
+ *  Usage: ProbeViewerBenchmark [seconds of data per stage] [threads, 0 for every core]
+ */
+
+#include "Processing/BatchedFFT.hpp"
+#include "Processing/BiquadFilterBank.hpp"
+#include "Processing/ChannelReferencer.hpp"
+#include "Processing/PixelColumnReducer.hpp"
+#include "Processing/PixelKernels.hpp"
+#include "Processing/SlidingDFT.hpp"
+#include "Processing/SpectralDecimator.hpp"
+#include "Processing/SpikeDetector.hpp"
+#include "Processing/StreamAnalyser.hpp"
+#include "Processing/SummaryPyramid.hpp"
+#include "Utilities/ColourMap.hpp"
+#include "Utilities/PixelColumnQueue.hpp"
+#include "Utilities/SampleRing.hpp"
+#include "Utilities/WorkStealingPool.hpp"
+#include "kissfft/kiss_fftr.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace ProbeViewer;
+
+#pragma mark - Allocation counting -
+
+namespace {
+std::atomic<long long> numAllocations { 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size > 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace {
+
+#pragma mark - Layout -
+
+// a Neuropixels 1.0 probe
+const int numChannels = 384;
+const float sampleRate = 30000.0f;
+
+// samples per audio callback
+const int blockSamples = 1024;
+
+// samples per analysis pass, about one refresh of the canvas
+const int readSamples = 1500;
+
+// the raw sample ring, shorter than CircularBuffer's 10 s but still far
+// larger than the caches; not a multiple of readSamples, so reads wrap
+// around it at changing points
+const int ringSamples = int(sampleRate * 2.1f);
+
+// the scale of int16 samples, as a Neuropixels 1.0 channel
+const float bitVolts = 0.195f;
+
+// the default 10 s window across ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH pixels
+const int displayWidth = 1920;
+const int samplesPerPixel = int(sampleRate * 10.0f / displayWidth);
+
+// as ProbeViewerCanvas: 256-point FFTs of samples decimated to 1 kHz by default
+const int defaultFFTSize = 256;
+const float spectralSampleRate = 1000.0f;
+const int fftBin = 10;
+
+// channels per pool task, as ProbeViewerCanvas
+const int channelsPerTask = BiquadFilterBank::numLanes;
+
+// pixels of a channel per second of data
+const int pixelsPerSecond = int(sampleRate) / samplesPerPixel;
+
+const float spikeThresholdFactor = 4.0f;
+
+#pragma mark - Synthetic probe -
+
+/**
+ *  One second of every channel: a DC offset, white noise, a travelling
+ *  LFP wave, line noise shared by every channel, and spikes about 10 times
+ *  a second per channel. The benchmarks loop over it.
+ */
+class SyntheticProbe
+{
+public:
+    SyntheticProbe()
+        : numSamples(int(sampleRate))
+        , samples(size_t(numChannels) * numSamples)
+    {
+        std::mt19937 random(2017);
+        std::normal_distribution<float> noise(0.0f, 8.0f);
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+        const float twoPi = 6.283185307f;
+        const float spikeProbability = 10.0f / sampleRate;
+        const int spikeSamples = 30;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* row = getRow(channel);
+            const float offset = 200.0f * std::sin(0.37f * channel);
+            int spikeRemaining = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float t = i / sampleRate;
+
+                float value = offset + noise(random)
+                    + 60.0f * std::sin(twoPi * 8.0f * t + 0.01f * channel)
+                    + 20.0f * std::sin(twoPi * 60.0f * t);
+
+                if (spikeRemaining == 0 && uniform(random) < spikeProbability)
+                    spikeRemaining = spikeSamples;
+
+                if (spikeRemaining > 0)
+                {
+                    // a sharp trough followed by a slow recovery
+                    const int phase = spikeSamples - spikeRemaining;
+                    value -= phase < 6 ? 20.0f * phase : 120.0f * (spikeSamples - phase) / (spikeSamples - 6);
+                    --spikeRemaining;
+                }
+
+                row[i] = value;
+            }
+        }
+    }
+
+    int getNumSamples() const { return numSamples; }
+
+    float* getRow(int channel) { return samples.data() + size_t(channel) * numSamples; }
+    const float* getRow(int channel) const { return samples.data() + size_t(channel) * numSamples; }
+
+private:
+    int numSamples;
+    std::vector<float> samples;     // [channel][sample]
+};
+
+#pragma mark - Measurement -
+
+struct Result
+{
+    double elapsedSeconds;
+    long long numChannelSamples;
+    long long numChannelPixels;
+    long long numAllocations;
+};
+
+// timed stages that allocated, which fails the run
+int numAllocatingStages = 0;
+
+void printHeader(const PixelKernels& kernels, int numThreads)
+{
+    std::printf("%d channels at %.0f Hz, %d samples per pixel, %s kernels, %d threads\n\n",
+                numChannels, sampleRate, samplesPerPixel, kernels.name, numThreads);
+    std::printf("%-32s %12s %10s %10s %8s\n", "stage", "Msamples/s", "realtime", "ns/pixel", "allocs");
+}
+
+void printResult(const char* name, const Result& result)
+{
+    const double dataSeconds = double(result.numChannelSamples) / (double(numChannels) * sampleRate);
+
+    std::printf("%-32s %12.1f %9.1fx ", name,
+                result.numChannelSamples / result.elapsedSeconds / 1.0e6,
+                dataSeconds / result.elapsedSeconds);
+
+    if (result.numChannelPixels > 0)
+        std::printf("%10.1f", result.elapsedSeconds * 1.0e9 / result.numChannelPixels);
+    else
+        std::printf("%10s", "-");
+
+    std::printf(" %8lld\n", result.numAllocations);
+
+    if (result.numAllocations != 0)
+        ++numAllocatingStages;
+}
+
+/**
+ *  Run one second of data through processSecond once to warm up, then
+ *  numSeconds more times while timing it. processSecond returns the number
+ *  of channel pixels it produced.
+ */
+template <typename Function>
+Result measure(int numSeconds, const SyntheticProbe& probe, Function&& processSecond)
+{
+    processSecond();
+
+    Result result {};
+    const long long allocationsBefore = numAllocations.load();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int second = 0; second < numSeconds; ++second)
+        result.numChannelPixels += processSecond();
+
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.numAllocations = numAllocations.load() - allocationsBefore;
+    result.numChannelSamples = (long long) numSeconds * numChannels * probe.getNumSamples();
+
+    return result;
+}
+
+#pragma mark - Audio thread stages -
+
+Result benchmarkReference(int numSeconds, const SyntheticProbe& probe, ReferenceMode mode)
+{
+    ChannelReferencer referencer;
+    referencer.prepare(numChannels, 256);
+
+    std::vector<const float*> sources(numChannels);
+
+    return measure(numSeconds, probe, [&]() -> long long
+    {
+        // in parts, as CircularBuffer::addBlock
+        for (int first = 0; first < probe.getNumSamples(); first += referencer.getMaxBlockSamples())
+        {
+            const int numSamples = std::min(referencer.getMaxBlockSamples(), probe.getNumSamples() - first);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                sources[channel] = probe.getRow(channel) + first;
+
+            referencer.process(sources.data(), numSamples, mode);
+        }
+
+        return 0;
+    });
+}
+
+/** Write every row of a block into the ring at a time, as CircularBuffer::addRows */
+void writeBlockToRing(SampleRing& ring, const SyntheticProbe& probe, int first, int numSamples)
+{
+    for (int row = 0; row < numChannels; ++row)
+        ring.writeRow(row, probe.getRow(row) + first, 1.0f / bitVolts, numSamples);
+
+    ring.advance(numSamples);
+}
+
+Result benchmarkSampleRing(int numSeconds, const SyntheticProbe& probe, SampleStorage storage)
+{
+    SampleRing ring;
+    ring.prepare(numChannels, ringSamples, storage);
+
+    return measure(numSeconds, probe, [&]() -> long long
+    {
+        for (int first = 0; first < probe.getNumSamples(); first += blockSamples)
+            writeBlockToRing(ring, probe, first, std::min(blockSamples, probe.getNumSamples() - first));
+
+        return 0;
+    });
+}
+
+/**
+ *  The audio thread's PixelColumnReducer, and, given a pool, the analysis
+ *  thread turning its columns into pixels with a StreamAnalyser, as
+ *  ProbeViewerCanvas::updateScreenBuffersFromPixelColumns
+ */
+Result benchmarkPixelColumns(int numSeconds, const SyntheticProbe& probe, WorkStealingPool* pool)
+{
+    PixelColumnReducer reducer;
+    reducer.prepare(numChannels, samplesPerPixel, sampleRate, spectralSampleRate, displayWidth,
+                    SpikeDetector::getRefractorySamples(sampleRate));
+    reducer.setSpikeThresholdFactor(spikeThresholdFactor);
+
+    StreamAnalyser analyser;
+    PixelColumnQueue columns;
+
+    if (pool != nullptr)
+    {
+        analyser.prepare(numChannels, sampleRate, samplesPerPixel, spectralSampleRate, pool->getNumThreads());
+        analyser.setSpectrum(defaultFFTSize, 1, defaultFFTSize / 2, fftBin);
+        columns.prepare(NUM_PIXEL_METRICS * numChannels, blockSamples / samplesPerPixel + 2);
+    }
+
+    return measure(numSeconds, probe, [&]() -> long long
+    {
+        long long numColumns = 0;
+
+        for (int first = 0; first < probe.getNumSamples(); first += blockSamples)
+        {
+            const int numSamples = std::min(blockSamples, probe.getNumSamples() - first);
+
+            reducer.beginBlock(numSamples);
+
+            for (int begin = 0; begin < numChannels; begin += SpectralDecimator::numLanes)
+            {
+                const float* rows[SpectralDecimator::numLanes];
+                const int numGroupChannels = std::min(SpectralDecimator::numLanes, numChannels - begin);
+
+                for (int lane = 0; lane < numGroupChannels; ++lane)
+                    rows[lane] = probe.getRow(begin + lane) + first;
+
+                reducer.addChannelGroup(begin, numGroupChannels, rows, numSamples);
+            }
+
+            reducer.finishBlock(numSamples);
+
+            const auto range = reducer.beginRead();
+            numColumns += range.getLength();
+
+            if (pool != nullptr)
+            {
+                pool->parallelFor(numChannels, channelsPerTask, [&](int begin, int end, int threadIndex)
+                {
+                    for (int64_t column = range.start; column < range.end; ++column)
+                    {
+                        analyser.addReducedColumnForChannelGroup(begin, end, reducer, column,
+                                                                 columns.getWritableColumn(int(column - range.start)), threadIndex);
+                    }
+                });
+
+                columns.finishPush(range.getLength());
+                columns.pop(columns.getNumReady());
+            }
+
+            reducer.endRead(range);
+        }
+
+        return numColumns * numChannels;
+    });
+}
+
+Result benchmarkSpectralDecimator(int numSeconds, const SyntheticProbe& probe)
+{
+    SpectralDecimator decimator;
+    decimator.prepare(numChannels, sampleRate, spectralSampleRate);
+
+    std::vector<float> scratch(decimator.getScratchSize());
+    std::vector<float> output(size_t(decimator.getMaxNumOutputs(blockSamples)) * SpectralDecimator::numLanes);
+    float scales[SpectralDecimator::numLanes];
+    std::fill(scales, scales + SpectralDecimator::numLanes, 1.0f);
+
+    return measure(numSeconds, probe, [&]() -> long long
+    {
+        for (int first = 0; first < probe.getNumSamples(); first += blockSamples)
+        {
+            const int numSamples = std::min(blockSamples, probe.getNumSamples() - first);
+
+            for (int begin = 0; begin < numChannels; begin += SpectralDecimator::numLanes)
+            {
+                const float* inputs[SpectralDecimator::numLanes];
+                const int numGroupChannels = std::min(SpectralDecimator::numLanes, numChannels - begin);
+
+                for (int lane = 0; lane < numGroupChannels; ++lane)
+                    inputs[lane] = probe.getRow(begin + lane) + first;
+
+                decimator.process(begin, numGroupChannels, inputs, scales, numSamples, scratch.data(), output.data());
+            }
+        }
+
+        return 0;
+    });
+}
+
+Result benchmarkSummaryPyramid(int numSeconds, const SyntheticProbe& probe)
+{
+    // as CircularBuffer
+    SummaryPyramid pyramid;
+    pyramid.prepare(numChannels, samplesPerPixel, 6, displayWidth + 16384 / samplesPerPixel + 1,
+                    SpikeDetector::getRefractorySamples(sampleRate));
+    pyramid.setSpikeThresholdFactor(spikeThresholdFactor);
+
+    return measure(numSeconds, probe, [&]() -> long long
+    {
+        for (int first = 0; first < probe.getNumSamples(); first += blockSamples)
+        {
+            const int numSamples = std::min(blockSamples, probe.getNumSamples() - first);
+
+            pyramid.beginBlock(numSamples);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                pyramid.addChannel(channel, probe.getRow(channel) + first, numSamples);
+
+            pyramid.finishBlock(numSamples);
+        }
+
+        return 0;
+    });
+}
+
+#pragma mark - Analysis thread stages -
+
+/** The FFT size and Welch averaging of the spectral path, as the FFT options */
+struct SpectrumSettings
+{
+    int fftSize;
+    int numSegments;
+    int hopSize;
+};
+
+const SpectrumSettings defaultSpectrum = { defaultFFTSize, 1, defaultFFTSize / 2 };
+
+/**
+ *  The raw sample pass of ProbeViewerCanvas::updateScreenBuffers: the probe
+ *  is written to a SampleRing as the audio thread would, and every read of
+ *  readSamples hands the spans of each group of channels to a
+ *  StreamAnalyser on the pool, as ProbeViewerCanvas::reduceRangeForChannelGroup
+ *  does. The completed pixel columns are queued and dropped again.
+ */
+class AnalysisBenchmark
+{
+public:
+    AnalysisBenchmark(const SyntheticProbe& probe, WorkStealingPool& pool_, SampleStorage storage, FilterBand band,
+                      const SpectrumSettings& spectrum)
+        : pool(pool_)
+        , readIndex(0)
+    {
+        ring.prepare(numChannels, ringSamples, storage);
+
+        // fill the ring with the probe, looped, a block at a time
+        for (int written = 0, first = 0; written < ringSamples;)
+        {
+            const int numSamples = std::min({ blockSamples, ringSamples - written, probe.getNumSamples() - first });
+
+            writeBlockToRing(ring, probe, first, numSamples);
+
+            written += numSamples;
+            first = (first + numSamples) % probe.getNumSamples();
+        }
+
+        analyser.prepare(numChannels, sampleRate, samplesPerPixel, spectralSampleRate, pool.getNumThreads());
+        analyser.setFilterBand(band);
+        analyser.setSpectrum(spectrum.fftSize, spectrum.numSegments, spectrum.hopSize, fftBin);
+
+        columns.prepare(NUM_PIXEL_METRICS * numChannels, readSamples / samplesPerPixel + 2);
+    }
+
+    /** Switch settings between passes, as the canvas does when the options change */
+    void changeSettings(FilterBand band, const SpectrumSettings& spectrum, int bin, int pixelSize)
+    {
+        analyser.setFilterBand(band);
+        analyser.setSpectrum(spectrum.fftSize, spectrum.numSegments, spectrum.hopSize, bin);
+        analyser.setPixelSize(pixelSize);
+    }
+
+    /** Analyse one second of the ring in reads of readSamples; returns the channel pixels */
+    long long processSecond()
+    {
+        const bool isInt16 = ring.getStorage() == SampleStorage::INT16;
+        long long numChannelPixels = 0;
+
+        for (int first = 0; first < int(sampleRate); first += readSamples)
+        {
+            const int numSamples = std::min(readSamples, int(sampleRate) - first);
+            int numPixels = 0;
+
+            // every group completes the same pixels, as in the canvas
+            pool.parallelFor(numChannels, channelsPerTask, [&](int begin, int end, int threadIndex)
+            {
+                const int numGroupPixels = isInt16
+                    ? reduceGroup<int16_t>(begin, end, numSamples, threadIndex)
+                    : reduceGroup<float>(begin, end, numSamples, threadIndex);
+
+                if (begin == 0)
+                    numPixels = numGroupPixels;
+            });
+
+            columns.finishPush(numPixels);
+            columns.pop(columns.getNumReady());
+
+            readIndex = (readIndex + numSamples) % ringSamples;
+            numChannelPixels += (long long) numPixels * numChannels;
+        }
+
+        return numChannelPixels;
+    }
+
+private:
+    template <typename SampleType>
+    int reduceGroup(int begin, int end, int numSamples, int threadIndex)
+    {
+        const SampleType* inputs[BiquadFilterBank::numLanes];
+        float scales[BiquadFilterBank::numLanes];
+        SampleRing::Spans<SampleType> spans[BiquadFilterBank::numLanes];
+
+        for (int lane = 0; lane < end - begin; ++lane)
+        {
+            spans[lane] = ring.getSpans<SampleType>(begin + lane, readIndex, numSamples);
+            scales[lane] = std::is_same<SampleType, int16_t>::value ? bitVolts : 1.0f;
+        }
+
+        int numPixels = 0;
+
+        for (int part = 0; part < 2; ++part)
+        {
+            for (int lane = 0; lane < end - begin; ++lane)
+                inputs[lane] = part == 0 ? spans[lane].first : spans[lane].second;
+
+            numPixels += analyser.reduceChannelGroup(begin, end, inputs, scales,
+                                                     part == 0 ? spans[0].firstSize : spans[0].secondSize,
+                                                     spikeThresholdFactor, threadIndex, columns, numPixels);
+        }
+
+        return numPixels;
+    }
+
+    WorkStealingPool& pool;
+
+    SampleRing ring;
+    int readIndex;
+
+    StreamAnalyser analyser;
+    PixelColumnQueue columns;
+};
+
+Result benchmarkAnalysis(int numSeconds, const SyntheticProbe& probe, WorkStealingPool& pool, SampleStorage storage, FilterBand band,
+                         const SpectrumSettings& spectrum = defaultSpectrum)
+{
+    AnalysisBenchmark analysis(probe, pool, storage, band, spectrum);
+
+    // measure the steady hop rate, once the Welch average holds all its segments
+    const int warmUpSamples = spectrum.fftSize + (spectrum.numSegments - 1) * spectrum.hopSize;
+    const int warmUpSeconds = int(std::ceil(warmUpSamples / spectralSampleRate));
+
+    for (int second = 0; second < warmUpSeconds; ++second)
+        analysis.processSecond();
+
+    return measure(numSeconds, probe, [&]() -> long long { return analysis.processSecond(); });
+}
+
+/**
+ *  Change every setting the options bar offers before each second, to show
+ *  that only StreamAnalyser::prepare allocates
+ */
+Result benchmarkSettingsChanges(int numSeconds, const SyntheticProbe& probe, WorkStealingPool& pool)
+{
+    const SpectrumSettings spectra[] = { { 4096, 16, 256 }, { 128, 1, 128 }, { 1024, 4, 512 }, { 256, 8, 32 } };
+    const FilterBand bands[] = { FilterBand::AP, FilterBand::NONE, FilterBand::LFP };
+    const int bins[] = { 1, 64, 256, 8, 128 };
+    const int pixelSizes[] = { samplesPerPixel / 4, samplesPerPixel, samplesPerPixel / 2 };
+
+    AnalysisBenchmark analysis(probe, pool, SampleStorage::FLOAT32, FilterBand::NONE, defaultSpectrum);
+    int change = 0;
+
+    return measure(numSeconds, probe, [&]() -> long long
+    {
+        analysis.changeSettings(bands[change % 3], spectra[change % 4], bins[change % 5], pixelSizes[change % 3]);
+        ++change;
+
+        return analysis.processSecond();
+    });
+}
+
+#pragma mark - Reduction variant stages -
+
+/**
+ *  The pixel reduction of StreamAnalyser::reduceRunForChannelGroup without
+ *  the band power: each group filtered a tile at a time when a band is
+ *  selected, then added to the PixelAccumulator and SpikeDetector of its
+ *  channels, run after run as the analysis thread reads them.
+ *
+ *  It runs either compiled for the sample storage and filter state, as
+ *  the analyser is, or as one loop testing both at run time, as the
+ *  canvas reduced before, to show what the specialization is worth. It
+ *  runs on one thread, so the two compare directly.
+ */
+class ReductionBenchmark
+{
+public:
+    ReductionBenchmark(const SyntheticProbe& probe, SampleStorage storage, FilterBand band)
+        : isInt16(storage == SampleStorage::INT16)
+        , isFiltered(band != FilterBand::NONE)
+        , numSamples(probe.getNumSamples())
+        , kernels(getPixelKernels())
+        , int16Samples(isInt16 ? size_t(numChannels) * numSamples : 0)
+        , floatRows(numChannels)
+        , int16Rows(numChannels)
+        , accumulators(numChannels)
+        , detectors(numChannels)
+        , lanes(size_t(BiquadFilterBank::numLanes) * BiquadFilterBank::maxTileSamples)
+        , filtered(lanes.size())
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            floatRows[channel] = probe.getRow(channel);
+            int16Rows[channel] = int16Samples.data() + size_t(channel) * numSamples;
+
+            // as the recording stores them, in steps of bitVolts
+            for (int i = 0; isInt16 && i < numSamples; ++i)
+                int16Samples[size_t(channel) * numSamples + i] = int16_t(std::lround(floatRows[channel][i] / bitVolts));
+
+            accumulators[channel].reset(samplesPerPixel, samplesPerPixel);
+            detectors[channel].reset(SpikeDetector::getRefractorySamples(sampleRate));
+        }
+
+        for (int lane = 0; lane < BiquadFilterBank::numLanes; ++lane)
+        {
+            scales[lane] = isInt16 ? bitVolts : 1.0f;
+            filteredRows[lane] = filtered.data() + size_t(lane) * BiquadFilterBank::maxTileSamples;
+        }
+
+        filterBank.prepare(numChannels, isFiltered ? BiquadFilterBank::designBand(band, sampleRate)
+                                                   : std::vector<BiquadCoefficients>());
+    }
+
+    /** Reduce a second of every channel, in runs of readSamples; returns the channel pixels completed */
+    long long processSecond(bool isSpecialized)
+    {
+        long long numChannelPixels = 0;
+
+        for (int first = 0; first < numSamples; first += readSamples)
+        {
+            const int runSamples = std::min(readSamples, numSamples - first);
+
+            for (int begin = 0; begin < numChannels; begin += BiquadFilterBank::numLanes)
+            {
+                const int end = std::min(begin + BiquadFilterBank::numLanes, numChannels);
+
+                if (!isSpecialized)
+                    numChannelPixels += reduceRunGeneric(begin, end, first, runSamples);
+                else if (isInt16 && isFiltered)
+                    numChannelPixels += reduceRun<int16_t, true>(begin, end, int16Rows.data() + begin, first, runSamples);
+                else if (isInt16)
+                    numChannelPixels += reduceRun<int16_t, false>(begin, end, int16Rows.data() + begin, first, runSamples);
+                else if (isFiltered)
+                    numChannelPixels += reduceRun<float, true>(begin, end, floatRows.data() + begin, first, runSamples);
+                else
+                    numChannelPixels += reduceRun<float, false>(begin, end, floatRows.data() + begin, first, runSamples);
+            }
+        }
+
+        return numChannelPixels;
+    }
+
+    float getChecksum() const { return checksum; }
+
+private:
+    template <typename SampleType, bool isFilteredRun>
+    long long reduceRun(int begin, int end, const SampleType* const* rows, int first, int runSamples)
+    {
+        const int numGroupChannels = end - begin;
+        const int tileSize = isFilteredRun ? BiquadFilterBank::maxTileSamples : runSamples;
+        const PixelAccumulator& phase = accumulators[begin];
+        const SampleType* tileInputs[BiquadFilterBank::numLanes];
+        long long numChannelPixels = 0;
+
+        for (int start = 0; start < runSamples; start += tileSize)
+        {
+            const int tileSamples = std::min(tileSize, runSamples - start);
+
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+                tileInputs[lane] = rows[lane] + first + start;
+
+            if constexpr (isFilteredRun)
+                filterBank.process(begin, numGroupChannels, tileInputs, scales, tileSamples, lanes.data(), filteredRows);
+
+            for (int pos = 0; pos < tileSamples;)
+            {
+                const int segmentSize = std::min(tileSamples - pos, phase.getNumSamplesToRunEnd());
+
+                for (int lane = 0; lane < numGroupChannels; ++lane)
+                {
+                    CrossingState& crossing = detectors[begin + lane].getCrossingState();
+
+                    if constexpr (isFilteredRun)
+                        accumulators[begin + lane].add(kernels, crossing, filteredRows[lane] + pos, segmentSize);
+                    else
+                        accumulate(accumulators[begin + lane], crossing, tileInputs[lane] + pos, segmentSize, scales[lane]);
+                }
+
+                pos += segmentSize;
+                numChannelPixels += completeRun(begin, end);
+            }
+        }
+
+        return numChannelPixels;
+    }
+
+    long long reduceRunGeneric(int begin, int end, int first, int runSamples)
+    {
+        const int numGroupChannels = end - begin;
+        const int tileSize = isFiltered ? BiquadFilterBank::maxTileSamples : runSamples;
+        const PixelAccumulator& phase = accumulators[begin];
+        const float* floatInputs[BiquadFilterBank::numLanes];
+        const int16_t* int16Inputs[BiquadFilterBank::numLanes];
+        long long numChannelPixels = 0;
+
+        for (int start = 0; start < runSamples; start += tileSize)
+        {
+            const int tileSamples = std::min(tileSize, runSamples - start);
+
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+            {
+                if (isInt16)
+                    int16Inputs[lane] = int16Rows[begin + lane] + first + start;
+                else
+                    floatInputs[lane] = floatRows[begin + lane] + first + start;
+            }
+
+            if (isFiltered && isInt16)
+                filterBank.process(begin, numGroupChannels, int16Inputs, scales, tileSamples, lanes.data(), filteredRows);
+            else if (isFiltered)
+                filterBank.process(begin, numGroupChannels, floatInputs, scales, tileSamples, lanes.data(), filteredRows);
+
+            for (int pos = 0; pos < tileSamples;)
+            {
+                const int segmentSize = std::min(tileSamples - pos, phase.getNumSamplesToRunEnd());
+
+                for (int lane = 0; lane < numGroupChannels; ++lane)
+                {
+                    PixelAccumulator& accumulator = accumulators[begin + lane];
+                    CrossingState& crossing = detectors[begin + lane].getCrossingState();
+
+                    if (isFiltered)
+                        accumulator.add(kernels, crossing, filteredRows[lane] + pos, segmentSize);
+                    else if (isInt16)
+                        accumulator.add(kernels, crossing, int16Inputs[lane] + pos, segmentSize, scales[lane]);
+                    else
+                        accumulator.add(kernels, crossing, floatInputs[lane] + pos, segmentSize);
+                }
+
+                pos += segmentSize;
+                numChannelPixels += completeRun(begin, end);
+            }
+        }
+
+        return numChannelPixels;
+    }
+
+    void accumulate(PixelAccumulator& accumulator, CrossingState& crossing, const float* samples, int count, float /*scale*/)
+    {
+        accumulator.add(kernels, crossing, samples, count);
+    }
+
+    void accumulate(PixelAccumulator& accumulator, CrossingState& crossing, const int16_t* samples, int count, float scale)
+    {
+        accumulator.add(kernels, crossing, samples, count, scale);
+    }
+
+    /** Complete the segment and pixel of the group if the run reached their end; returns the channel pixels completed */
+    long long completeRun(int begin, int end)
+    {
+        const PixelAccumulator& phase = accumulators[begin];
+
+        if (phase.isSegmentComplete())
+        {
+            for (int channel = begin; channel < end; ++channel)
+            {
+                detectors[channel].update(accumulators[channel].getSegmentStats(), spikeThresholdFactor);
+                accumulators[channel].startNextSegment();
+            }
+        }
+
+        if (!phase.isPixelComplete())
+            return 0;
+
+        for (int channel = begin; channel < end; ++channel)
+        {
+            checksum += accumulators[channel].getStats().max;
+            accumulators[channel].startNextPixel();
+        }
+
+        return end - begin;
+    }
+
+    const bool isInt16;
+    const bool isFiltered;
+    const int numSamples;
+    const PixelKernels& kernels;
+
+    std::vector<int16_t> int16Samples;
+    std::vector<const float*> floatRows;
+    std::vector<const int16_t*> int16Rows;
+
+    std::vector<PixelAccumulator> accumulators;
+    std::vector<SpikeDetector> detectors;
+
+    BiquadFilterBank filterBank;
+    std::vector<float> lanes;
+    std::vector<float> filtered;
+    float* filteredRows[BiquadFilterBank::numLanes];
+    float scales[BiquadFilterBank::numLanes];
+
+    float checksum = 0.0f;
+};
+
+Result benchmarkReduction(int numSeconds, const SyntheticProbe& probe, SampleStorage storage, FilterBand band, bool isSpecialized)
+{
+    ReductionBenchmark benchmark(probe, storage, band);
+
+    Result result = measure(numSeconds, probe, [&]() -> long long
+    {
+        return benchmark.processSecond(isSpecialized);
+    });
+
+    // keeps the reduction from being optimised away
+    if (benchmark.getChecksum() < -1.0e30f)
+        std::printf("%f\n", benchmark.getChecksum());
+
+    return result;
+}
+
+#pragma mark - Band power FFT stages -
+
+/** The first sample of the FFT window ending at a pixel, within the probe */
+int getFFTWindowStart(const SyntheticProbe& probe, int pixel, int fftSize)
+{
+    return std::max(0, std::min((pixel + 1) * samplesPerPixel, probe.getNumSamples()) - fftSize);
+}
+
+/**
+ *  The band power FFTs as the canvas took them before BatchedFFT: one
+ *  kiss_fftr per channel for every pixel, its input windowed element by
+ *  element. On one thread, so the realtime factor is how many such probes
+ *  a core could keep up with.
+ */
+Result benchmarkKissFFT(int numSeconds, const SyntheticProbe& probe, int fftSize)
+{
+    kiss_fftr_cfg config = kiss_fftr_alloc(fftSize, 0, nullptr, nullptr);
+    std::vector<float> window(fftSize);
+    std::vector<float> input(fftSize);
+    std::vector<kiss_fft_cpx> output(fftSize / 2 + 1);
+
+    for (int i = 0; i < fftSize; ++i)
+        window[i] = 0.5f * (1.0f - std::cos(6.283185307f * i / (fftSize - 1)));
+
+    float checksum = 0.0f;
+
+    Result result = measure(numSeconds, probe, [&]() -> long long
+    {
+        for (int pixel = 0; pixel < pixelsPerSecond; ++pixel)
+        {
+            const int first = getFFTWindowStart(probe, pixel, fftSize);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const float* samples = probe.getRow(channel) + first;
+
+                for (int i = 0; i < fftSize; ++i)
+                    input[i] = window[i] * samples[i];
+
+                kiss_fftr(config, input.data(), output.data());
+
+                const kiss_fft_cpx& value = output[fftBin];
+                checksum += value.r * value.r + value.i * value.i;
+            }
+        }
+
+        return (long long) pixelsPerSecond * numChannels;
+    });
+
+    std::free(config);
+
+    // keeps the transforms from being optimised away
+    if (checksum < 0.0f)
+        std::printf("%f\n", checksum);
+
+    return result;
+}
+
+/**
+ *  The same transforms through a BatchedFFT, BatchedFFT::numLanes
+ *  channels per call, on one thread as well
+ */
+Result benchmarkBatchedFFT(int numSeconds, const SyntheticProbe& probe, int fftSize)
+{
+    BatchedFFT fft;
+    fft.prepare(fftSize);
+
+    float checksum = 0.0f;
+
+    Result result = measure(numSeconds, probe, [&]() -> long long
+    {
+        for (int pixel = 0; pixel < pixelsPerSecond; ++pixel)
+        {
+            const int first = getFFTWindowStart(probe, pixel, fftSize);
+
+            for (int begin = 0; begin < numChannels; begin += BatchedFFT::numLanes)
+            {
+                const int numGroupChannels = std::min(BatchedFFT::numLanes, numChannels - begin);
+                float* input = fft.getInput();
+
+                for (int lane = 0; lane < numGroupChannels; ++lane)
+                {
+                    const float* samples = probe.getRow(begin + lane) + first;
+
+                    for (int i = 0; i < fftSize; ++i)
+                        input[i * BatchedFFT::numLanes + lane] = samples[i];
+                }
+
+                checksum += fft.computePowerSpectrum()[fftBin * BatchedFFT::numLanes];
+            }
+        }
+
+        return (long long) pixelsPerSecond * numChannels;
+    });
+
+    // keeps the transforms from being optimised away
+    if (checksum < 0.0f)
+        std::printf("%f\n", checksum);
+
+    return result;
+}
+
+#pragma mark - Renderer stages -
+
+/**
+ *  Map a second of pixels of every channel to a scheme's colours, as
+ *  ProbeChannelDisplay does through ColourScheme before painting them
+ */
+Result benchmarkColourMap(int numSeconds, const SyntheticProbe& probe, ColourSchemeId scheme)
+{
+    // normalized values spread a little past both bounds, as the display clips them
+    std::vector<float> values(size_t(numChannels) * pixelsPerSecond);
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> uniform(-0.1f, 1.1f);
+
+    for (float& value : values)
+        value = uniform(random);
+
+    float checksum = 0.0f;
+
+    Result result = measure(numSeconds, probe, [&]() -> long long
+    {
+        for (float value : values)
+            checksum += ColourMap::getEntryForNormalizedValue(value, scheme).green;
+
+        return (long long) values.size();
+    });
+
+    // keeps the lookups from being optimised away
+    if (checksum < 0.0f)
+        std::printf("%f\n", checksum);
+
+    return result;
+}
+
+#pragma mark - Band power check -
+
+/**
+ *  Slide one channel of noise and a sine through a SlidingDFTBank and
+ *  compare its band power in dB with kiss_fftr over the same window, for
+ *  every bin in turn (switching bins the way the canvas does, by resyncing
+ *  from the ring) and again after fftSize * 40000 samples, about three
+ *  hours at 1 kHz. Returns the largest difference in dB.
+ */
+double checkSlidingBandPower()
+{
+    const int fftSize = defaultFFTSize;
+    std::mt19937 random(7);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    long long sampleIndex = 0;
+
+    auto nextSample = [&]() -> float
+    {
+        return 10.0f * float(std::sin(0.3 * double(sampleIndex++))) + noise(random);
+    };
+
+    std::vector<float> ring(fftSize, 0.0f);
+    int writeIndex = 0;
+
+    SlidingDFTBank sliding;
+    sliding.prepare(1, fftSize, 0);
+
+    auto push = [&](float sample)
+    {
+        sliding.push(0, sample, ring[(writeIndex + 1) % fftSize]);
+        ring[writeIndex] = sample;
+        writeIndex = (writeIndex + 1) % fftSize;
+    };
+
+    kiss_fftr_cfg config = kiss_fftr_alloc(fftSize, 0, nullptr, nullptr);
+    std::vector<float> input(fftSize);
+    std::vector<kiss_fft_cpx> output(fftSize / 2 + 1);
+
+    auto getError = [&](int bin) -> double
+    {
+        for (int i = 0; i < fftSize; ++i)
+            input[i] = 0.5f * (1.0f - std::cos(6.283185307f * i / (fftSize - 1))) * ring[(writeIndex + 1 + i) % fftSize];
+
+        kiss_fftr(config, input.data(), output.data());
+
+        const double kissPower = double(output[bin].r) * output[bin].r + double(output[bin].i) * output[bin].i;
+        return std::abs(10.0 * std::log10(sliding.getPower(0) / kissPower));
+    };
+
+    double maxError = 0.0;
+
+    for (int i = 0; i < fftSize; ++i)
+        push(nextSample());
+
+    for (int bin = 0; bin <= fftSize / 2; ++bin)
+    {
+        std::vector<float> window(fftSize);
+
+        for (int i = 0; i < fftSize; ++i)
+            window[i] = ring[(writeIndex + 1 + i) % fftSize];
+
+        sliding.setBin(bin);
+        sliding.resync(0, window.data());
+
+        for (int i = 0; i < 2 * fftSize; ++i)
+        {
+            push(nextSample());
+            maxError = std::max(maxError, getError(bin));
+        }
+    }
+
+    for (long long i = 0; i < fftSize * 40000LL; ++i)
+        push(nextSample());
+
+    for (int i = 0; i < fftSize; ++i)
+    {
+        push(nextSample());
+        maxError = std::max(maxError, getError(fftSize / 2));
+    }
+
+    std::free(config);
+
+    return maxError;
+}
+
+#pragma mark - Decimator check -
+
+/**
+ *  Decimate a sine to spectralSampleRate from inputRate, in odd-sized
+ *  blocks, and return its RMS at the output in dB relative to the input,
+ *  after the filters have settled
+ */
+double getDecimatorGain(double inputRate, double frequency)
+{
+    SpectralDecimator decimator;
+    decimator.prepare(1, inputRate, spectralSampleRate);
+
+    const int blockSize = 237;
+    const int numInputs = int(inputRate) * 4;
+    std::vector<float> block(blockSize);
+    std::vector<float> scratch(decimator.getScratchSize());
+    std::vector<float> output(size_t(decimator.getMaxNumOutputs(blockSize)) * SpectralDecimator::numLanes);
+    const float* inputs[1] = { block.data() };
+    const float scales[1] = { 1.0f };
+
+    double sumSquares = 0.0;
+    long long numOutputs = 0;
+
+    for (int first = 0; first < numInputs; first += blockSize)
+    {
+        for (int i = 0; i < blockSize; ++i)
+            block[i] = float(std::sin(6.283185307179586 * frequency * (first + i) / inputRate));
+
+        const int numDecimated = decimator.process(0, 1, inputs, scales, blockSize, scratch.data(), output.data());
+
+        // skip the first second, while the filters fill
+        if (first < int(inputRate))
+            continue;
+
+        for (int i = 0; i < numDecimated; ++i)
+            sumSquares += double(output[i * SpectralDecimator::numLanes]) * output[i * SpectralDecimator::numLanes];
+
+        numOutputs += numDecimated;
+    }
+
+    return 10.0 * std::log10(std::max(1.0e-30, sumSquares / std::max(1LL, numOutputs) / 0.5));
+}
+
+/**
+ *  The rejection in dB of the tone that would alias worst into the band
+ *  power bins, for the stream rates the plugin sees: one a little under
+ *  the input Nyquist frequency and one just above the output Nyquist
+ *  frequency. Returns the smallest, and the largest passband error.
+ */
+void checkSpectralDecimator(double& minRejection, double& maxPassbandError)
+{
+    const double inputRates[] = { 30000.0, 2500.0 };
+
+    minRejection = 1000.0;
+    maxPassbandError = 0.0;
+
+    for (double inputRate : inputRates)
+    {
+        const double stopband = spectralSampleRate * (1.0 - SpectralDecimator::passbandRatio);
+        const double tones[] = { inputRate / 2.0 - 300.0, stopband + 10.0, spectralSampleRate - 100.0 };
+
+        for (double tone : tones)
+            minRejection = std::min(minRejection, -getDecimatorGain(inputRate, tone));
+
+        maxPassbandError = std::max(maxPassbandError, std::abs(getDecimatorGain(inputRate, 100.0)));
+        maxPassbandError = std::max(maxPassbandError, std::abs(getDecimatorGain(inputRate, spectralSampleRate * SpectralDecimator::passbandRatio)));
+    }
+}
+
+/**
+ *  Pass a ramp through a decimator prepared for each input rate, in
+ *  random-sized blocks. Rates up to spectralSampleRate must come out
+ *  sample for sample, times the scale, where the canvas once kept every
+ *  other sample whatever the rate. Rates above it must come out at about
+ *  spectralSampleRate. Returns false if any does not.
+ */
+bool checkDecimatorRates()
+{
+    const double inputRates[] = { 250.0, 500.0, 1000.0, 1500.0, 2000.0 };
+    const int numInputSamples = 20000;
+    const int maxBlockSamples = 700;
+    const float scale = 0.5f;
+
+    std::mt19937 random(13);
+    std::uniform_int_distribution<int> blockSizes(1, maxBlockSamples);
+
+    // exact in float, before and after scaling
+    std::vector<float> ramp(numInputSamples);
+
+    for (int i = 0; i < numInputSamples; ++i)
+        ramp[i] = float(i % 4096);
+
+    for (double inputRate : inputRates)
+    {
+        SpectralDecimator decimator;
+        decimator.prepare(1, inputRate, spectralSampleRate);
+
+        const bool isPassedThrough = inputRate <= spectralSampleRate;
+
+        if (decimator.isActive() == isPassedThrough)
+            return false;
+
+        std::vector<float> scratch(std::max(1, decimator.getScratchSize()));
+        std::vector<float> output(size_t(decimator.getMaxNumOutputs(maxBlockSamples)) * SpectralDecimator::numLanes);
+        long long numOutputs = 0;
+
+        for (int first = 0; first < numInputSamples;)
+        {
+            const int numSamples = std::min(blockSizes(random), numInputSamples - first);
+            const float* input = ramp.data() + first;
+            const int numWritten = decimator.process(0, 1, &input, &scale, numSamples, scratch.data(), output.data());
+
+            for (int i = 0; isPassedThrough && i < numWritten; ++i)
+            {
+                if (output[size_t(i) * SpectralDecimator::numLanes] != scale * ramp[numOutputs + i])
+                    return false;
+            }
+
+            numOutputs += numWritten;
+            first += numSamples;
+        }
+
+        if (isPassedThrough && numOutputs != numInputSamples)
+            return false;
+
+        // the filters' delay and the phase of the last output leave a sample or two either way
+        const double expectedOutputs = numInputSamples * spectralSampleRate / inputRate;
+
+        if (!isPassedThrough && std::abs(double(numOutputs) - expectedOutputs) > 2.0)
+            return false;
+    }
+
+    return true;
+}
+
+
+}
+
+#pragma mark - main -
+
+int main(int argc, char* argv[])
+{
+    const int numSeconds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    const int maxThreads = argc > 2 ? std::max(0, std::atoi(argv[2])) : 0;
+
+    const SyntheticProbe probe;
+    WorkStealingPool pool(maxThreads);
+
+    const double bandPowerError = checkSlidingBandPower();
+    std::printf("sliding DFT band power vs kiss_fftr: %.2g dB max difference\n", bandPowerError);
+
+    // kiss_fftr rounds in float, which is nearly all of the difference, at the weakest bins
+    if (!(bandPowerError < 0.01))
+        return 1;
+
+    double aliasRejection, passbandError;
+    checkSpectralDecimator(aliasRejection, passbandError);
+    std::printf("spectral decimator: %.1f dB alias rejection, %.2g dB passband error\n", aliasRejection, passbandError);
+
+    // the stages are designed for 80 dB; leave a little for the window
+    if (!(aliasRejection > 70.0 && passbandError < 0.05))
+        return 1;
+
+    const bool isRateChecked = checkDecimatorRates();
+    std::printf("spectral decimator: rates up to %.0f Hz %s\n", spectralSampleRate,
+                isRateChecked ? "passed through, higher rates resampled to it" : "not passed through or resampled as expected");
+
+    if (!isRateChecked)
+        return 1;
+
+    printHeader(getPixelKernels(), pool.getNumThreads());
+
+    printResult("reference CAR", benchmarkReference(numSeconds, probe, ReferenceMode::COMMON_AVERAGE));
+    printResult("reference median", benchmarkReference(numSeconds, probe, ReferenceMode::COMMON_MEDIAN));
+    printResult("reference local median", benchmarkReference(numSeconds, probe, ReferenceMode::LOCAL_MEDIAN));
+    printResult("ring write float32", benchmarkSampleRing(numSeconds, probe, SampleStorage::FLOAT32));
+    printResult("ring write int16", benchmarkSampleRing(numSeconds, probe, SampleStorage::INT16));
+    printResult("pixel columns", benchmarkPixelColumns(numSeconds, probe, nullptr));
+    printResult("pixel columns, analysis", benchmarkPixelColumns(numSeconds, probe, &pool));
+    printResult("spectral decimator", benchmarkSpectralDecimator(numSeconds, probe));
+    printResult("summary pyramid", benchmarkSummaryPyramid(numSeconds, probe));
+
+    printResult("pixels", benchmarkAnalysis(numSeconds, probe, pool, SampleStorage::FLOAT32, FilterBand::NONE));
+    printResult("pixels, int16", benchmarkAnalysis(numSeconds, probe, pool, SampleStorage::INT16, FilterBand::NONE));
+    printResult("pixels, AP filter", benchmarkAnalysis(numSeconds, probe, pool, SampleStorage::FLOAT32, FilterBand::AP));
+    printResult("pixels, LFP filter", benchmarkAnalysis(numSeconds, probe, pool, SampleStorage::FLOAT32, FilterBand::LFP));
+
+    // the reduction compiled for each storage and filter state, against one loop testing both at run time
+    printResult("reduction float32", benchmarkReduction(numSeconds, probe, SampleStorage::FLOAT32, FilterBand::NONE, true));
+    printResult("reduction float32, generic", benchmarkReduction(numSeconds, probe, SampleStorage::FLOAT32, FilterBand::NONE, false));
+    printResult("reduction int16", benchmarkReduction(numSeconds, probe, SampleStorage::INT16, FilterBand::NONE, true));
+    printResult("reduction int16, generic", benchmarkReduction(numSeconds, probe, SampleStorage::INT16, FilterBand::NONE, false));
+    printResult("reduction float32 AP", benchmarkReduction(numSeconds, probe, SampleStorage::FLOAT32, FilterBand::AP, true));
+    printResult("reduction float32 AP, generic", benchmarkReduction(numSeconds, probe, SampleStorage::FLOAT32, FilterBand::AP, false));
+    printResult("reduction int16 AP", benchmarkReduction(numSeconds, probe, SampleStorage::INT16, FilterBand::AP, true));
+    printResult("reduction int16 AP, generic", benchmarkReduction(numSeconds, probe, SampleStorage::INT16, FilterBand::AP, false));
+
+    // the cost of each FFT size and averaging the options bar offers, for the selected bin and every band
+    const SpectrumSettings spectra[] =
+    {
+        { 128, 1, 64 }, { 256, 1, 128 }, { 1024, 1, 512 }, { 4096, 1, 2048 },
+        { 256, 4, 128 }, { 1024, 4, 256 }, { 4096, 8, 512 }, { 4096, 16, 2048 }
+    };
+
+    for (const SpectrumSettings& spectrum : spectra)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "pixels, Welch %d x%d hop %d", spectrum.fftSize, spectrum.numSegments, spectrum.hopSize);
+
+        printResult(name, benchmarkAnalysis(numSeconds, probe, pool, SampleStorage::FLOAT32, FilterBand::NONE, spectrum));
+    }
+
+    printResult("band power FFT kiss_fftr", benchmarkKissFFT(numSeconds, probe, defaultFFTSize));
+    printResult("band power FFT batched", benchmarkBatchedFFT(numSeconds, probe, defaultFFTSize));
+
+    printResult("pixels, settings changes", benchmarkSettingsChanges(numSeconds, probe, pool));
+
+    printResult("colour map inferno", benchmarkColourMap(numSeconds, probe, ColourSchemeId::INFERNO));
+    printResult("colour map jet", benchmarkColourMap(numSeconds, probe, ColourSchemeId::JET));
+
+    if (numAllocatingStages > 0)
+    {
+        std::printf("\n%d stages allocated once warmed up\n", numAllocatingStages);
+        return 1;
+    }
+
+    return 0;
+}
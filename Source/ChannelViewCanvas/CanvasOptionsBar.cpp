@@ -11,18 +11,22 @@
 #include "ChannelViewCanvas.hpp"
 #include "../ProbeViewerCanvas.h"
 #include "../Utilities/ColourScheme.hpp"
+#include "../Processing/BiquadFilterBank.hpp"
+#include "../Processing/SpectralBands.hpp"
 
 using namespace ProbeViewer;
 
 CanvasOptionsBar::CanvasOptionsBar(class ChannelViewCanvas* channelsView)
 : channelsView(channelsView)
 , marginWidth(0)
+, fftSampleRate(0.0f)
 , labelFont("Fira Code", "Regular", 16.0f)
 , labelColour(100, 100, 100)
 {
     rmsSubOptionComponent = new RMSSubOptionComponent(labelFont, labelColour);
-    fftSubOptionComponent = new FFTSubOptionComponent(labelFont, labelColour);
+    fftSubOptionComponent = new FFTSubOptionComponent(labelFont, labelColour, this);
     spikeRateSubOptionComponent = new SpikeRateSubOptionComponent(labelFont, labelColour);
+    bandPowerSubOptionComponent = new BandPowerSubOptionComponent(labelFont, labelColour, channelsView);
     
     currentSubOptionComponent = rmsSubOptionComponent;
     addAndMakeVisible(currentSubOptionComponent);
@@ -32,7 +36,14 @@ CanvasOptionsBar::CanvasOptionsBar(class ChannelViewCanvas* channelsView)
     renderModeSelectionLabel->setColour(Label::textColourId, labelColour);
     addAndMakeVisible(renderModeSelectionLabel);
     
+    // the band modes follow, so the ids of the first three stay as saved
     StringArray renderModeNames = {"RMS Signal", "Freq. Band Power", "Spike Rate"};
+
+    for (int band = 0; band < NUM_SPECTRAL_BANDS; ++band)
+        renderModeNames.add(String(BandPowerMap::getName(SpectralBand(band))) + " Power");
+
+    renderModeNames.add("Band Composite");
+
     renderModeSelection = new ComboBox("renderModeSelection");
     renderModeSelection->addItemList(renderModeNames, 1);
     renderModeSelection->setEditableText(false);
@@ -42,6 +53,34 @@ CanvasOptionsBar::CanvasOptionsBar(class ChannelViewCanvas* channelsView)
     
     
     
+    // time window options; windows other than the default are read from the summary pyramid
+    timeWindowSelectionLabel = new Label("timeWindowSelectionLabel", "Window");
+    timeWindowSelectionLabel->setFont(labelFont);
+    timeWindowSelectionLabel->setColour(Label::textColourId, labelColour);
+    addAndMakeVisible(timeWindowSelectionLabel);
+
+    StringArray timeWindowNames = {"0.1 s", "0.25 s", "0.5 s", "1 s", "2 s", "5 s", "10 s", "30 s", "1 min", "2 min", "5 min"};
+    timeWindowSelection = new ComboBox("timeWindowSelection");
+    timeWindowSelection->addItemList(timeWindowNames, 1);
+    timeWindowSelection->setEditableText(false);
+    timeWindowSelection->addListener(this);
+    timeWindowSelection->setSelectedId(7, dontSendNotification);
+    addAndMakeVisible(timeWindowSelection);
+
+    // filter options; item ids follow FilterBand, starting at 1
+    filterSelectionLabel = new Label("filterSelectionLabel", "Filter");
+    filterSelectionLabel->setFont(labelFont);
+    filterSelectionLabel->setColour(Label::textColourId, labelColour);
+    addAndMakeVisible(filterSelectionLabel);
+
+    StringArray filterNames = {"Wide-band", "AP band", "LFP band"};
+    filterSelection = new ComboBox("filterSelection");
+    filterSelection->addItemList(filterNames, 1);
+    filterSelection->setEditableText(false);
+    filterSelection->addListener(this);
+    filterSelection->setSelectedId(1, dontSendNotification);
+    addAndMakeVisible(filterSelection);
+
     // colour scheme options
     colourSchemeSelectionLabel = new Label("colourSchemeSelectionLabel", "Colour\nScheme");
     colourSchemeSelectionLabel->setFont(labelFont);
@@ -80,11 +119,18 @@ void CanvasOptionsBar::resized()
     if (getWidth() > colourSchemeOffset) colourSchemeOffset = getWidth();
     colourSchemeSelectionLabel->setBounds(colourSchemeOffset - 170, 0, 70, getHeight());
     colourSchemeSelection->setBounds(colourSchemeSelectionLabel->getRight(), 2, 90, getHeight() - 4);
+
+    timeWindowSelectionLabel->setBounds(colourSchemeOffset - 330, 0, 65, getHeight());
+    timeWindowSelection->setBounds(timeWindowSelectionLabel->getRight(), 2, 85, getHeight() - 4);
+
+    filterSelectionLabel->setBounds(colourSchemeOffset - 490, 0, 50, getHeight());
+    filterSelection->setBounds(filterSelectionLabel->getRight(), 2, 100, getHeight() - 4);
     
-    Rectangle<int> subOptionBounds(marginWidth + 3, 0, colourSchemeOffset - marginWidth - 170 - 3, getHeight());
+    Rectangle<int> subOptionBounds(marginWidth + 3, 0, colourSchemeOffset - marginWidth - 490 - 3, getHeight());
     rmsSubOptionComponent->setBounds(subOptionBounds);
     fftSubOptionComponent->setBounds(subOptionBounds);
     spikeRateSubOptionComponent->setBounds(subOptionBounds);
+    bandPowerSubOptionComponent->setBounds(subOptionBounds);
 }
 
 void CanvasOptionsBar::comboBoxChanged(ComboBox *cb)
@@ -108,10 +154,19 @@ void CanvasOptionsBar::comboBoxChanged(ComboBox *cb)
                 break;
                 
             case 3:
-            default:
                 renderMode = RenderMode::SPIKE_RATE;
                 currentSubOptionComponent = spikeRateSubOptionComponent;
                 break;
+
+            case 4 + NUM_SPECTRAL_BANDS:
+                renderMode = RenderMode::BAND_COMPOSITE;
+                currentSubOptionComponent = bandPowerSubOptionComponent;
+                break;
+
+            default:
+                renderMode = getRenderModeForBand(SpectralBand(jlimit(0, NUM_SPECTRAL_BANDS - 1, cb->getSelectedId() - 4)));
+                currentSubOptionComponent = bandPowerSubOptionComponent;
+                break;
         }
         
         addAndMakeVisible(currentSubOptionComponent);
@@ -193,11 +248,72 @@ int CanvasOptionsBar::getFFTCenterFrequencyBin() const
     return fftSubOptionComponent->getFFTSamplingBin();
 }
 
-void CanvasOptionsBar::setFFTParams(const int numBins, const float sampleRate)
+int CanvasOptionsBar::getFFTSize() const
 {
+    return fftSubOptionComponent->getFFTSize();
+}
+
+int CanvasOptionsBar::getFFTNumSegments() const
+{
+    return fftSubOptionComponent->getNumSegments();
+}
+
+float CanvasOptionsBar::getFFTOverlap() const
+{
+    return fftSubOptionComponent->getOverlap();
+}
+
+void CanvasOptionsBar::setFFTSampleRate(const float sampleRate)
+{
+    fftSampleRate = sampleRate;
     fftSubOptionComponent->setSampleRate(sampleRate);
-    fftSubOptionComponent->setFFTSize(numBins);
-    
+    updateBandResolution();
+}
+
+void CanvasOptionsBar::updateBandResolution()
+{
+    if (fftSampleRate <= 0.0f)
+        return;
+
+    BandPowerMap bandMap;
+    bandMap.prepare(getFFTSize(), fftSampleRate);
+
+    for (int band = 0; band < NUM_SPECTRAL_BANDS; ++band)
+    {
+        const bool isResolved = bandMap.isResolved(SpectralBand(band));
+        const int minFFTSize = BandPowerMap::getMinFFTSize(SpectralBand(band), fftSampleRate);
+
+        // a band mode already selected stays selected, showing no values
+        String name = String(BandPowerMap::getName(SpectralBand(band))) + " Power";
+
+        if (!isResolved)
+            name << " (" << minFFTSize << "+ FFT)";
+
+        renderModeSelection->changeItemText(4 + band, name);
+        renderModeSelection->setItemEnabled(4 + band, isResolved);
+
+        bandPowerSubOptionComponent->setBandResolved(SpectralBand(band), isResolved, minFFTSize);
+    }
+}
+
+float CanvasOptionsBar::getBandPowerLowBound() const
+{
+    return bandPowerSubOptionComponent->getBandPowerLowBound();
+}
+
+float CanvasOptionsBar::getBandPowerHiBound() const
+{
+    return bandPowerSubOptionComponent->getBandPowerHiBound();
+}
+
+float CanvasOptionsBar::getBandPowerBoundSpread() const
+{
+    return bandPowerSubOptionComponent->getBandPowerBoundSpread();
+}
+
+SpectralBand CanvasOptionsBar::getCompositeBand(int colourIndex) const
+{
+    return bandPowerSubOptionComponent->getCompositeBand(colourIndex);
 }
 
 float CanvasOptionsBar::getSpikeRateLowBound() const
@@ -220,6 +336,18 @@ float CanvasOptionsBar::getSpikeRateThreshold() const
     return spikeRateSubOptionComponent->getSpikeRateThreshold();
 }
 
+float CanvasOptionsBar::getTimeWindow() const
+{
+    static const float timeWindows[] = {0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 5.0f, 10.0f, 30.0f, 60.0f, 120.0f, 300.0f};
+
+    return timeWindows[jlimit(1, 11, timeWindowSelection->getSelectedId()) - 1];
+}
+
+FilterBand CanvasOptionsBar::getFilterBand() const
+{
+    return FilterBand(jlimit(1, 3, filterSelection->getSelectedId()) - 1);
+}
+
 void CanvasOptionsBar::saveParameters(XmlElement* xml)
 {
     XmlElement* xmlNode = xml->createNewChildElement("OPTIONS");
@@ -232,12 +360,23 @@ void CanvasOptionsBar::saveParameters(XmlElement* xml)
     xmlNode->setAttribute("fftLow", getFFTLowBound());
     xmlNode->setAttribute("fftHi", getFFTHiBound());
     xmlNode->setAttribute("fftFreqBin", fftSubOptionComponent->getFFTFrequency());
+    xmlNode->setAttribute("fftSize", fftSubOptionComponent->getFFTSizeId());
+    xmlNode->setAttribute("fftSegments", fftSubOptionComponent->getNumSegmentsId());
+    xmlNode->setAttribute("fftOverlap", fftSubOptionComponent->getOverlapId());
+
+    xmlNode->setAttribute("bandLow", getBandPowerLowBound());
+    xmlNode->setAttribute("bandHi", getBandPowerHiBound());
+    xmlNode->setAttribute("compositeRed", bandPowerSubOptionComponent->getCompositeBandId(0));
+    xmlNode->setAttribute("compositeGreen", bandPowerSubOptionComponent->getCompositeBandId(1));
+    xmlNode->setAttribute("compositeBlue", bandPowerSubOptionComponent->getCompositeBandId(2));
 
     xmlNode->setAttribute("spikeLow", getSpikeRateLowBound());
     xmlNode->setAttribute("spikeHi", getSpikeRateHiBound());
-    xmlNode->setAttribute("spikeThreshold", getSpikeRateThreshold());
+    xmlNode->setAttribute("spikeThresholdSD", getSpikeRateThreshold());
 
     xmlNode->setAttribute("colourScheme", colourSchemeSelection->getSelectedId());
+    xmlNode->setAttribute("timeWindow", timeWindowSelection->getSelectedId());
+    xmlNode->setAttribute("filterBand", filterSelection->getSelectedId());
 }
 
 void CanvasOptionsBar::loadParameters(XmlElement* xml)
@@ -255,11 +394,23 @@ void CanvasOptionsBar::loadParameters(XmlElement* xml)
             xmlNode->getStringAttribute("fftHi", String()),
             xmlNode->getStringAttribute("fftFreqBin", String()));
 
+        fftSubOptionComponent->setWelchParams(xmlNode->getIntAttribute("fftSize", 0),
+            xmlNode->getIntAttribute("fftSegments", 0),
+            xmlNode->getIntAttribute("fftOverlap", 0));
+
+        bandPowerSubOptionComponent->setBandPowerParams(xmlNode->getStringAttribute("bandLow", String()),
+            xmlNode->getStringAttribute("bandHi", String()),
+            xmlNode->getIntAttribute("compositeRed", 0),
+            xmlNode->getIntAttribute("compositeGreen", 0),
+            xmlNode->getIntAttribute("compositeBlue", 0));
+
         spikeRateSubOptionComponent->setSpikeRateParams(xmlNode->getStringAttribute("spikeLow", String()),
             xmlNode->getStringAttribute("spikeHi", String()),
-            xmlNode->getStringAttribute("spikeThreshold", String()));
+            xmlNode->getStringAttribute("spikeThresholdSD", String()));
 
         colourSchemeSelection->setSelectedId(xmlNode->getIntAttribute("colourScheme", 1));
+        timeWindowSelection->setSelectedId(xmlNode->getIntAttribute("timeWindow", 7));
+        filterSelection->setSelectedId(xmlNode->getIntAttribute("filterBand", 1));
     }
 }
 
@@ -417,8 +568,9 @@ void RMSSubOptionComponent::setRMSBounds(String low, String high)
 
 #pragma mark - FFTSubOptionComponent -
 
-FFTSubOptionComponent::FFTSubOptionComponent(Font labelFont, Colour labelColour)
-: labelFont(labelFont)
+FFTSubOptionComponent::FFTSubOptionComponent(Font labelFont, Colour labelColour, CanvasOptionsBar* optionsBar)
+: optionsBar(optionsBar)
+, labelFont(labelFont)
 , labelColour(labelColour)
 , binSelectionValue(0)
 , maxFreq(44100.0f / 2.0f)
@@ -474,7 +626,48 @@ FFTSubOptionComponent::FFTSubOptionComponent(Font labelFont, Colour labelColour)
     binSelection->addListener(this);
     binSelection->setSelectedId(binSelectionValue + 1, dontSendNotification);
     addAndMakeVisible(binSelection);
-    
+
+    // FFT size, shared with the band power modes
+    sizeSelectionLabel = new Label("sizeSelectionLabel", "Size:");
+    sizeSelectionLabel->setFont(labelFont);
+    sizeSelectionLabel->setColour(Label::textColourId, labelColour);
+    addAndMakeVisible(sizeSelectionLabel);
+
+    sizeSelectionOptions.addArray({"128", "256", "512", "1024", "2048", "4096"});
+    sizeSelection = new ComboBox("sizeSelection");
+    sizeSelection->addItemList(sizeSelectionOptions, 1);
+    sizeSelection->setEditableText(false);
+    sizeSelection->addListener(this);
+    sizeSelection->setSelectedId(2, dontSendNotification);
+    addAndMakeVisible(sizeSelection);
+
+    // segments averaged by Welch's method
+    segmentsSelectionLabel = new Label("segmentsSelectionLabel", "Averages:");
+    segmentsSelectionLabel->setFont(labelFont);
+    segmentsSelectionLabel->setColour(Label::textColourId, labelColour);
+    addAndMakeVisible(segmentsSelectionLabel);
+
+    segmentsSelectionOptions.addArray({"1", "2", "4", "8", "16"});
+    segmentsSelection = new ComboBox("segmentsSelection");
+    segmentsSelection->addItemList(segmentsSelectionOptions, 1);
+    segmentsSelection->setEditableText(false);
+    segmentsSelection->addListener(this);
+    segmentsSelection->setSelectedId(1, dontSendNotification);
+    addAndMakeVisible(segmentsSelection);
+
+    // overlap of consecutive segments
+    overlapSelectionLabel = new Label("overlapSelectionLabel", "Overlap:");
+    overlapSelectionLabel->setFont(labelFont);
+    overlapSelectionLabel->setColour(Label::textColourId, labelColour);
+    addAndMakeVisible(overlapSelectionLabel);
+
+    overlapSelectionOptions.addArray({"0%", "50%", "75%", "87.5%"});
+    overlapSelection = new ComboBox("overlapSelection");
+    overlapSelection->addItemList(overlapSelectionOptions, 1);
+    overlapSelection->setEditableText(false);
+    overlapSelection->addListener(this);
+    overlapSelection->setSelectedId(3, dontSendNotification);
+    addAndMakeVisible(overlapSelection);
 }
 
 FFTSubOptionComponent::~FFTSubOptionComponent()
@@ -497,6 +690,15 @@ void FFTSubOptionComponent::resized()
 
     binSelectionLabel->setBounds(hiValueBoundSelection->getRight() + 10, 0, 130, getHeight());
     binSelection->setBounds(binSelectionLabel->getRight(), 2, 80, getHeight() - 4);
+
+    sizeSelectionLabel->setBounds(binSelection->getRight() + 10, 0, 45, getHeight());
+    sizeSelection->setBounds(sizeSelectionLabel->getRight(), 2, 70, getHeight() - 4);
+
+    segmentsSelectionLabel->setBounds(sizeSelection->getRight() + 10, 0, 80, getHeight());
+    segmentsSelection->setBounds(segmentsSelectionLabel->getRight(), 2, 55, getHeight() - 4);
+
+    overlapSelectionLabel->setBounds(segmentsSelection->getRight() + 10, 0, 70, getHeight());
+    overlapSelection->setBounds(overlapSelectionLabel->getRight(), 2, 75, getHeight() - 4);
 }
 
 namespace {
@@ -551,23 +753,27 @@ void FFTSubOptionComponent::comboBoxChanged(ComboBox* cb)
         }
         return;
     }
-    if (cb == binSelection)
+    if (cb == binSelection || cb == sizeSelection)
     {
-        binSelectionValue = freqToBinIndex(cb->getText().getFloatValue(), maxFreq, fftSize/2);
+        updateSamplingBin();
+
+        if (cb == sizeSelection)
+            optionsBar->updateBandResolution();
+
         return;
     }
 }
 
-void FFTSubOptionComponent::setSampleRate(const float sampleRate)
+void FFTSubOptionComponent::updateSamplingBin()
 {
-    this->sampleRate = sampleRate;
-    maxFreq = sampleRate / 2.0f;
+    binSelectionValue = jmin(freqToBinIndex(binSelection->getText().getFloatValue(), maxFreq, getFFTSize() / 2), getFFTSize() / 2);
 }
 
-void FFTSubOptionComponent::setFFTSize(const int numBins_)
+void FFTSubOptionComponent::setSampleRate(const float sampleRate)
 {
-    fftSize = numBins_;
-    this->numBins = numBins_ / 2 + 1;
+    this->sampleRate = sampleRate;
+    maxFreq = sampleRate / 2.0f;
+    updateSamplingBin();
 }
 
 float FFTSubOptionComponent::getFFTLowBound() const
@@ -595,6 +801,50 @@ int FFTSubOptionComponent::getFFTFrequency() const
     return binSelection->getText().getIntValue();
 }
 
+int FFTSubOptionComponent::getFFTSize() const
+{
+    return 64 << getFFTSizeId();
+}
+
+int FFTSubOptionComponent::getNumSegments() const
+{
+    return 1 << (getNumSegmentsId() - 1);
+}
+
+float FFTSubOptionComponent::getOverlap() const
+{
+    static const float overlaps[] = {0.0f, 0.5f, 0.75f, 0.875f};
+
+    return overlaps[getOverlapId() - 1];
+}
+
+int FFTSubOptionComponent::getFFTSizeId() const
+{
+    return jlimit(1, 6, sizeSelection->getSelectedId());
+}
+
+int FFTSubOptionComponent::getNumSegmentsId() const
+{
+    return jlimit(1, 5, segmentsSelection->getSelectedId());
+}
+
+int FFTSubOptionComponent::getOverlapId() const
+{
+    return jlimit(1, 4, overlapSelection->getSelectedId());
+}
+
+void FFTSubOptionComponent::setWelchParams(int sizeId, int segmentsId, int overlapId)
+{
+    if (sizeId > 0)
+        sizeSelection->setSelectedId(sizeId, sendNotification);
+
+    if (segmentsId > 0)
+        segmentsSelection->setSelectedId(segmentsId, sendNotification);
+
+    if (overlapId > 0)
+        overlapSelection->setSelectedId(overlapId, sendNotification);
+}
+
 void FFTSubOptionComponent::setFFTParams(String low, String high, String bin)
 {
     if(low.isNotEmpty())
@@ -611,6 +861,181 @@ void FFTSubOptionComponent::setFFTParams(String low, String high, String bin)
 
 
 
+#pragma mark - BandPowerSubOptionComponent -
+
+BandPowerSubOptionComponent::BandPowerSubOptionComponent(Font labelFont, Colour labelColour, ChannelViewCanvas* channelsView)
+: channelsView(channelsView)
+, labelFont(labelFont)
+, labelColour(labelColour)
+, lowValueBound(-100)
+, hiValueBound(0)
+{
+    // low value plotting threshold, on the scale of the FFT bounds
+    lowValueBoundLabel = new Label("lowValueBoundLabel", "Low (dB):");
+    lowValueBoundLabel->setFont(labelFont);
+    lowValueBoundLabel->setColour(Label::textColourId, labelColour);
+    addAndMakeVisible(lowValueBoundLabel);
+
+    lowValueBoundSelectionOptions.addArray({
+        "-100", "-90", "-80", "-70", "-60", "-50", "-40", "-30"
+    });
+    lowValueBoundSelection = new ComboBox("lowValueBoundSelection");
+    lowValueBoundSelection->addItemList(lowValueBoundSelectionOptions, 1);
+    lowValueBoundSelection->setEditableText(true);
+    lowValueBoundSelection->addListener(this);
+    lowValueBoundSelection->setSelectedId(1, dontSendNotification);
+    addAndMakeVisible(lowValueBoundSelection);
+
+    // hi value plotting threshold
+    hiValueBoundLabel = new Label("hiValueBoundLabel", "High (dB):");
+    hiValueBoundLabel->setFont(labelFont);
+    hiValueBoundLabel->setColour(Label::textColourId, labelColour);
+    addAndMakeVisible(hiValueBoundLabel);
+
+    hiValueBoundSelectionOptions.addArray({
+        "0", "-5", "-10", "-15", "-20"
+    });
+    hiValueBoundSelection = new ComboBox("hiValueBoundSelection");
+    hiValueBoundSelection->addItemList(hiValueBoundSelectionOptions, 1);
+    hiValueBoundSelection->setEditableText(true);
+    hiValueBoundSelection->addListener(this);
+    hiValueBoundSelection->setSelectedId(1, dontSendNotification);
+    addAndMakeVisible(hiValueBoundSelection);
+
+    // bands of the composite, theta, gamma and high gamma by default
+    StringArray bandNames;
+
+    for (int band = 0; band < NUM_SPECTRAL_BANDS; ++band)
+        bandNames.add(BandPowerMap::getName(SpectralBand(band)));
+
+    const char* colourNames[] = {"Red:", "Green:", "Blue:"};
+    const SpectralBand defaultBands[] = {SpectralBand::THETA, SpectralBand::GAMMA, SpectralBand::HIGH_GAMMA};
+
+    for (int colourIndex = 0; colourIndex < 3; ++colourIndex)
+    {
+        auto label = compositeBandLabels.add(new Label("compositeBandLabel", colourNames[colourIndex]));
+        label->setFont(labelFont);
+        label->setColour(Label::textColourId, labelColour);
+        addAndMakeVisible(label);
+
+        auto selection = compositeBandSelections.add(new ComboBox("compositeBandSelection"));
+        selection->addItemList(bandNames, 1);
+        selection->setEditableText(false);
+        selection->addListener(this);
+        selection->setSelectedId(int(defaultBands[colourIndex]) + 1, dontSendNotification);
+        addAndMakeVisible(selection);
+    }
+}
+
+BandPowerSubOptionComponent::~BandPowerSubOptionComponent()
+{ }
+
+void BandPowerSubOptionComponent::paint(Graphics& g)
+{
+    g.setColour(Colours::darkgrey);
+    g.drawRect(0, 0, getWidth(), getHeight());
+    g.drawFittedText("BAND POWER SUB OPTIONS", 0, 0, getWidth() - 5, getHeight(), Justification::centredRight, 1);
+}
+
+void BandPowerSubOptionComponent::resized()
+{
+    lowValueBoundLabel->setBounds(0, 0, 70, getHeight());
+    lowValueBoundSelection->setBounds(lowValueBoundLabel->getRight(), 2, 60, getHeight() - 4);
+
+    hiValueBoundLabel->setBounds(lowValueBoundSelection->getRight() + 10, 0, 75, getHeight());
+    hiValueBoundSelection->setBounds(hiValueBoundLabel->getRight(), 2, 60, getHeight() - 4);
+
+    int x = hiValueBoundSelection->getRight() + 10;
+
+    for (int colourIndex = 0; colourIndex < compositeBandSelections.size(); ++colourIndex)
+    {
+        compositeBandLabels[colourIndex]->setBounds(x, 0, 55, getHeight());
+        compositeBandSelections[colourIndex]->setBounds(compositeBandLabels[colourIndex]->getRight(), 2, 105, getHeight() - 4);
+        x = compositeBandSelections[colourIndex]->getRight() + 10;
+    }
+}
+
+void BandPowerSubOptionComponent::comboBoxChanged(ComboBox* cb)
+{
+    if (cb == lowValueBoundSelection || cb == hiValueBoundSelection)
+    {
+        float val = cb->getText().getFloatValue();
+
+        // if custom value
+        if (cb->getSelectedId() == 0)
+        {
+            val = -jmin(fabsf(val), 100.0f);
+            cb->setText(String(val));
+        }
+
+        (cb == lowValueBoundSelection ? lowValueBound : hiValueBound) = val;
+        return;
+    }
+
+    // the composite is recoloured from the band histories straight away
+    if (compositeBandSelections.contains(cb) && channelsView->getCurrentRenderMode() == RenderMode::BAND_COMPOSITE)
+        channelsView->setCurrentRenderMode(RenderMode::BAND_COMPOSITE);
+}
+
+float BandPowerSubOptionComponent::getBandPowerLowBound() const
+{
+    return lowValueBound;
+}
+
+float BandPowerSubOptionComponent::getBandPowerHiBound() const
+{
+    return hiValueBound;
+}
+
+float BandPowerSubOptionComponent::getBandPowerBoundSpread() const
+{
+    return fabsf(hiValueBound - lowValueBound);
+}
+
+SpectralBand BandPowerSubOptionComponent::getCompositeBand(int colourIndex) const
+{
+    return SpectralBand(jlimit(1, NUM_SPECTRAL_BANDS, getCompositeBandId(colourIndex)) - 1);
+}
+
+int BandPowerSubOptionComponent::getCompositeBandId(int colourIndex) const
+{
+    return compositeBandSelections[colourIndex]->getSelectedId();
+}
+
+void BandPowerSubOptionComponent::setBandPowerParams(String low, String high, int redId, int greenId, int blueId)
+{
+    if(low.isNotEmpty())
+        lowValueBoundSelection->setText(low, sendNotification);
+
+    if(high.isNotEmpty())
+        hiValueBoundSelection->setText(high, sendNotification);
+
+    const int ids[] = {redId, greenId, blueId};
+
+    for (int colourIndex = 0; colourIndex < 3; ++colourIndex)
+    {
+        if (ids[colourIndex] > 0)
+            compositeBandSelections[colourIndex]->setSelectedId(jlimit(1, NUM_SPECTRAL_BANDS, ids[colourIndex]), sendNotification);
+    }
+}
+
+void BandPowerSubOptionComponent::setBandResolved(SpectralBand band, bool isResolved, int minFFTSize)
+{
+    String name = BandPowerMap::getName(band);
+
+    if (!isResolved)
+        name << " (" << minFFTSize << "+ FFT)";
+
+    for (auto selection : compositeBandSelections)
+    {
+        selection->changeItemText(int(band) + 1, name);
+        selection->setItemEnabled(int(band) + 1, isResolved);
+    }
+}
+
+
+
+
 #pragma mark - SpikeRateSubOptionComponent -
 
 SpikeRateSubOptionComponent::SpikeRateSubOptionComponent(Font labelFont, Colour labelColour)
@@ -639,33 +1064,34 @@ SpikeRateSubOptionComponent::SpikeRateSubOptionComponent(Font labelFont, Colour
     hiValueBoundLabel->setColour(Label::textColourId, labelColour);
     addAndMakeVisible(hiValueBoundLabel);
     
-    hiValueBoundSelectionOptions.add("10000");
+    // spikes per second, now that each spike is counted once
+    hiValueBoundSelectionOptions.add("100");
     hiValueBoundSelection = new ComboBox("hiValueBoundSelection");
     hiValueBoundSelection->addItemList(hiValueBoundSelectionOptions, 1);
     hiValueBoundSelection->setEditableText(true);
     hiValueBoundSelection->addListener(this);
     hiValueBoundSelection->setSelectedId(1, dontSendNotification);
-    hiValueBound = 10000;
+    hiValueBound = 100;
     addAndMakeVisible(hiValueBoundSelection);
     
     
-    // spike onset threshold
-    thresholdSelectionLabel = new Label("thresholdSelectionLabel", "Spike Onset Threshold:");
+    // spike onset threshold, in noise standard deviations of each channel
+    thresholdSelectionLabel = new Label("thresholdSelectionLabel", "Spike Threshold (x SD):");
     thresholdSelectionLabel->setFont(labelFont);
     thresholdSelectionLabel->setColour(Label::textColourId, labelColour);
     addAndMakeVisible(thresholdSelectionLabel);
     
     thresholdSelectionOptions.addArray({
-        "-25", "-50",
-        "-75", "-100",
-        "-150", "-200"
+        "3", "4",
+        "4.5", "5",
+        "6"
     });
     thresholdSelection = new ComboBox("thresholdSelection");
     thresholdSelection->addItemList(thresholdSelectionOptions, 1);
     thresholdSelection->setEditableText(true);
-    thresholdSelection->setSelectedId(2, dontSendNotification);
+    thresholdSelection->setSelectedId(3, dontSendNotification);
     thresholdSelection->addListener(this);
-    threshold = -50;
+    threshold = 4.5f;
     addAndMakeVisible(thresholdSelection);
 }
 
@@ -744,10 +1170,8 @@ void SpikeRateSubOptionComponent::comboBoxChanged(ComboBox* cb)
         {
             auto val = fabsf(cb->getText().getFloatValue());
             
-            if (val < 10) val = 10;
-            else if (val > 500) val = 500;
-            
-            val *= -1;
+            if (val < 2) val = 2;
+            else if (val > 20) val = 20;
             
             threshold = val;
             
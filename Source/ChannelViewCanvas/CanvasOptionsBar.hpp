@@ -13,6 +13,9 @@
 
 namespace ProbeViewer {
 
+enum class FilterBand : int;
+enum class SpectralBand : int;
+
 class CanvasOptionsBar : public Component
     , public ComboBox::Listener
 {
@@ -68,14 +71,57 @@ public:
     int getFFTCenterFrequencyBin() const;
 
     /**
-     *  Recalculate the number of real-numbered output bins and their
-     *  frequency mappings.
+     *  Return the selected FFT size, a power of two from 128 to 4096. It
+     *  applies to the band power modes too.
+     */
+    int getFFTSize() const;
+
+    /**
+     *  Return the number of overlapping segments whose spectra are
+     *  averaged (Welch's method); 1 shows a single window
+     */
+    int getFFTNumSegments() const;
+
+    /**
+     *  Return the fraction of each segment that overlaps the next one
+     */
+    float getFFTOverlap() const;
+
+    /**
+     *  Recalculate the frequency mappings of the FFT bins.
      *
-     *  @param numBins      the number of FFT output bins
-     *  @param sampleRate   the sampleRate of the input signal (for the
-     *                      channels that are currently displayed)
+     *  @param sampleRate   the sampleRate of the input signal to the FFT
+     *                      (for the channels that are currently displayed)
+     */
+    void setFFTSampleRate(const float sampleRate);
+
+    /**
+     *  Mark and disable the band modes and composite bands the selected
+     *  FFT size does not resolve at the FFT sample rate, naming the size
+     *  each needs (see BandPowerMap)
      */
-    void setFFTParams(const int numBins, const float sampleRate);
+    void updateBandResolution();
+
+    /**
+     *  Return the band power low bound for plotter color mapping
+     */
+    float getBandPowerLowBound() const;
+
+    /**
+     *  Return the band power high bound for plotter color mapping
+     */
+    float getBandPowerHiBound() const;
+
+    /**
+     *  Return the difference between high and low bounds for band power
+     */
+    float getBandPowerBoundSpread() const;
+
+    /**
+     *  Return the band shown as red (0), green (1) or blue (2) by the band
+     *  composite
+     */
+    SpectralBand getCompositeBand(int colourIndex) const;
 
     /**
      *  Return the spike rate low bound for plotter color mapping
@@ -96,13 +142,27 @@ public:
     /**
      *  Return the currently selected spike threshold.
      *
-     *  This value describes the threshold below which a peak is
-     *  considered a spike. It is intended to be used when input
-     *  data is processed into a pixel, and describes the threshold
-     *  after adjusting samples for median offset.
+     *  This value is the number of noise standard deviations below the
+     *  median offset at which a channel's samples are considered a
+     *  spike. Each channel's noise is estimated separately while input
+     *  data is processed into pixels (see SpikeDetector).
      */
     float getSpikeRateThreshold() const;
 
+    /**
+     *  Return the selected time window in seconds. Windows other than
+     *  ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE are drawn from the
+     *  nearest power-of-two level of the summary pyramid.
+     */
+    float getTimeWindow() const;
+
+    /**
+     *  Return the band the raw samples are filtered to before their RMS
+     *  and spike rate are computed. Band power always uses the unfiltered
+     *  samples, and columns reduced on the audio thread are not filtered.
+     */
+    FilterBand getFilterBand() const;
+
     void saveParameters(XmlElement* xml);
 
     void loadParameters(XmlElement* xml);
@@ -112,12 +172,21 @@ private:
 
     float marginWidth;
 
+    /** The rate of the samples the FFT takes, or 0 before ::setFFTSampleRate */
+    float fftSampleRate;
+
     Font labelFont;
     Colour labelColour;
 
     ScopedPointer<Label> renderModeSelectionLabel;
     ScopedPointer<ComboBox> renderModeSelection;
 
+    ScopedPointer<Label> timeWindowSelectionLabel;
+    ScopedPointer<ComboBox> timeWindowSelection;
+
+    ScopedPointer<Label> filterSelectionLabel;
+    ScopedPointer<ComboBox> filterSelection;
+
     ScopedPointer<Label> colourSchemeSelectionLabel;
     ScopedPointer<ComboBox> colourSchemeSelection;
 
@@ -126,6 +195,7 @@ private:
     ScopedPointer<class RMSSubOptionComponent> rmsSubOptionComponent;
     ScopedPointer<class FFTSubOptionComponent> fftSubOptionComponent;
     ScopedPointer<class SpikeRateSubOptionComponent> spikeRateSubOptionComponent;
+    ScopedPointer<class BandPowerSubOptionComponent> bandPowerSubOptionComponent;
 };
 
 class RMSSubOptionComponent : public Component
@@ -179,7 +249,7 @@ class FFTSubOptionComponent : public Component
     , public ComboBox::Listener
 {
 public:
-    FFTSubOptionComponent(Font labelFont, Colour labelColour);
+    FFTSubOptionComponent(Font labelFont, Colour labelColour, CanvasOptionsBar* optionsBar);
     virtual ~FFTSubOptionComponent() override;
 
     void paint(Graphics& g) override;
@@ -188,7 +258,6 @@ public:
     void comboBoxChanged(ComboBox* cb) override;
 
     void setSampleRate(const float sampleRate);
-    void setFFTSize(const int numBins);
 
     /**
      *  Return the FFT low bound for plotter color mapping
@@ -215,12 +284,39 @@ public:
      */
     int getFFTFrequency() const;
 
+    /**
+     *  Return the selected FFT size
+     */
+    int getFFTSize() const;
+
+    /**
+     *  Return the number of segments averaged per estimate
+     */
+    int getNumSegments() const;
+
+    /**
+     *  Return the fraction of each segment that overlaps the next one
+     */
+    float getOverlap() const;
+
     /**
      *  Sets the FFT parameters
     */
     void setFFTParams(String low, String high, String bin);
 
+    /**
+     *  Sets the FFT size, averaging and overlap from their combo box ids;
+     *  ids of 0 are left as they are
+     */
+    void setWelchParams(int sizeId, int segmentsId, int overlapId);
+
+    int getFFTSizeId() const;
+    int getNumSegmentsId() const;
+    int getOverlapId() const;
+
 private:
+    CanvasOptionsBar* optionsBar;
+
     Font labelFont;
     Colour labelColour;
 
@@ -239,10 +335,95 @@ private:
     ScopedPointer<ComboBox> binSelection;
     int binSelectionValue;
 
+    StringArray sizeSelectionOptions;
+    ScopedPointer<Label> sizeSelectionLabel;
+    ScopedPointer<ComboBox> sizeSelection;
+
+    StringArray segmentsSelectionOptions;
+    ScopedPointer<Label> segmentsSelectionLabel;
+    ScopedPointer<ComboBox> segmentsSelection;
+
+    StringArray overlapSelectionOptions;
+    ScopedPointer<Label> overlapSelectionLabel;
+    ScopedPointer<ComboBox> overlapSelection;
+
+    /** Maps the selected center frequency onto the bins of the selected size */
+    void updateSamplingBin();
+
     float sampleRate;
     float maxFreq;
-    int fftSize;
-    int numBins;
+};
+
+class BandPowerSubOptionComponent : public Component
+    , public ComboBox::Listener
+{
+public:
+    BandPowerSubOptionComponent(Font labelFont, Colour labelColour, class ChannelViewCanvas* channelsView);
+    virtual ~BandPowerSubOptionComponent() override;
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    void comboBoxChanged(ComboBox* cb) override;
+
+    /**
+     *  Return the band power low bound for plotter color mapping
+     */
+    float getBandPowerLowBound() const;
+
+    /**
+     *  Return the band power high bound for plotter color mapping
+     */
+    float getBandPowerHiBound() const;
+
+    /**
+     *  Return the difference between high and low bounds for band power
+     */
+    float getBandPowerBoundSpread() const;
+
+    /**
+     *  Return the band shown as red (0), green (1) or blue (2) by the band
+     *  composite
+     */
+    SpectralBand getCompositeBand(int colourIndex) const;
+
+    /**
+     *  Return the combo box id of the band shown as red (0), green (1) or
+     *  blue (2) by the band composite
+     */
+    int getCompositeBandId(int colourIndex) const;
+
+    /**
+     *  Sets the band power bounds and the composite bands; empty strings
+     *  and ids of 0 are left as they are
+     */
+    void setBandPowerParams(String low, String high, int redId, int greenId, int blueId);
+
+    /**
+     *  Enable a band in the composite selections, or disable it and name
+     *  the FFT size it needs
+     */
+    void setBandResolved(SpectralBand band, bool isResolved, int minFFTSize);
+
+private:
+    class ChannelViewCanvas* channelsView;
+
+    Font labelFont;
+    Colour labelColour;
+
+    StringArray lowValueBoundSelectionOptions;
+    ScopedPointer<Label> lowValueBoundLabel;
+    ScopedPointer<ComboBox> lowValueBoundSelection;
+    float lowValueBound;
+
+    StringArray hiValueBoundSelectionOptions;
+    ScopedPointer<Label> hiValueBoundLabel;
+    ScopedPointer<ComboBox> hiValueBoundSelection;
+    float hiValueBound;
+
+    // red, green and blue of the band composite; item ids follow SpectralBand, starting at 1
+    OwnedArray<Label> compositeBandLabels;
+    OwnedArray<ComboBox> compositeBandSelections;
 };
 
 class SpikeRateSubOptionComponent : public Component
@@ -274,12 +455,8 @@ public:
     float getSpikeRateBoundSpread() const;
 
     /**
-     *  Return the currently selected spike threshold.
-     *
-     *  This value describes the threshold below which a peak is
-     *  considered a spike. It is intended to be used when input
-     *  data is processed into a pixel, and describes the threshold
-     *  after adjusting samples for median offset.
+     *  Return the currently selected spike threshold, in noise standard
+     *  deviations of each channel.
      */
     float getSpikeRateThreshold() const;
 
@@ -28,14 +28,79 @@
 #include "../Utilities/ColourScheme.hpp"
 #include "CanvasOptionsBar.hpp"
 
+#include <cmath>
+#include <limits>
+
 using namespace ProbeViewer;
 
+namespace
+{
+/**
+ *  RGB pixels in memory owned by someone else, laid out like JUCE's own
+ *  software images so they render the same way.
+ */
+class ExternalImagePixelData : public ImagePixelData
+{
+public:
+    ExternalImagePixelData(int width, int height, uint8* pixels)
+        : ImagePixelData(Image::RGB, width, height)
+        , imageData(pixels)
+        , pixelStride(3)
+        , lineStride(getLineStride(width))
+    { }
+
+    static int getLineStride(int width)
+    {
+        return (3 * jmax(1, width) + 3) & ~3;
+    }
+
+    std::unique_ptr<LowLevelGraphicsContext> createLowLevelContext() override
+    {
+        sendDataChangeMessage();
+        return std::make_unique<LowLevelGraphicsSoftwareRenderer>(Image(this));
+    }
+
+    void initialiseBitmapData(Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode mode) override
+    {
+        const size_t offset = size_t(x) * pixelStride + size_t(y) * lineStride;
+
+        bitmap.data = imageData + offset;
+        bitmap.size = size_t(height) * lineStride - offset;
+        bitmap.pixelFormat = pixelFormat;
+        bitmap.lineStride = lineStride;
+        bitmap.pixelStride = pixelStride;
+
+        if (mode != Image::BitmapData::readOnly)
+            sendDataChangeMessage();
+    }
+
+    ImagePixelData::Ptr clone() override
+    {
+        // copies get their own memory, the arena slot is only lent to the tile
+        Image copy(Image::RGB, width, height, false);
+
+        Graphics g(copy);
+        g.drawImageAt(Image(this), 0, 0);
+
+        return copy.getPixelData();
+    }
+
+    std::unique_ptr<ImageType> createType() const override
+    {
+        return std::make_unique<SoftwareImageType>();
+    }
+
+private:
+    uint8* const imageData;
+    const int pixelStride;
+    const int lineStride;
+};
+}
+
 #pragma mark - ChannelViewCanvas -
 
 ChannelViewCanvas::ChannelViewCanvas(ProbeViewerCanvas* canvas)
-: isDirty(false)
-, numPixelUpdates(0)
-, canvas(canvas)
+: canvas(canvas)
 , channelHeight(10)
 , colourSchemeId(ColourSchemeId::INFERNO)
 , screenBufferImage(Image::RGB, CHANNEL_DISPLAY_WIDTH, CHANNEL_DISPLAY_MAX_HEIGHT * 384, false)
@@ -71,23 +136,39 @@ void ChannelViewCanvas::resized()
 
 void ChannelViewCanvas::refresh()
 {
+    // the analysis thread has done all the work, only the painting is left
+    PixelColumnQueue* columnQueue = canvas->getPixelColumnQueue();
 
-    if (isDirty.get()) // isDirty is set true when a new pixel has been pushed, and false when all queued pix are drawn
+    const int numColumns = columnQueue->getNumReady();
+
+    if (numColumns == 0)
+        return;
+
+    // a column holds every mode's values for each channel, mode by mode
+    const int numQueuedChannels = columnQueue->getNumValues() / NUM_RENDER_MODES;
+    const int numPaintedChannels = jmin(jmin(channels.size(), numQueuedChannels), numChannels);
+
+    for (int column = 0; column < numColumns; ++column)
     {
-        while (numPixelUpdates > 0)
-        {            
-            // paint the pixel updates for each channel to the bitmap data
-            for (auto channel : channels)
-            {
-                channel->pxPaint();
-            }
-            --numPixelUpdates;
-            
-            tick();
+        const float* values = columnQueue->getReadableColumn(column);
+        const int xPosition = frontBufferIndex * CHANNEL_DISPLAY_TILE_WIDTH + frontBackBufferPixelOffset;
+
+        for (int mode = 0; mode < NUM_RENDER_MODES; ++mode)
+        {
+            std::copy(values + mode * numQueuedChannels,
+                      values + mode * numQueuedChannels + numPaintedChannels,
+                      getHistoryColumn(RenderMode(mode), xPosition));
         }
-        repaint();
-        isDirty.set(false);
+
+        // paint the pixel updates for each channel to the bitmap data
+        paintColumn(getFrontBufferPtr(), frontBackBufferPixelOffset, xPosition, numPaintedChannels);
+
+        tick();
     }
+
+    columnQueue->pop(numColumns);
+
+    repaint();
 }
 
 void ChannelViewCanvas::updateViewSettings()
@@ -99,6 +180,9 @@ void ChannelViewCanvas::updateViewSettings()
     frontBufferIndex = 0;
     frontBackBufferPixelOffset = 0;
 
+    // the new tiles start blank, and so does their history
+    pixelHistory.assign(size_t(NUM_RENDER_MODES) * CHANNEL_DISPLAY_WIDTH * numChannels, std::numeric_limits<float>::quiet_NaN());
+
     if (numChannels > 0)
     {
 
@@ -107,10 +191,16 @@ void ChannelViewCanvas::updateViewSettings()
         // get number of tiles that covers display width, the drawing mechanics will need
         // to be adapted for display widths other than the current fixed value of 1920 pixels wide
         int numTiles = ceil(ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH / float(ChannelViewCanvas::CHANNEL_DISPLAY_TILE_WIDTH));
-        
+
+        // the old tiles are gone, so their memory can be handed out again
+        const size_t tileBytes = BitmapRenderTile::getNumBytesRequired(CHANNEL_DISPLAY_TILE_WIDTH, CHANNEL_DISPLAY_MAX_HEIGHT * numChannels);
+        tileMemory.reserve(numTiles * MemoryArena::getPaddedSize(tileBytes));
+        tileMemory.rewind();
+
         for (int i = 0; i < numTiles; ++i)
         {
-            auto tile = new BitmapRenderTile(CHANNEL_DISPLAY_TILE_WIDTH, CHANNEL_DISPLAY_MAX_HEIGHT * numChannels, numChannels);
+            auto tile = new BitmapRenderTile(CHANNEL_DISPLAY_TILE_WIDTH, CHANNEL_DISPLAY_MAX_HEIGHT * numChannels, numChannels,
+                                             static_cast<uint8*>(tileMemory.allocate(tileBytes)));
             displayBitmapTiles.add(tile);
         }
     }
@@ -190,11 +280,6 @@ float ChannelViewCanvas::getChannelHeight()
     return channelHeight;
 }
 
-void ChannelViewCanvas::pushPixelValueForChannel(int channel, float value)
-{
-    channels[channel]->pushSample(value);
-}
-
 BitmapRenderTile* const ChannelViewCanvas::getFrontBufferPtr() const
 {
     return displayBitmapTiles[frontBufferIndex];
@@ -213,10 +298,59 @@ RenderMode ChannelViewCanvas::getCurrentRenderMode() const
 void ChannelViewCanvas::setCurrentRenderMode(RenderMode r)
 {
     renderMode = r;
+    recolourFromHistory();
     fullRedraw = true;
     repaint();
 }
 
+float* ChannelViewCanvas::getHistoryColumn(RenderMode mode, int xPosition)
+{
+    return pixelHistory.data() + (size_t(mode) * CHANNEL_DISPLAY_WIDTH + xPosition) * numChannels;
+}
+
+void ChannelViewCanvas::recolourFromHistory()
+{
+    if (pixelHistory.empty())
+        return;
+
+    const int numPaintedChannels = jmin(channels.size(), numChannels);
+
+    for (int tileIndex = 0; tileIndex < displayBitmapTiles.size(); ++tileIndex)
+    {
+        BitmapRenderTile* tile = displayBitmapTiles[tileIndex];
+
+        for (int xPix = 0; xPix < CHANNEL_DISPLAY_TILE_WIDTH; ++xPix)
+        {
+            const int xPosition = tileIndex * CHANNEL_DISPLAY_TILE_WIDTH + xPix;
+
+            if (xPosition >= CHANNEL_DISPLAY_WIDTH)
+                break;
+
+            paintColumn(tile, xPix, xPosition, numPaintedChannels);
+        }
+    }
+}
+
+void ChannelViewCanvas::paintColumn(BitmapRenderTile* tile, int xPix, int xPosition, int numPaintedChannels)
+{
+    if (renderMode == RenderMode::BAND_COMPOSITE)
+    {
+        const float* red = getHistoryColumn(getRenderModeForBand(optionsBar->getCompositeBand(0)), xPosition);
+        const float* green = getHistoryColumn(getRenderModeForBand(optionsBar->getCompositeBand(1)), xPosition);
+        const float* blue = getHistoryColumn(getRenderModeForBand(optionsBar->getCompositeBand(2)), xPosition);
+
+        for (int channel = 0; channel < numPaintedChannels; ++channel)
+            channels[channel]->pxPaintComposite(tile, xPix, red[channel], green[channel], blue[channel]);
+
+        return;
+    }
+
+    const float* values = getHistoryColumn(renderMode, xPosition);
+
+    for (int channel = 0; channel < numPaintedChannels; ++channel)
+        channels[channel]->pxPaint(tile, xPix, values[channel]);
+}
+
 ColourSchemeId ChannelViewCanvas::getCurrentColourScheme() const
 {
     return colourSchemeId;
@@ -242,12 +376,15 @@ const Colour ChannelViewCanvas::backgroundColour(0, 18, 43);
 
 # pragma mark - BitmapRenderTile -
 
-BitmapRenderTile::BitmapRenderTile(int width, int height, int numChannels)
+BitmapRenderTile::BitmapRenderTile(int width, int height, int numChannels, uint8* pixelMemory)
 : width(width)
 , height(height)
 , numChannels(numChannels)
 {
-    renderImage = Image(Image::RGB, width, height, false);
+    if (pixelMemory != nullptr)
+        renderImage = Image(new ExternalImagePixelData(width, height, pixelMemory));
+    else
+        renderImage = Image(Image::RGB, width, height, false);
     
     const int subImageHeight = height / numChannels;
     
@@ -263,6 +400,11 @@ BitmapRenderTile::BitmapRenderTile(int width, int height, int numChannels)
     
 }
 
+size_t BitmapRenderTile::getNumBytesRequired(int width, int height)
+{
+    return size_t(ExternalImagePixelData::getLineStride(width)) * height;
+}
+
 Image* const BitmapRenderTile::getTile()
 {
     return &renderImage;
@@ -294,74 +436,76 @@ ProbeChannelDisplay::ProbeChannelDisplay(ChannelViewCanvas* channelsView_,
 ProbeChannelDisplay::~ProbeChannelDisplay()
 { }
 
-void ProbeChannelDisplay::pxPaint()
+void ProbeChannelDisplay::pxPaint(BitmapRenderTile* tile, int xPix, float value)
 {
     RenderMode rm = channelsView->getCurrentRenderMode();
 
-    Image bdSubImage(channelsView->getFrontBufferPtr()->getChannelSubImage(channelID));
+    Image bdSubImage(tile->getChannelSubImage(channelID));
+
+    float lowBound;
+    float boundSpread;
 
     // render RMS
     if(rm == RenderMode::RMS)
     {
-
-        float boundSpread = optionsBar->getRMSBoundSpread();
-        if (boundSpread == 0) boundSpread = 1;
-        const auto val = (samples[samples.size() - channelsView->numPixelUpdates] - optionsBar->getRMSLowBound()) / boundSpread;
-        
-        Colour colour = ColourScheme::getColourForNormalizedValueInScheme(val, channelsView->getCurrentColourScheme());
-        
-        const int xPix = channelsView->getBufferOffsetPosition();
-
-        for (int yPix = 0; yPix < bdSubImage.getHeight(); ++yPix)
-        {
-            bdSubImage.setPixelAt(xPix, yPix, colour);
-        }
+        lowBound = optionsBar->getRMSLowBound();
+        boundSpread = optionsBar->getRMSBoundSpread();
     }
     
     // render SPIKE_RATE
     else if(rm == RenderMode::SPIKE_RATE)
     {        
-        float boundSpread = optionsBar->getSpikeRateBoundSpread();
-        if (boundSpread == 0) boundSpread = 1;
-        const auto val = (samples[samples.size() - channelsView->numPixelUpdates] - optionsBar->getSpikeRateLowBound()) / boundSpread;
-        
-        Colour colour = ColourScheme::getColourForNormalizedValueInScheme(val, channelsView->getCurrentColourScheme());
-        
-        const int xPix = channelsView->getBufferOffsetPosition();
-        for (int yPix = 0; yPix < bdSubImage.getHeight(); ++yPix)
-        {
-            bdSubImage.setPixelAt(xPix, yPix, colour);
-        }
+        lowBound = optionsBar->getSpikeRateLowBound();
+        boundSpread = optionsBar->getSpikeRateBoundSpread();
     }
     
     // render FFT
+    else if(rm == RenderMode::FFT)
+    {
+        lowBound = optionsBar->getFFTLowBound();
+        boundSpread = optionsBar->getFFTBoundSpread();
+    }
+
+    // render a band's power
     else
     {
-        float boundSpread = optionsBar->getFFTBoundSpread();
-        if (boundSpread == 0) boundSpread = 1;
-        const auto val = (samples[samples.size() - channelsView->numPixelUpdates] - optionsBar->getFFTLowBound()) / boundSpread;
-        
-        Colour colour = ColourScheme::getColourForNormalizedValueInScheme(val, channelsView->getCurrentColourScheme());
-        
-        const int xPix = channelsView->getBufferOffsetPosition();
-        for (int yPix = 0; yPix < bdSubImage.getHeight(); ++yPix)
-        {
-            bdSubImage.setPixelAt(xPix, yPix, colour);
-        }
+        lowBound = optionsBar->getBandPowerLowBound();
+        boundSpread = optionsBar->getBandPowerBoundSpread();
     }
-    
-    if (channelsView->numPixelUpdates == 1)
+
+    if (boundSpread == 0) boundSpread = 1;
+
+    // columns without a value for this mode are left blank
+    const Colour colour = std::isnan(value)
+        ? Colours::black
+        : ColourScheme::getColourForNormalizedValueInScheme((value - lowBound) / boundSpread, channelsView->getCurrentColourScheme());
+
+    for (int yPix = 0; yPix < bdSubImage.getHeight(); ++yPix)
     {
-        samples.clear();
+        bdSubImage.setPixelAt(xPix, yPix, colour);
     }
 }
 
-void ProbeChannelDisplay::pushSample(float sample)
+void ProbeChannelDisplay::pxPaintComposite(BitmapRenderTile* tile, int xPix, float red, float green, float blue)
 {
-    // If you reached this assert, some other part of this plugin or open-ephys is
-    // causing rendering delays that is causing the sample queue to backup.
-    jassert (samples.size() < 1024);
-    this->samples.add(sample);
+    Image bdSubImage(tile->getChannelSubImage(channelID));
+
+    const float lowBound = optionsBar->getBandPowerLowBound();
+    float boundSpread = optionsBar->getBandPowerBoundSpread();
+
+    if (boundSpread == 0) boundSpread = 1;
+
+    auto normalize = [&](float value)
+    {
+        return std::isnan(value) ? 0.0f : jlimit(0.0f, 1.0f, (value - lowBound) / boundSpread);
+    };
+
+    const Colour colour = Colour::fromFloatRGBA(normalize(red), normalize(green), normalize(blue), 1.0f);
+
+    for (int yPix = 0; yPix < bdSubImage.getHeight(); ++yPix)
+    {
+        bdSubImage.setPixelAt(xPix, yPix, colour);
+    }
 }
 
 int ProbeChannelDisplay::getChannelId() const
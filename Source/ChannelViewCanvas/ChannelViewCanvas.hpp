@@ -26,6 +26,11 @@
 
 #include "VisualizerWindowHeaders.h"
 
+#include "../Processing/SpectralBands.hpp"
+#include "../Utilities/MemoryArena.hpp"
+
+#include <vector>
+
 namespace ProbeViewer {
 
 enum class RenderMode : int;
@@ -42,8 +47,8 @@ public:
     void resized() override;
 
     /**
-     *  Perform the necessary work to update if new pixels are ready to be
-     *  rendered.
+     *  Paint the pixel columns the analysis thread has queued, keeping the
+     *  values of every RenderMode in the history.
      *
      *  This method is called automatically from:
      *  @see ProbeViewerCanvas::refresh
@@ -76,15 +81,6 @@ public:
      */
     float getChannelHeight();
 
-    /**
-     *  Receive and queue pixel value updates for RMS, FFT, or SpikeRate
-     *  screen image for the given channel.
-     *
-     *  This method expects the channel to refer to an index within the
-     *  data acquisition subset of channels, and does not do bound checking.
-     */
-    void pushPixelValueForChannel(int channel, float value);
-
     /**
      *  Returns a pointer the BitmapRenderTile that is currently flagged
      *  for pixel updates.
@@ -102,13 +98,16 @@ public:
 
     /**
      *  Returns a value describing which RenderMode is currently selected
-     *  display on screen (RMS, FFT, or SpikeRate).
+     *  display on screen (RMS, FFT, SpikeRate, a band's power or the band
+     *  composite).
      */
     RenderMode getCurrentRenderMode() const;
 
     /**
      *  Set the RenderMode that should be displayed on screen (FFT, RMS,
-     *  or SpikeRate).
+     *  SpikeRate, a band's power or the band composite). The whole screen
+     *  is recoloured from the history of the new mode, so this is also how
+     *  a change of composite bands is shown.
      */
     void setCurrentRenderMode(RenderMode r);
 
@@ -134,8 +133,6 @@ public:
     void updateViewSettings();
 
     OwnedArray<class ProbeChannelDisplay> channels;
-    Atomic<int> isDirty;
-    int numPixelUpdates;
 
     class CanvasOptionsBar* optionsBar;
 
@@ -159,6 +156,26 @@ private:
 
     RenderMode renderMode;
 
+    /**
+     *  The value of every screen pixel in every RenderMode, laid out as
+     *  [mode][x][channel]; NaN where nothing has been drawn yet
+     */
+    std::vector<float> pixelHistory;
+
+    float* getHistoryColumn(RenderMode mode, int xPosition);
+
+    /** Repaints every tile from the history of the current RenderMode */
+    void recolourFromHistory();
+
+    /**
+     *  Paints column xPix of a tile from the history at xPosition, for the
+     *  first numPaintedChannels channels
+     */
+    void paintColumn(BitmapRenderTile* tile, int xPix, int xPosition, int numPaintedChannels);
+
+    /** Pixels of every tile, kept across ::updateViewSettings; outlives the tiles */
+    MemoryArena tileMemory;
+
     OwnedArray<BitmapRenderTile> displayBitmapTiles;
 
     int frontBackBufferPixelOffset;
@@ -187,8 +204,17 @@ struct BitmapRenderTile
      *  The params must not be zero, as this object allocates Image memory
      *  directly from width, height, and number of channels. These values are not checked for
      *  valid input.
+     *
+     *  If pixelMemory is given, it must hold ::getNumBytesRequired bytes
+     *  and outlive the tile; the Image draws into it instead of allocating.
      */
-    BitmapRenderTile(int width, int height, int numChannels);
+    BitmapRenderTile(int width, int height, int numChannels, uint8* pixelMemory = nullptr);
+
+    /**
+     *  Return the number of bytes of pixel memory a tile of the given
+     *  dimensions needs.
+     */
+    static size_t getNumBytesRequired(int width, int height);
     ~BitmapRenderTile() = default;
 
     /**
@@ -220,9 +246,38 @@ enum class RenderMode : int
 {
     RMS,
     SPIKE_RATE,
-    FFT
+    FFT,
+
+    // the power of each SpectralBand, in its order
+    DELTA_POWER,
+    THETA_POWER,
+    ALPHA_POWER,
+    BETA_POWER,
+    GAMMA_POWER,
+    HIGH_GAMMA_POWER,
+
+    // three band powers as red, green and blue; painted from their history
+    BAND_COMPOSITE
 };
 
+/**
+ *  Number of RenderModes with values of their own; every pixel column
+ *  carries a value for each. The band composite has none.
+ */
+constexpr int NUM_RENDER_MODES = 9;
+
+/** The RenderMode showing the power of a band */
+inline RenderMode getRenderModeForBand(SpectralBand band)
+{
+    return RenderMode(int(RenderMode::DELTA_POWER) + int(band));
+}
+
+/** Whether a RenderMode shows band power, which needs the raw samples */
+inline bool isBandPowerRenderMode(RenderMode mode)
+{
+    return int(mode) >= int(RenderMode::FFT);
+}
+
 /** 
     
     Renders the data for a single channel
@@ -240,14 +295,18 @@ public:
     /** Destructor*/
     virtual ~ProbeChannelDisplay() override;
 
-	/** Paints the channel display */
-    void pxPaint();
+	/**
+	 *  Paints one value of the current RenderMode at column xPix of the
+	 *  tile; NaN paints the background
+	 */
+    void pxPaint(BitmapRenderTile* tile, int xPix, float value);
 
     /**
-     *  Accept and queue one pixel worth of updates on this channel for
-     *  RMS, FFT, or SpikeRate value.
+     *  Paints three band powers as the red, green and blue of column xPix
+     *  of the tile, each scaled by the band power bounds; NaN leaves its
+     *  component dark
      */
-    void pushSample(float sample);
+    void pxPaintComposite(BitmapRenderTile* tile, int xPix, float red, float green, float blue);
 
     /**
      *  Return the index number of this channel relative to the subset of
@@ -281,8 +340,6 @@ private:
     float sampleRate;
     int channelID;
 
-    Array<float> samples;
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeChannelDisplay);
 };
 
@@ -35,14 +35,51 @@
 #include "ChannelViewCanvas/CanvasOptionsBar.hpp"
 #include "TimeScale/ProbeViewerTimeScale.hpp"
 #include "Utilities/CircularBuffer.hpp"
+#include "Utilities/WorkStealingPool.hpp"
+#include "Utilities/PixelColumnQueue.hpp"
+
+#include <limits>
+#include <type_traits>
 
 using namespace ProbeViewer;
 
+namespace
+{
+// upper bound on the pixel columns produced per analysis pass, so a backlog
+// is handed to the renderer in pieces
+const int maxPixelColumnsPerPass = 512;
+
+// columns reduced per hold of the analysis lock, which bounds how long the
+// message thread waits for it to reconfigure
+const int maxPixelColumnsPerChunk = 32;
+
+// columns the renderer can fall behind the analysis thread by
+const int pixelColumnQueueCapacity = 2 * maxPixelColumnsPerPass;
+
+// how long the analysis thread sleeps when it finds nothing to do
+const int analysisIdleWaitMs = 5;
+
+// channels handed to a pool thread at a time: one group of the filter
+// bank, which is also small enough that threads can even out the FFT channels
+const int channelsPerTask = BiquadFilterBank::numLanes;
+
+// the analyser writes its metrics where the renderer looks up the modes
+static_assert(NUM_RENDER_MODES == NUM_PIXEL_METRICS, "every RenderMode with values needs a PixelMetric");
+static_assert(int(RenderMode::RMS) == int(PixelMetric::RMS)
+              && int(RenderMode::SPIKE_RATE) == int(PixelMetric::SPIKE_RATE)
+              && int(RenderMode::FFT) == int(PixelMetric::BIN_POWER)
+              && int(RenderMode::DELTA_POWER) == int(PixelMetric::FIRST_BAND_POWER)
+              && int(RenderMode::BAND_COMPOSITE) == NUM_PIXEL_METRICS,
+              "RenderMode and PixelMetric are in the same order");
+}
+
 #pragma mark - ProbeViewerCanvas -
 
 ProbeViewerCanvas::ProbeViewerCanvas(ProbeViewerNode *processor_)
-    : pvProcessor(processor_), fft_cfg(kiss_fftr_alloc(ProbeViewerCanvas::FFT_SIZE, false, 0, 0)), numChannels(0), numSamplesToChunk(1)
+    : pvProcessor(processor_), numChannels(0)
 {
+    analysisPool = new WorkStealingPool(pvProcessor->getMaxAnalysisThreads());
+
     dataBuffer = pvProcessor->getCircularBufferPtr();
 
     updateChannelBrowsers();
@@ -54,7 +91,7 @@ ProbeViewerCanvas::ProbeViewerCanvas(ProbeViewerNode *processor_)
 
     optionsBar = new CanvasOptionsBar(channelsView);
     addAndMakeVisible(optionsBar);
-    optionsBar->setFFTParams(ProbeViewerCanvas::FFT_SIZE, ProbeViewerCanvas::FFT_TARGET_SAMPLE_RATE);
+    optionsBar->setFFTSampleRate(ProbeViewerCanvas::FFT_TARGET_SAMPLE_RATE);
     channelsView->optionsBar = optionsBar;
 
     viewport = new ProbeViewerViewport(this, channelsView);
@@ -62,18 +99,20 @@ ProbeViewerCanvas::ProbeViewerCanvas(ProbeViewerNode *processor_)
     viewport->setScrollBarsShown(false, false);
     addAndMakeVisible(viewport);
 
-    // init the fft input/output containers
-    for (int i = 0; i < ProbeViewerCanvas::FFT_SIZE; ++i)
-    {
-        fftInput.push_back(0.0f);
-    }
-
     isUpdating = false;
+    pyramidLevel = -1;
+    drawnTimeWindow = ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE;
+    shownTimeWindow = ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE;
+
+    publishAnalysisSettings();
+
+    analysisThread = new ProbeViewerAnalysisThread(this);
 }
 
 ProbeViewerCanvas::~ProbeViewerCanvas()
 {
-    free(fft_cfg);
+    // the thread reads the state below, so it has to go first
+    analysisThread->stopThread(1000);
 }
 
 void ProbeViewerCanvas::refreshState()
@@ -84,6 +123,8 @@ void ProbeViewerCanvas::refreshState()
 
 void ProbeViewerCanvas::update()
 {
+    // keeps the analysis thread out until every channel is set up again
+    const ProbeViewerNode::ScopedAnalysisLock analysisLock(*pvProcessor);
 
     isUpdating = true;
 
@@ -94,12 +135,16 @@ void ProbeViewerCanvas::update()
 
     numChannels = jmax(pvProcessor->getNumStreamChannels(), 0);
 
+    // a pyramid level is redrawn from its history on the next refresh
+    pyramidLevel = -1;
+    drawnTimeWindow = ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE;
+
+    // columns computed for the previous layout are not drawn
+    columnQueue.prepare(NUM_RENDER_MODES * numChannels, pixelColumnQueueCapacity);
+
     channelsView->updateViewSettings();
     channelsView->channels.clear();
-    partialBufferCache.clear();
-    channelFFTSampleBuffer.clear();
-    inputDownsamplingIndex.clear();
-    
+
     for(auto browser : channelBrowsers)
     {
         if (browser->id == pvProcessor->getDisplayedStream())
@@ -125,16 +170,24 @@ void ProbeViewerCanvas::update()
                                     sampleRate);
 
         channelsView->channels.add(channelDisplay);
-        partialBufferCache.add(new Array<float>());
-
-        channelFFTSampleBuffer.add(new FFTSampleCacheBuffer(ProbeViewerCanvas::FFT_SIZE));
-        inputDownsamplingIndex.push_back(0);
     }
 
-    numSamplesToChunk = int(sampleRate / ProbeViewerCanvas::FFT_TARGET_SAMPLE_RATE);
+    // one workspace per thread that reduces channels; the default pixel is
+    // also every window's baseline segment
+    analysisPool->setMaxThreads(pvProcessor->getMaxAnalysisThreads());
+
+    const int samplesPerPixel = numChannels > 0 ? channelsView->channels[0]->getNumSamplesPerPixel() : 1;
+
+    analyser.prepare(numChannels, sampleRate, samplesPerPixel, ProbeViewerCanvas::FFT_TARGET_SAMPLE_RATE,
+                     analysisPool->getNumThreads());
 
-    optionsBar->setFFTParams(ProbeViewerCanvas::FFT_SIZE, ProbeViewerCanvas::FFT_TARGET_SAMPLE_RATE);
+    optionsBar->setFFTSampleRate(ProbeViewerCanvas::FFT_TARGET_SAMPLE_RATE);
 
+    publishAnalysisSettings();
+
+    // the spectrum is sized for the new channels here, before the analysis
+    // thread gets back in
+    updateSpectrumSettings();
 
     resized();
 
@@ -143,7 +196,16 @@ void ProbeViewerCanvas::update()
 
 void ProbeViewerCanvas::refresh()
 {
-    updateScreenBuffers();
+    publishAnalysisSettings();
+
+    // follow the window of the columns being produced
+    const float timeWindow = drawnTimeWindow;
+
+    if (timeWindow != shownTimeWindow)
+    {
+        shownTimeWindow = timeWindow;
+        timeScale->setTimeScale(timeWindow, timeWindow / 20.0f);
+    }
 
     channelsView->refresh();
 }
@@ -151,11 +213,54 @@ void ProbeViewerCanvas::refresh()
 void ProbeViewerCanvas::beginAnimation()
 {
     startCallbacks();
+    analysisThread->startThread();
 }
 
 void ProbeViewerCanvas::endAnimation()
 {
     stopCallbacks();
+    analysisThread->stopThread(1000);
+}
+
+int ProbeViewerCanvas::analyseDisplayedStream()
+{
+    int numColumns = 0;
+
+    // the lock is taken a chunk at a time and handed over as soon as the
+    // message thread asks for it, so reallocating buffers or setting the
+    // channels up again never waits for a whole pass
+    while (numColumns < maxPixelColumnsPerPass && !pvProcessor->isAnalysisLockRequested())
+    {
+        const ScopedLock analysisLock(pvProcessor->getAnalysisLock());
+        const int numChunkColumns = updateScreenBuffers(jmin(maxPixelColumnsPerChunk, maxPixelColumnsPerPass - numColumns));
+
+        if (numChunkColumns == 0)
+            break;
+
+        numColumns += numChunkColumns;
+    }
+
+    return numColumns;
+}
+
+PixelColumnQueue* ProbeViewerCanvas::getPixelColumnQueue()
+{
+    return &columnQueue;
+}
+
+void ProbeViewerCanvas::publishAnalysisSettings()
+{
+    analysisRenderMode = int(channelsView->getCurrentRenderMode());
+    analysisSpikeThresholdFactor = optionsBar->getSpikeRateThreshold();
+    analysisTimeWindow = optionsBar->getTimeWindow();
+    analysisFFTBin = optionsBar->getFFTCenterFrequencyBin();
+    analysisFFTSize = optionsBar->getFFTSize();
+    analysisFFTNumSegments = optionsBar->getFFTNumSegments();
+    analysisFFTOverlap = optionsBar->getFFTOverlap();
+    analysisFilterBand = int(optionsBar->getFilterBand());
+
+    // the threshold is also applied while reducing on the audio thread
+    pvProcessor->setSpikeThresholdFactor(analysisSpikeThresholdFactor);
 }
 
 void ProbeViewerCanvas::setRegions(uint16 streamId, Array<int>& electrodeInds, Array<String>& regionNames, Array<Colour>& regionColours)
@@ -329,256 +434,273 @@ ChannelBrowser *ProbeViewerCanvas::getChannelBrowserPtr()
     return channelBrowserMap[pvProcessor->getDisplayedStream()];
 }
 
-// TODO: (kelly) this should be implemented differently, as is it will shift the array after every pop
-float ProbeViewerCanvas::popFrontCachedSampleForChannel(int channel)
+int ProbeViewerCanvas::updateScreenBuffers(int maxColumnsToQueue)
 {
-    float val = 0;
-    if (!partialBufferCache[channel]->isEmpty())
+    if (!dataBuffer || isUpdating || numChannels == 0 || columnQueue.getNumValues() < NUM_RENDER_MODES * numChannels)
+        return 0;
+
+    // the renderer has not caught up; whatever is unread waits in the ring
+    const int maxColumns = jmin(columnQueue.getNumFree(), maxColumnsToQueue);
+
+    if (maxColumns == 0)
+        return 0;
+
+    updateSpectrumSettings();
+
+    // a stream that was reduced in the background has its columns drawn first
+    if (dataBuffer->getIngestMode() == IngestMode::PIXEL_COLUMNS
+        || dataBuffer->getPixelColumns()->isPrepared())
     {
-        val = partialBufferCache[channel]->getReference(0);
-        partialBufferCache[channel]->remove(0);
+        return updateScreenBuffersFromPixelColumns(maxColumns);
     }
-    return val;
-}
 
-void ProbeViewerCanvas::updateScreenBuffers()
-{
-    if(!dataBuffer || isUpdating)
-        return;
-    
-    if (dataBuffer->hasSamplesReadyForDrawing())
+    const float timeWindow = analysisTimeWindow;
+    const RenderMode modeId = RenderMode(analysisRenderMode.load());
+
+    // band power needs the raw samples, so it is not taken from the pyramid
+    if (timeWindow > ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE
+        && !isBandPowerRenderMode(modeId)
+        && dataBuffer->getSummaryPyramid()->isPrepared())
     {
-        ScopedLock drawLock(*dataBuffer->getMutex());
-        int numTicks = 0;
-        RenderMode modeId = channelsView->getCurrentRenderMode();
+        return updateScreenBuffersFromSummaryPyramid(timeWindow, maxColumns);
+    }
 
-        for (int channel = 0; channel < numChannels; ++channel)
-        {
-            const int numSamplesToRead = dataBuffer->getNumSamplesReadyForDrawing(channel);
-            const int numCachedSamples = getNumCachedSamples(channel);
-            const int samplesPerPixel = channelsView->channels[channel]->getNumSamplesPerPixel();
-            const int numPixelsToCreate = (numCachedSamples + numSamplesToRead) / samplesPerPixel;
+    // the raw samples were skipped while the pyramid was drawn
+    const bool wasSkipped = pyramidLevel >= 0;
 
-            if (numPixelsToCreate == 0)
-            {
-                numTicks = 0;
-                break;
-            }
-            else {
-
-                if (channel == 0)
-                    numTicks = numPixelsToCreate;
-                else
-                {
-                    if (numTicks > numPixelsToCreate)
-                        numTicks = numPixelsToCreate;
-                }
-            }
-                
-            int sampleBufferIndex = 0;
+    if (wasSkipped)
+    {
+        pyramidLevel = -1;
+        analyser.resetFilter();
+    }
 
-            for (int pix = 0; pix < numPixelsToCreate; ++pix)
-            {
-                float min = 0;
-                float max = 0;
-                Array<float> samples;
-                samples.resize(samplesPerPixel);
-
-                // find min, max for cached samples
-                if (pix == 0 && numCachedSamples > 0)
-                {
-                    for (int cachedSampIdx = 0; cachedSampIdx < numCachedSamples; ++cachedSampIdx)
-                    {
-                        const auto val = popFrontCachedSampleForChannel(channel);
-                        samples.set(cachedSampIdx, val);
-
-                        if (cachedSampIdx == 0)
-                        {
-                            min = val;
-                            max = val;
-                        }
-                        else
-                        {
-                            if (val > max)
-                                max = val;
-                            if (val < min)
-                                min = val;
-                        }
-                    }
-                }
-
-                // find min, max for new buffer samples
-                for (int sampIdx = (pix == 0 && numCachedSamples > 0 ? numCachedSamples : 0); sampIdx < samplesPerPixel; ++sampIdx)
-                {
-                    const auto val = dataBuffer->getSample(sampleBufferIndex, channel);
-                    samples.set(sampIdx, val);
-
-                    if (sampIdx == 0)
-                    {
-                        min = val;
-                        max = val;
-                    }
-                    else
-                    {
-                        if (val > max)
-                            max = val;
-                        if (val < min)
-                            min = val;
-                    }
-                    ++sampleBufferIndex;
-                }
-
-                float median = (max + min) / 2.0f;
-                float rms = 0;
-                float spikeRate = 0;
-                int numSpikesInPixel = 0;
-
-                const float spikeRateThreshold = optionsBar->getSpikeRateThreshold();
-
-                for (int sampIdx = 0; sampIdx < samplesPerPixel; ++sampIdx)
-                {
-                    const float medianOffsetVal = samples[sampIdx] - median;
-
-                    if(modeId == RenderMode::RMS) // RMS
-                    {
-                        rms += (medianOffsetVal * medianOffsetVal);
-                    }
-
-                    else if (modeId == RenderMode::SPIKE_RATE) // Spike Rate
-                    {
-                        if (medianOffsetVal < spikeRateThreshold)
-                            numSpikesInPixel++;
-                    }
-                    else // FFT
-                    {
-                        if (inputDownsamplingIndex[channel]++ == 0)
-                            channelFFTSampleBuffer[channel]->pushSample(medianOffsetVal / 500.0f);
-                        else if (inputDownsamplingIndex[channel] >= numSamplesToChunk)
-                            inputDownsamplingIndex[channel] = 0;
-                    }
-                }
-
-
-                if (modeId == RenderMode::RMS)
-                {
-                    rms = sqrtf(rms / samplesPerPixel);
-
-                    channelsView->pushPixelValueForChannel(channel, rms);
-                }
-                else if(modeId == RenderMode::SPIKE_RATE)
-                {
-                    spikeRate = numSpikesInPixel / (samplesPerPixel / getChannelSampleRate(channel));
-                    channelsView->pushPixelValueForChannel(channel, spikeRate);
-                }
-                else
-                {
-                    for (int sampleIdx = 0; sampleIdx < ProbeViewerCanvas::FFT_SIZE; ++sampleIdx)
-                    {
-                        fftInput[sampleIdx] = fftWindow[sampleIdx] * channelFFTSampleBuffer[channel]->readSample(sampleIdx);
-                    }
-
-                    kiss_fftr(fft_cfg, fftInput.data(), fftOutput);
-
-                    const int bin = optionsBar->getFFTCenterFrequencyBin();
-                    const float fftValueDb = 20 * log10((fftOutput[bin].r * fftOutput[bin].r + fftOutput[bin].i * fftOutput[bin].i) * 2 / ProbeViewerCanvas::FFT_SIZE);
-                
-                    channelsView->pushPixelValueForChannel(channel, fftValueDb);
-                }
+    updateRawPixelSize(jmin(timeWindow, ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE), wasSkipped);
 
-            }
+    analyser.setFilterBand(FilterBand(analysisFilterBand.load()));
 
-            for (int sampIdx = sampleBufferIndex; sampIdx < numSamplesToRead; ++sampIdx)
-            {
-                partialBufferCache[channel]->add(dataBuffer->getSample(sampleBufferIndex, channel));
-            }
-        }
+    if (!dataBuffer->hasSamplesReadyForDrawing())
+        return 0;
 
-        channelsView->numPixelUpdates = numTicks;
+    auto readRange = dataBuffer->beginRead();
+    const bool isInt16 = dataBuffer->getSampleStorage() == SampleStorage::INT16;
+    const float spikeThresholdFactor = analysisSpikeThresholdFactor;
 
-        channelsView->isDirty.set(true);
-        dataBuffer->clearSamplesReadyForDrawing();
-        repaint(0, 0, getWidth(), getHeight());
-    }
-}
+    // stop at the end of the last pixel the queue has room for
+    const int maxSamples = analyser.getNumSamplesToPixelEnd() + (maxColumns - 1) * analyser.getSamplesPerPixel();
 
-int ProbeViewerCanvas::getNumCachedSamples(int channel)
-{
-    return partialBufferCache[channel]->size();
+    if (readRange.getLength() > maxSamples)
+        readRange.end = readRange.start + maxSamples;
+
+    // every channel sees the same samples with the same pixel phase, so
+    // they all complete the same number of pixels; each channel only
+    // touches its own state, so the output does not depend on scheduling
+    int numPixelsCreated = 0;
+
+    analysisPool->parallelFor(numChannels, channelsPerTask, [&](int begin, int end, int threadIndex)
+    {
+        // decaying filter states would otherwise turn denormal
+        const ScopedNoDenormals noDenormals;
+
+        const int numGroupPixels = isInt16
+            ? reduceRangeForChannelGroup<int16>(begin, end, readRange, spikeThresholdFactor, threadIndex)
+            : reduceRangeForChannelGroup<float>(begin, end, readRange, spikeThresholdFactor, threadIndex);
+
+        if (begin == 0)
+            numPixelsCreated = numGroupPixels;
+    });
+
+    // the incomplete last pixel lives on in the accumulators
+    dataBuffer->endRead(readRange);
+
+    columnQueue.finishPush(numPixelsCreated);
+
+    return numPixelsCreated;
 }
 
-#pragma mark - ProbeViewerCanvas Constants
+template <typename SampleType>
+int ProbeViewerCanvas::reduceRangeForChannelGroup(int begin, int end, const RingBufferCursor::Range& range, float spikeThresholdFactor,
+                                                  int threadIndex)
+{
+    const int numGroupChannels = end - begin;
 
-const float ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE = 10.0f;
-// load the fftWindow with a Hanning window
-const std::vector<float> ProbeViewerCanvas::fftWindow = []() -> std::vector<float> {
-    std::vector<float> window;
+    CircularBuffer::ChannelSpans<SampleType> spans[BiquadFilterBank::numLanes];
+    float scales[BiquadFilterBank::numLanes];
 
-    for (int i = 0; i < ProbeViewerCanvas::FFT_SIZE; ++i)
+    for (int lane = 0; lane < numGroupChannels; ++lane)
     {
-        window.push_back(0.5 * (1 - cos((2 * M_PI * i) / (ProbeViewerCanvas::FFT_SIZE - 1))));
+        if constexpr (std::is_same<SampleType, int16>::value)
+        {
+            spans[lane] = dataBuffer->getInt16Spans(range, begin + lane);
+            scales[lane] = dataBuffer->getBitVolts(begin + lane);
+        }
+        else
+        {
+            spans[lane] = dataBuffer->getFloatSpans(range, begin + lane);
+            scales[lane] = 1.0f;
+        }
     }
 
-    return window;
-}();
+    const SampleType* inputs[BiquadFilterBank::numLanes];
+    int numPixelsCreated = 0;
 
-#pragma mark - ProbeViewerCanvas::FFTSampleCacheBuffer -
+    // every channel wraps around the ring at the same sample
+    for (int part = 0; part < 2; ++part)
+    {
+        for (int lane = 0; lane < numGroupChannels; ++lane)
+            inputs[lane] = part == 0 ? spans[lane].first : spans[lane].second;
 
-ProbeViewerCanvas::FFTSampleCacheBuffer::FFTSampleCacheBuffer(int size)
-    : writeIdx(0), readIdx(1), bufferSize(size)
-{
-    buffer.resize(size);
+        numPixelsCreated += analyser.reduceChannelGroup(begin, end, inputs, scales,
+                                                        part == 0 ? spans[0].firstSize : spans[0].secondSize,
+                                                        spikeThresholdFactor, threadIndex, columnQueue, numPixelsCreated);
+    }
+
+    return numPixelsCreated;
 }
 
-ProbeViewerCanvas::FFTSampleCacheBuffer::~FFTSampleCacheBuffer()
+void ProbeViewerCanvas::updateRawPixelSize(float timeWindow, bool shouldRestart)
 {
+    const int defaultSamplesPerPixel = analyser.getBaselineSamples();
+    const float sampleRate = pvProcessor->getStreamSampleRate();
+    const int samplesPerPixel = timeWindow < ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE
+        ? jlimit(1, defaultSamplesPerPixel, roundToInt(timeWindow * sampleRate / ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH))
+        : defaultSamplesPerPixel;
+
+    if (samplesPerPixel == analyser.getSamplesPerPixel() && !shouldRestart)
+        return;
+
+    analyser.setPixelSize(samplesPerPixel);
+
+    drawnTimeWindow = samplesPerPixel == defaultSamplesPerPixel
+        ? ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE
+        : samplesPerPixel * ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH / sampleRate;
 }
 
-void ProbeViewerCanvas::FFTSampleCacheBuffer::resize(const int size)
+int ProbeViewerCanvas::updateScreenBuffersFromPixelColumns(int maxColumns)
 {
-    bufferSize = size;
-    buffer.clear();
-    buffer = std::vector<float>(size, 0.0f);
+    PixelColumnReducer* pixelColumns = dataBuffer->getPixelColumns();
 
-    writeIdx = 0;
-    readIdx = 1;
+    // the background context has been drawn, continue with the raw samples
+    if (dataBuffer->getIngestMode() == IngestMode::RAW_SAMPLES && !pixelColumns->hasColumnsReady())
+    {
+        dataBuffer->releasePixelColumns();
+        return 0;
+    }
+
+    if (!pixelColumns->hasColumnsReady() || pixelColumns->getNumChannels() < numChannels)
+        return 0;
+
+    auto readRange = dataBuffer->beginPixelColumnRead();
+
+    // bound the work per pass, the remaining columns stay queued
+    if (readRange.getLength() > maxColumns)
+        readRange.end = readRange.start + maxColumns;
+
+    // channels are independent, so each thread walks every column for its
+    // own, a group of the batched FFT at a time
+    analysisPool->parallelFor(numChannels, channelsPerTask, [&](int begin, int end, int threadIndex)
+    {
+        for (int64 column = readRange.start; column < readRange.end; ++column)
+        {
+            analyser.addReducedColumnForChannelGroup(begin, end, *pixelColumns, column,
+                                                     columnQueue.getWritableColumn(int(column - readRange.start)), threadIndex);
+        }
+    });
+
+    dataBuffer->endPixelColumnRead(readRange);
+
+    columnQueue.finishPush(readRange.getLength());
+
+    return readRange.getLength();
 }
 
-namespace
-{
-void incrementIndices(int &writeIdx, int &readIdx, int bufferSize)
+int ProbeViewerCanvas::updateScreenBuffersFromSummaryPyramid(float timeWindow, int maxColumns)
 {
-    writeIdx = readIdx++;
+    // the raw samples are not drawn at this zoom, and the default window
+    // starts over from the latest one when it is selected again
+    dataBuffer->clearSamplesReadyForDrawing();
 
-    if (readIdx >= bufferSize)
+    SummaryPyramid* pyramid = dataBuffer->getSummaryPyramid();
+
+    if (pyramid->getNumLevels() == 0)
+        return 0;
+
+    const float sampleRate = pvProcessor->getStreamSampleRate();
+    const int level = pyramid->getLevelForBucketSize(timeWindow * sampleRate / ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH);
+
+    if (level != pyramidLevel)
     {
-        readIdx = 0;
+        pyramidLevel = level;
+        pyramid->seekToLatest(level, ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH);
+
+        // the level's bucket size is a power of two, so the window shown is the nearest one to the selection
+        drawnTimeWindow = ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH * pyramid->getBucketSize(level) / sampleRate;
+    }
+
+    if (!pyramid->hasBucketsReady(level))
+        return 0;
+
+    auto readRange = pyramid->beginRead(level);
+
+    if (readRange.getLength() > maxColumns)
+        readRange.end = readRange.start + maxColumns;
+
+    const float bucketDuration = pyramid->getBucketSize(level) / sampleRate;
+
+    // each channel's buckets are contiguous, so read a channel at a time
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int64 position = readRange.start; position < readRange.end; ++position)
+        {
+            float* values = columnQueue.getWritableColumn(int(position - readRange.start));
+            const SummaryBucket& bucket = pyramid->getBucket(level, position, channel);
+
+            // the pyramid keeps no decimated samples, so there is no band power to show
+            values[int(RenderMode::RMS) * numChannels + channel] = bucket.getRMS();
+            values[int(RenderMode::SPIKE_RATE) * numChannels + channel] = bucket.crossings / bucketDuration;
+            values[int(RenderMode::FFT) * numChannels + channel] = std::numeric_limits<float>::quiet_NaN();
+
+            for (int band = 0; band < NUM_SPECTRAL_BANDS; ++band)
+                values[int(getRenderModeForBand(SpectralBand(band))) * numChannels + channel] = std::numeric_limits<float>::quiet_NaN();
+        }
     }
 
-    jassert(writeIdx < bufferSize);
-    jassert(readIdx < bufferSize);
+    pyramid->endRead(level, readRange);
+
+    columnQueue.finishPush(readRange.getLength());
+
+    return readRange.getLength();
 }
-} // namespace
 
-void ProbeViewerCanvas::FFTSampleCacheBuffer::pushSample(const float sample)
+void ProbeViewerCanvas::updateSpectrumSettings()
 {
-    buffer[writeIdx] = sample;
-    incrementIndices(writeIdx, readIdx, bufferSize);
+    const int fftSize = analysisFFTSize;
+
+    analyser.setSpectrum(fftSize, analysisFFTNumSegments, jmax(1, roundToInt(fftSize * (1.0f - analysisFFTOverlap))),
+                         analysisFFTBin);
 }
 
-float ProbeViewerCanvas::FFTSampleCacheBuffer::readSample(int index) const
+#pragma mark - ProbeViewerCanvas Constants
+
+const float ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE = 10.0f;
+
+#pragma mark - ProbeViewerAnalysisThread -
+
+ProbeViewerAnalysisThread::ProbeViewerAnalysisThread(ProbeViewerCanvas* canvas)
+    : Thread("Probe Viewer Analysis"), canvas(canvas)
 {
-    jassert(index < bufferSize);
+}
 
-    index += readIdx;
+ProbeViewerAnalysisThread::~ProbeViewerAnalysisThread()
+{
+}
 
-    if (index >= bufferSize)
+void ProbeViewerAnalysisThread::run()
+{
+    while (!threadShouldExit())
     {
-        index -= bufferSize;
+        if (canvas->analyseDisplayedStream() == 0)
+            wait(analysisIdleWaitMs);
     }
-
-    jassert(index < bufferSize);
-
-    return buffer[index];
 }
 
 #pragma mark - ProbeViewerViewport -
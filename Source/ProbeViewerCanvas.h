@@ -25,10 +25,16 @@
 #define __PROBEVIEWERCANVAS_H__
 
 #include "VisualizerWindowHeaders.h"
-#include "kissfft/kiss_fftr.h"
+#include "Utilities/PixelColumnQueue.hpp"
+#include "Utilities/RingBufferCursor.hpp"
+#include "Processing/StreamAnalyser.hpp"
+
+#include <atomic>
 
 namespace ProbeViewer {
 
+enum class RenderMode : int;
+
 class ProbeViewerCanvas : public Visualizer
 {
 public:
@@ -119,14 +125,25 @@ public:
      */
     class ChannelBrowser* getChannelBrowserPtr();
 
+    /**
+     *  Return the queue of pixel columns produced by the analysis thread.
+     *  Only the ChannelViewCanvas may consume from it.
+     */
+    PixelColumnQueue* getPixelColumnQueue();
+
+    /**
+     *  Reduces whatever the displayed stream has ready into pixel columns,
+     *  holding the analysis lock a chunk of columns at a time and stopping
+     *  early when the message thread asks for it. Called repeatedly by the
+     *  analysis thread; returns the number of columns queued, or 0 when
+     *  there was nothing to do.
+     */
+    int analyseDisplayedStream();
+
     static const float TRANSPORT_WINDOW_TIMEBASE;
 #ifdef WIN32
-    static const int FFT_ORDER = 8;
-    static const int FFT_SIZE = 1 << ProbeViewerCanvas::FFT_ORDER;
     static const int FFT_TARGET_SAMPLE_RATE = 1000;
 #else
-	static constexpr int FFT_ORDER = 8;
-	static constexpr int FFT_SIZE = 1 << ProbeViewerCanvas::FFT_ORDER;
 	static constexpr int FFT_TARGET_SAMPLE_RATE = 1000;
 #endif
 
@@ -140,94 +157,104 @@ private:
     ScopedPointer<class ProbeViewerTimeScale> timeScale;
     ScopedPointer<class CanvasOptionsBar> optionsBar;
     ScopedPointer<class ProbeViewerViewport> viewport;
+    ScopedPointer<class ProbeViewerAnalysisThread> analysisThread;
 
     class CircularBuffer* dataBuffer;
-    OwnedArray<Array<float>> partialBufferCache;
-
-    std::vector<size_t> inputDownsamplingIndex;
-    size_t numSamplesToChunk;
 
+    /** Reduces the raw samples, or the audio thread's columns, into pixel columns */
+    StreamAnalyser analyser;
 
-    kiss_fftr_cfg fft_cfg;
-    std::vector<float> fftInput;
-    kiss_fft_cpx fftOutput[ProbeViewerCanvas::FFT_SIZE/2 + 1];
+    /** Spreads the analyser's channel groups across cores */
+    ScopedPointer<class WorkStealingPool> analysisPool;
 
+    int numChannels;
+    bool isUpdating;
 
+    /**
+     *  Columns handed from the analysis thread to the renderer. Each holds
+     *  the value of every RenderMode for every channel, laid out as
+     *  [mode][channel], so switching modes needs no new analysis.
+     */
+    PixelColumnQueue columnQueue;
 
-    class FFTSampleCacheBuffer
-    {
-    public:
-
-        /**
-         *
-         */
-        FFTSampleCacheBuffer(int size);
-        ~FFTSampleCacheBuffer();
-
+    /**
+     *  Snapshot of the options the analysis thread needs, published from
+     *  the message thread on every refresh
+     */
+    std::atomic<int> analysisRenderMode;
+    std::atomic<float> analysisSpikeThresholdFactor;
+    std::atomic<float> analysisTimeWindow;
+    std::atomic<int> analysisFFTBin;
+    std::atomic<int> analysisFFTSize;
+    std::atomic<int> analysisFFTNumSegments;
+    std::atomic<float> analysisFFTOverlap;
+    std::atomic<int> analysisFilterBand;
 
-        /**
-         *  FFTSampleCacheBuffer is non-copyable and non-moveable
-         */
-        FFTSampleCacheBuffer(const FFTSampleCacheBuffer &) = delete;
-        FFTSampleCacheBuffer(FFTSampleCacheBuffer &&) = delete;
-        FFTSampleCacheBuffer& operator=(const FFTSampleCacheBuffer &) = delete;
-        FFTSampleCacheBuffer& operator=(FFTSampleCacheBuffer &) = delete;
+    /** Copies the current options into the analysis snapshot */
+    void publishAnalysisSettings();
 
+    /** The window the queued columns cover, and the one the time scale shows */
+    std::atomic<float> drawnTimeWindow;
+    float shownTimeWindow;
 
-        /**
-         *  Resizes the internal memory structure to the size given in the
-         *  param.
-         *
-         *  Calling this method flushes all of the current values stored,
-         *  resets the write and read indices, and reverts the structure
-         *  to its initialization state at the new buffer size.
-         */
-        void resize(int size);
+    /** Queues up to maxColumnsToQueue columns; returns the number queued */
+    int updateScreenBuffers(int maxColumnsToQueue);
 
-        /**
-         *  Push one new sample to the end of the buffer.
-         *
-         *  This method will add a new sample to the buffer, overwriting the
-         *  oldest sample and incrementing the write and read indices forward
-         *  by one position. The increment automatically wraps.
-         */
-        void pushSample(const float sample);
+    /** Queues pixel columns that were already reduced on the audio thread */
+    int updateScreenBuffersFromPixelColumns(int maxColumns);
 
-        /**
-         *  Read one sample from the buffer at the given index.
-         *
-         *  @param index    The given index must be in the range [0, size), and
-         *                  the buffer will automatically adjust for the current
-         *                  position of the internal readIdx.
-         */
-        float readSample(int index) const;
+    /**
+     *  Queues the buckets of the summary pyramid level closest to the given
+     *  window, longer than the default one, redrawing the whole screen from
+     *  its history when the level changes
+     */
+    int updateScreenBuffersFromSummaryPyramid(float timeWindow, int maxColumns);
 
+    /**
+     *  Sets the pixel size the raw samples are reduced at for a window no
+     *  longer than the default one, restarting the pixels in progress if
+     *  it changes or shouldRestart is set
+     */
+    void updateRawPixelSize(float timeWindow, bool shouldRestart);
 
-        /**
-         *  Return the number of writable samples available to this buffer
-         */
-        int size() { return bufferSize; }
+    /** Level of the summary pyramid being drawn, or -1 for the raw samples */
+    int pyramidLevel;
 
-    private:
-        int bufferSize;
-        int writeIdx;
-        int readIdx;
+    /**
+     *  Hands the selected FFT size, averaging, overlap and bin to the
+     *  analyser, which ::update sized for every option, so it does not
+     *  allocate on the analysis thread
+     */
+    void updateSpectrumSettings();
 
-        std::vector<float> buffer;
-    };
+    /**
+     *  Hands the raw samples of the channels begin..end - 1 in a read range
+     *  to the analyser, a part of the ring at a time. Returns the number of
+     *  pixels written per channel.
+     */
+    template <typename SampleType>
+    int reduceRangeForChannelGroup(int begin, int end, const RingBufferCursor::Range& range, float spikeThresholdFactor,
+                                   int threadIndex);
 
-    OwnedArray<FFTSampleCacheBuffer> channelFFTSampleBuffer;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeViewerCanvas);
+};
 
-    static const std::vector<float> fftWindow;
+/**
+ *  Turns the displayed stream into pixel columns off the message thread,
+ *  so the refresh callback only has to paint them.
+ */
+class ProbeViewerAnalysisThread : public Thread
+{
+public:
+    ProbeViewerAnalysisThread(ProbeViewerCanvas*);
+    virtual ~ProbeViewerAnalysisThread() override;
 
-    int numChannels;
-    bool isUpdating;
+    void run() override;
 
-    void updateScreenBuffers();
-    int getNumCachedSamples(int channel);
-    float popFrontCachedSampleForChannel(int channel);
+private:
+    ProbeViewerCanvas* canvas;
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeViewerCanvas);
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeViewerAnalysisThread);
 };
 
 class ProbeViewerViewport : public Viewport
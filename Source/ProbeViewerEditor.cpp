@@ -34,22 +34,90 @@ ProbeViewerEditor::ProbeViewerEditor(GenericProcessor* parentNode)
 {
     probeViewerProcessor = (ProbeViewerNode *)parentNode;
         
-    desiredWidth = 180;
+    desiredWidth = 375;
     
     streamSelectionLabel = std::make_unique<Label>("Stream Selection Label", "Display Stream:");
     streamSelectionLabel->setBounds(10, 30, 130, 24);
     addAndMakeVisible(streamSelectionLabel.get());
 
 	streamSelection = std::make_unique<ComboBox>("Stream Selector");
-    streamSelection->setBounds(15, 60, 155, 20);
+    streamSelection->setBounds(15, 54, 155, 20);
     streamSelection->addListener(this);
     addAndMakeVisible(streamSelection.get());
     
     streamSampleRateLabel = std::make_unique<Label>("Stream Sample Rate Label", "Sample Rate:");
 	streamSampleRateLabel->setFont(Font("Fira Code", "SemiBold", 16.0f));
 	streamSampleRateLabel->setJustificationType(Justification::centred);
-    streamSampleRateLabel->setBounds(10, 90, 160, 24);
+    streamSampleRateLabel->setBounds(10, 76, 160, 24);
     addAndMakeVisible(streamSampleRateLabel.get());
+
+    referenceModeLabel = std::make_unique<Label>("Reference Mode Label", "Reference:");
+    referenceModeLabel->setBounds(10, 102, 75, 20);
+    addAndMakeVisible(referenceModeLabel.get());
+
+    // subtracted from every channel before it is stored, to remove noise shared across the probe
+    StringArray referenceModeNames = {"None", "CAR", "Median", "Local median"};
+    referenceModeSelection = std::make_unique<ComboBox>("Reference Mode Selector");
+    referenceModeSelection->addItemList(referenceModeNames, 1);
+    referenceModeSelection->setSelectedId(1, dontSendNotification);
+    referenceModeSelection->setBounds(85, 102, 85, 20);
+    referenceModeSelection->addListener(this);
+    addAndMakeVisible(referenceModeSelection.get());
+
+    ingestModeLabel = std::make_unique<Label>("Ingest Mode Label", "Ingest:");
+    ingestModeLabel->setBounds(185, 30, 70, 20);
+    addAndMakeVisible(ingestModeLabel.get());
+
+    // "Pixel columns" reduces on the audio thread and keeps only what is drawn
+    StringArray ingestModeNames = {"Raw samples", "Pixel columns"};
+    ingestModeSelection = std::make_unique<ComboBox>("Ingest Mode Selector");
+    ingestModeSelection->addItemList(ingestModeNames, 1);
+    ingestModeSelection->setSelectedId(1, dontSendNotification);
+    ingestModeSelection->setBounds(255, 30, 110, 20);
+    ingestModeSelection->addListener(this);
+    addAndMakeVisible(ingestModeSelection.get());
+
+    sampleStorageLabel = std::make_unique<Label>("Sample Storage Label", "Storage:");
+    sampleStorageLabel->setBounds(185, 54, 70, 20);
+    addAndMakeVisible(sampleStorageLabel.get());
+
+    // "Int16" keeps samples in units of each channel's bitVolts, at half the memory
+    StringArray sampleStorageNames = {"Float32", "Int16"};
+    sampleStorageSelection = std::make_unique<ComboBox>("Sample Storage Selector");
+    sampleStorageSelection->addItemList(sampleStorageNames, 1);
+    sampleStorageSelection->setSelectedId(1, dontSendNotification);
+    sampleStorageSelection->setBounds(255, 54, 110, 20);
+    sampleStorageSelection->addListener(this);
+    addAndMakeVisible(sampleStorageSelection.get());
+
+    backgroundPolicyLabel = std::make_unique<Label>("Background Policy Label", "Hidden:");
+    backgroundPolicyLabel->setBounds(185, 78, 70, 20);
+    addAndMakeVisible(backgroundPolicyLabel.get());
+
+    // what is kept for the streams that are not selected above
+    StringArray backgroundPolicyNames = {"Not ingested", "Reduced stats"};
+    backgroundPolicySelection = std::make_unique<ComboBox>("Background Policy Selector");
+    backgroundPolicySelection->addItemList(backgroundPolicyNames, 1);
+    backgroundPolicySelection->setSelectedId(2, dontSendNotification);
+    backgroundPolicySelection->setBounds(255, 78, 110, 20);
+    backgroundPolicySelection->addListener(this);
+    addAndMakeVisible(backgroundPolicySelection.get());
+
+    analysisThreadsLabel = std::make_unique<Label>("Analysis Threads Label", "Threads:");
+    analysisThreadsLabel->setBounds(185, 102, 70, 20);
+    addAndMakeVisible(analysisThreadsLabel.get());
+
+    // cap on the cores the canvas reduces channels on, so instances can share the machine
+    analysisThreadsSelection = std::make_unique<ComboBox>("Analysis Threads Selector");
+    analysisThreadsSelection->addItem("All cores", 1);
+
+    for (int maxThreads : {1, 2, 4, 8})
+        analysisThreadsSelection->addItem(String(maxThreads), maxThreads + 1);
+
+    analysisThreadsSelection->setSelectedId(1, dontSendNotification);
+    analysisThreadsSelection->setBounds(255, 102, 110, 20);
+    analysisThreadsSelection->addListener(this);
+    addAndMakeVisible(analysisThreadsSelection.get());
 }
 
 ProbeViewerEditor::~ProbeViewerEditor()
@@ -62,6 +130,47 @@ void ProbeViewerEditor::comboBoxChanged(ComboBox* cb)
     {
         setDrawableStream(cb->getSelectedId());
     }
+    else if (cb == ingestModeSelection.get())
+    {
+        IngestMode mode = cb->getSelectedId() == 2 ? IngestMode::PIXEL_COLUMNS : IngestMode::RAW_SAMPLES;
+
+        // buffers are reallocated, which cannot happen while data is flowing
+        if (CoreServices::getAcquisitionStatus())
+        {
+            cb->setSelectedId(probeViewerProcessor->getIngestMode() == IngestMode::PIXEL_COLUMNS ? 2 : 1, dontSendNotification);
+            return;
+        }
+
+        probeViewerProcessor->setIngestMode(mode);
+    }
+    else if (cb == sampleStorageSelection.get())
+    {
+        SampleStorage storage = cb->getSelectedId() == 2 ? SampleStorage::INT16 : SampleStorage::FLOAT32;
+
+        if (CoreServices::getAcquisitionStatus())
+        {
+            cb->setSelectedId(probeViewerProcessor->getSampleStorage() == SampleStorage::INT16 ? 2 : 1, dontSendNotification);
+            return;
+        }
+
+        probeViewerProcessor->setSampleStorage(storage);
+    }
+    else if (cb == referenceModeSelection.get())
+    {
+        // item ids follow ReferenceMode, starting at 1
+        probeViewerProcessor->setReferenceMode(ReferenceMode(cb->getSelectedId() - 1));
+    }
+    else if (cb == backgroundPolicySelection.get())
+    {
+        probeViewerProcessor->setBackgroundStreamPolicy(cb->getSelectedId() == 1
+            ? BackgroundStreamPolicy::SKIP
+            : BackgroundStreamPolicy::REDUCED_STATS);
+    }
+    else if (cb == analysisThreadsSelection.get())
+    {
+        // item ids are the cap plus one, with "All cores" as 0
+        probeViewerProcessor->setMaxAnalysisThreads(cb->getSelectedId() - 1);
+    }
 
 	if (canvas != nullptr)
 		canvas->update();
@@ -130,12 +239,22 @@ void ProbeViewerEditor::updateStreamSelectorOptions()
 void ProbeViewerEditor::saveVisualizerEditorParameters(XmlElement* xml)
 {
 	xml->setAttribute("selectedStream", streamSelection->getSelectedItemIndex());
+	xml->setAttribute("ingestMode", ingestModeSelection->getSelectedId());
+	xml->setAttribute("sampleStorage", sampleStorageSelection->getSelectedId());
+	xml->setAttribute("backgroundPolicy", backgroundPolicySelection->getSelectedId());
+	xml->setAttribute("referenceMode", referenceModeSelection->getSelectedId());
+	xml->setAttribute("analysisThreads", analysisThreadsSelection->getSelectedId());
 }
 
 void ProbeViewerEditor::loadVisualizerEditorParameters(XmlElement* xml)
 {
 
 	streamSelection->setSelectedItemIndex(xml->getIntAttribute("selectedStream"), sendNotification);
+	ingestModeSelection->setSelectedId(xml->getIntAttribute("ingestMode", 1), sendNotification);
+	sampleStorageSelection->setSelectedId(xml->getIntAttribute("sampleStorage", 1), sendNotification);
+	backgroundPolicySelection->setSelectedId(xml->getIntAttribute("backgroundPolicy", 2), sendNotification);
+	referenceModeSelection->setSelectedId(xml->getIntAttribute("referenceMode", 1), sendNotification);
+	analysisThreadsSelection->setSelectedId(xml->getIntAttribute("analysisThreads", 1), sendNotification);
 }
 
 void ProbeViewerEditor::setDrawableStream(int index)
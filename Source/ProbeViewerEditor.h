@@ -71,6 +71,21 @@ private:
 
     std::unique_ptr<Label> streamSampleRateLabel;
 
+    std::unique_ptr<Label> referenceModeLabel;
+    std::unique_ptr<ComboBox> referenceModeSelection;
+
+    std::unique_ptr<Label> ingestModeLabel;
+    std::unique_ptr<ComboBox> ingestModeSelection;
+
+    std::unique_ptr<Label> sampleStorageLabel;
+    std::unique_ptr<ComboBox> sampleStorageSelection;
+
+    std::unique_ptr<Label> backgroundPolicyLabel;
+    std::unique_ptr<ComboBox> backgroundPolicySelection;
+
+    std::unique_ptr<Label> analysisThreadsLabel;
+    std::unique_ptr<ComboBox> analysisThreadsSelection;
+
     bool hasNoInputs;
 
     void setDrawableStream(int index);
@@ -25,6 +25,7 @@
 
 #include "ProbeViewerEditor.h"
 #include "ProbeViewerCanvas.h"
+#include "ChannelViewCanvas/ChannelViewCanvas.hpp"
 
 using namespace ProbeViewer;
 
@@ -33,6 +34,15 @@ ProbeViewerNode::ProbeViewerNode()
 {
 	streamToDraw = -1;
 	numStreams = -1;
+	ingestMode = IngestMode::RAW_SAMPLES;
+	sampleStorage = SampleStorage::FLOAT32;
+	backgroundStreamPolicy = BackgroundStreamPolicy::REDUCED_STATS;
+	referenceMode = ReferenceMode::NONE;
+	maxAnalysisThreads = 0;
+	isUpdatingSettings = false;
+	isInProcess = false;
+	numProcessedBlocks = 0;
+	numAnalysisLockRequests = 0;
 }
 
 ProbeViewerNode::~ProbeViewerNode()
@@ -46,24 +56,36 @@ AudioProcessorEditor* ProbeViewerNode::createEditor()
 
 void ProbeViewerNode::process(AudioBuffer<float>& buffer)
 {
-	for (int chan = 0; chan < buffer.getNumChannels(); chan++)
-    {
-		uint16 streamId = continuousChannels[chan]->getStreamId();
-		int localId = continuousChannels[chan]->getLocalIndex();
-		int globalId = continuousChannels[chan]->getGlobalIndex();
-		uint32 nSamples = getNumSamplesInBlock(streamId);
+	isInProcess.store(true);
+
+	for (const auto& range : streamChannelRanges)
+	{
+		if (!range.dataBuffer->isIngestEnabled())
+			continue;
+
+		const uint32 nSamples = getNumSamplesInBlock(range.streamId);
 
-		dataBufferMap[streamId]->addData(buffer, localId, globalId, nSamples);
+		range.dataBuffer->addBlock(buffer, range.firstGlobalChannel, range.numChannels, nSamples);
 	}
+
+	numProcessedBlocks.fetch_add(1);
+	isInProcess.store(false);
 }
 
 void ProbeViewerNode::updateSettings()
 {
     LOGD("Setting num inputs on ProbeViewer to ", getNumInputs());
 
+	const ScopedAnalysisLock lock(*this);
+
+	// every buffer is reallocated below, so the stream selection does not need to
+	isUpdatingSettings = true;
+
 	ProbeViewerEditor * ed = (ProbeViewerEditor*) getEditor();
 	ed->updateStreamSelectorOptions();
 
+	isUpdatingSettings = false;
+
 	LOGD("Selected Stream ID: ", streamToDraw);
 	
 	for(auto stream : getDataStreams())
@@ -92,7 +114,7 @@ void ProbeViewerNode::updateSettings()
 
         if (dataBuffer->isNeeded)
         {
-            dataBuffer->update();
+            reallocateBuffer(dataBuffer);
         }
         else
 		{
@@ -107,10 +129,29 @@ void ProbeViewerNode::updateSettings()
         dataBuffers.removeObject(dataBuffer, true);
     }
 
+	streamChannelRanges.clear();
+
+	for (auto stream : getDataStreams())
+	{
+		if (stream->getChannelCount() == 0)
+			continue;
+
+		StreamChannelRange range;
+		range.streamId = stream->getStreamId();
+		range.dataBuffer = dataBufferMap[range.streamId];
+		range.firstGlobalChannel = stream->getContinuousChannels()[0]->getGlobalIndex();
+		range.numChannels = stream->getChannelCount();
+
+		streamChannelRanges.add(range);
+	}
+
 }
 
 bool ProbeViewerNode::startAcquisition()
 {
+	for (auto dataBuffer : dataBuffers)
+		dataBuffer->resetDropStatistics();
+
 	((ProbeViewerEditor*) getEditor())->enable();
     return true;
 }
@@ -124,6 +165,9 @@ bool ProbeViewerNode::stopAcquisition()
 void ProbeViewerNode::setDisplayedStream(int idx)
 {
 	streamToDraw = idx;
+
+	if (!isUpdatingSettings)
+		updateBufferRoles();
 }
 
 uint16 ProbeViewerNode::getDisplayedStream()
@@ -147,6 +191,192 @@ int ProbeViewerNode::getNumStreamChannels()
 		return 0;
 }
 
+void ProbeViewerNode::setIngestMode(IngestMode mode)
+{
+	ingestMode = mode;
+	reconfigureBuffers();
+}
+
+IngestMode ProbeViewerNode::getIngestMode() const
+{
+	return ingestMode;
+}
+
+void ProbeViewerNode::setSampleStorage(SampleStorage storage)
+{
+	sampleStorage = storage;
+	reconfigureBuffers();
+}
+
+SampleStorage ProbeViewerNode::getSampleStorage() const
+{
+	return sampleStorage;
+}
+
+void ProbeViewerNode::setBackgroundStreamPolicy(BackgroundStreamPolicy policy)
+{
+	backgroundStreamPolicy = policy;
+	updateBufferRoles();
+}
+
+BackgroundStreamPolicy ProbeViewerNode::getBackgroundStreamPolicy() const
+{
+	return backgroundStreamPolicy;
+}
+
+void ProbeViewerNode::setSpikeThresholdFactor(float thresholdFactor)
+{
+	for (auto dataBuffer : dataBuffers)
+		dataBuffer->setSpikeThresholdFactor(thresholdFactor);
+}
+
+void ProbeViewerNode::setReferenceMode(ReferenceMode mode)
+{
+	referenceMode = mode;
+
+	// the buffers read it at the start of each block
+	for (auto dataBuffer : dataBuffers)
+		dataBuffer->setReferenceMode(mode);
+}
+
+ReferenceMode ProbeViewerNode::getReferenceMode() const
+{
+	return referenceMode;
+}
+
+void ProbeViewerNode::setMaxAnalysisThreads(int maxThreads)
+{
+	maxAnalysisThreads = jmax(0, maxThreads);
+}
+
+int ProbeViewerNode::getMaxAnalysisThreads() const
+{
+	return maxAnalysisThreads;
+}
+
+CriticalSection& ProbeViewerNode::getAnalysisLock()
+{
+	return analysisLock;
+}
+
+bool ProbeViewerNode::isAnalysisLockRequested() const
+{
+	return numAnalysisLockRequests.load() > 0;
+}
+
+ProbeViewerNode::ScopedAnalysisLock::ScopedAnalysisLock(ProbeViewerNode& node_)
+	: node(node_)
+{
+	// raised before waiting, so the analysis thread stops at its next chunk
+	node.numAnalysisLockRequests.fetch_add(1);
+	node.analysisLock.enter();
+}
+
+ProbeViewerNode::ScopedAnalysisLock::~ScopedAnalysisLock()
+{
+	node.analysisLock.exit();
+	node.numAnalysisLockRequests.fetch_sub(1);
+}
+
+bool ProbeViewerNode::shouldIngest(const CircularBuffer* dataBuffer) const
+{
+	return dataBuffer->id == streamToDraw
+		|| backgroundStreamPolicy == BackgroundStreamPolicy::REDUCED_STATS;
+}
+
+IngestMode ProbeViewerNode::getIngestModeFor(const CircularBuffer* dataBuffer) const
+{
+	return dataBuffer->id == streamToDraw ? ingestMode : IngestMode::PIXEL_COLUMNS;
+}
+
+void ProbeViewerNode::reallocateBuffer(CircularBuffer* dataBuffer)
+{
+	jassert(!dataBuffer->isIngestEnabled());
+
+	// a stream that becomes displayed keeps its background columns to draw first
+	const bool keepPixelColumns = dataBuffer->getIngestMode() == IngestMode::PIXEL_COLUMNS;
+
+	configureBuffer(dataBuffer);
+
+	if (shouldIngest(dataBuffer))
+	{
+		// a buffer whose storage could not be reserved stays disabled, and
+		// is tried again the next time the roles or settings change
+		if (dataBuffer->update(keepPixelColumns))
+			dataBuffer->setIngestEnabled(true);
+	}
+	else
+	{
+		dataBuffer->releaseStorage();
+	}
+}
+
+void ProbeViewerNode::reconfigureBuffers()
+{
+	const ScopedAnalysisLock lock(*this);
+
+	for (auto dataBuffer : dataBuffers)
+		dataBuffer->setIngestEnabled(false);
+
+	waitForProcessToFinish();
+
+	for (auto dataBuffer : dataBuffers)
+		reallocateBuffer(dataBuffer);
+}
+
+void ProbeViewerNode::updateBufferRoles()
+{
+	const ScopedAnalysisLock lock(*this);
+
+	Array<CircularBuffer*> changedBuffers;
+
+	for (auto dataBuffer : dataBuffers)
+	{
+		if (!dataBuffer->isNeeded)
+			continue;
+
+		if (dataBuffer->isIngestEnabled() != shouldIngest(dataBuffer)
+			|| dataBuffer->getIngestMode() != getIngestModeFor(dataBuffer))
+		{
+			dataBuffer->setIngestEnabled(false);
+			changedBuffers.add(dataBuffer);
+		}
+	}
+
+	if (changedBuffers.isEmpty())
+		return;
+
+	waitForProcessToFinish();
+
+	for (auto dataBuffer : changedBuffers)
+		reallocateBuffer(dataBuffer);
+}
+
+void ProbeViewerNode::waitForProcessToFinish()
+{
+	// the enabled flags were cleared before this point, and process() sets
+	// isInProcess before reading them (both sequentially consistent), so
+	// either the block in flight is seen here or the next one sees the flags
+	const int64 blocksBefore = numProcessedBlocks.load();
+
+	while (isInProcess.load() && numProcessedBlocks.load() == blocksBefore)
+		Thread::yield();
+}
+
+void ProbeViewerNode::configureBuffer(CircularBuffer* dataBuffer)
+{
+	const float sampleRate = dataBuffer->sampleRate;
+
+	// must match the layout used by ProbeChannelDisplay and the band power path
+	const int samplesPerPixel = sampleRate * ProbeViewerCanvas::TRANSPORT_WINDOW_TIMEBASE
+		/ float(ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH);
+
+	dataBuffer->setIngestMode(getIngestModeFor(dataBuffer));
+	dataBuffer->setSampleStorage(sampleStorage);
+	dataBuffer->setReferenceMode(referenceMode);
+	dataBuffer->setPixelColumnLayout(samplesPerPixel, ProbeViewerCanvas::FFT_TARGET_SAMPLE_RATE, ChannelViewCanvas::CHANNEL_DISPLAY_WIDTH);
+}
+
 CircularBuffer* ProbeViewerNode::getCircularBufferPtr()
 {
 	if(streamToDraw >= 0)
@@ -155,6 +385,24 @@ CircularBuffer* ProbeViewerNode::getCircularBufferPtr()
 		return nullptr;
 }
 
+String ProbeViewerNode::getDropStatisticsReport() const
+{
+	StringArray entries;
+
+	for (auto dataBuffer : dataBuffers)
+	{
+		const auto statistics = dataBuffer->getDropStatistics();
+
+		entries.add(String(dataBuffer->id) + ","
+			+ String(statistics.numOverruns) + ","
+			+ String(statistics.numDroppedSamples) + ","
+			+ String(statistics.numDroppedPixels) + ","
+			+ String(statistics.numTornReads));
+	}
+
+	return entries.joinIntoString(";");
+}
+
 String ProbeViewerNode::handleConfigMessage(String msg)
 {
 	
@@ -164,6 +412,12 @@ String ProbeViewerNode::handleConfigMessage(String msg)
 	// Example:
 	// ProbeA;0-69,PT,FF909F;70-97,PVT,FF909F;98-161,-,000000;162-173,-,000000,174-185,SF,90CBED;...
 
+	// The message "DROPPED" instead returns what the display lost since acquisition started:
+	// "<stream_id>,<overruns>,<dropped_samples>,<dropped_pixels>,<torn_reads>;<stream_id>,..."
+
+	if (msg.trim().equalsIgnoreCase("DROPPED"))
+		return getDropStatisticsReport();
+
 	//LOGD(msg);
 	LOGD("Probe Viewer ", getNodeId(), " received message of length ", msg.length());
 	
@@ -29,6 +29,21 @@
 
 namespace ProbeViewer {
 
+/**
+ *  What is kept for streams other than the displayed one.
+ */
+enum class BackgroundStreamPolicy : int
+{
+    /** Background streams are not ingested and hold no storage */
+    SKIP,
+
+    /**
+     *  Background streams are reduced to one screen of pixel columns, so
+     *  switching to them shows recent context immediately
+     */
+    REDUCED_STATS
+};
+
 class ProbeViewerNode : public GenericProcessor
 {
 public:
@@ -48,7 +63,10 @@ public:
     /** Updates settings */
     void updateSettings() override;
 
-    /** Updates the displayed stream, then calls updateSettings() */
+    /**
+     *  Updates the displayed stream, and reallocates the buffers whose role
+     *  changed. Safe to call during acquisition.
+     */
 	void setDisplayedStream(int idx);
 
     /** Gtes the displayed stream id*/
@@ -69,16 +87,142 @@ public:
     /** Returns the buffer for the currently selected stream*/
     CircularBuffer* getCircularBufferPtr();
 
-    /** Responds to config messages with region info */
+    /** Sets how incoming data is stored for display; must not be called during acquisition */
+    void setIngestMode(IngestMode mode);
+
+    /** Returns how incoming data is stored for display */
+    IngestMode getIngestMode() const;
+
+    /** Sets the sample format of raw buffers; must not be called during acquisition */
+    void setSampleStorage(SampleStorage storage);
+
+    /** Returns the sample format of raw buffers */
+    SampleStorage getSampleStorage() const;
+
+    /** Sets what is kept for streams that are not displayed; safe to call during acquisition */
+    void setBackgroundStreamPolicy(BackgroundStreamPolicy policy);
+
+    /** Returns what is kept for streams that are not displayed */
+    BackgroundStreamPolicy getBackgroundStreamPolicy() const;
+
+    /**
+     *  Sets the spike threshold, in noise standard deviations of each
+     *  channel, used by every buffer that reduces to pixel columns
+     */
+    void setSpikeThresholdFactor(float thresholdFactor);
+
+    /** Sets the reference subtracted from every channel of every stream; safe to call during acquisition */
+    void setReferenceMode(ReferenceMode mode);
+
+    /** Returns the reference subtracted from every channel */
+    ReferenceMode getReferenceMode() const;
+
+    /**
+     *  Caps the threads the canvas reduces channels on, including its
+     *  analysis thread, so several instances can share the machine; 0 uses
+     *  every core. Applied on the next canvas update.
+     */
+    void setMaxAnalysisThreads(int maxThreads);
+
+    /** Returns the thread cap of the canvas, or 0 for every core */
+    int getMaxAnalysisThreads() const;
+
+    /**
+     *  Held by the canvas analysis thread while it reduces a chunk of the
+     *  displayed buffer, and on the message thread, through
+     *  ScopedAnalysisLock, while buffers are reallocated
+     */
+    CriticalSection& getAnalysisLock();
+
+    /** True while the message thread waits for or holds the analysis lock */
+    bool isAnalysisLockRequested() const;
+
+    /**
+     *  Takes the analysis lock on the message thread. The analysis thread
+     *  checks for the request between chunks and hands the lock over,
+     *  rather than finishing its pass first.
+     */
+    class ScopedAnalysisLock
+    {
+    public:
+        explicit ScopedAnalysisLock(ProbeViewerNode& node);
+        ~ScopedAnalysisLock();
+
+    private:
+        ProbeViewerNode& node;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAnalysisLock)
+    };
+
+    /** Responds to config messages with region info, or with drop statistics for "DROPPED" */
     String handleConfigMessage(String msg) override;
 
 private:
     static const float bufferLengthSeconds;
 
+    /** Formats the drop statistics of every stream for handleConfigMessage() */
+    String getDropStatisticsReport() const;
+
+    /** Location of one stream's channels inside the buffer passed to process() */
+    struct StreamChannelRange
+    {
+        uint16 streamId;
+        CircularBuffer* dataBuffer;
+        int firstGlobalChannel;
+        int numChannels;
+    };
+
+    /** Rebuilt in updateSettings(), so process() needs no per-channel lookups */
+    Array<StreamChannelRange> streamChannelRanges;
+
     OwnedArray<CircularBuffer> dataBuffers;
 
     std::map<uint16, CircularBuffer*> dataBufferMap;
 
+	IngestMode ingestMode;
+	SampleStorage sampleStorage;
+	BackgroundStreamPolicy backgroundStreamPolicy;
+	ReferenceMode referenceMode;
+	int maxAnalysisThreads;
+
+	CriticalSection analysisLock;
+
+	/** Message thread callers waiting for or holding analysisLock */
+	std::atomic<int> numAnalysisLockRequests;
+
+	/** Returns true if the buffer should be written in process() */
+	bool shouldIngest(const CircularBuffer* dataBuffer) const;
+
+	/** Returns the ingest mode for a buffer: the selected one if displayed, pixel columns otherwise */
+	IngestMode getIngestModeFor(const CircularBuffer* dataBuffer) const;
+
+	/** Applies the ingest mode, storage, reference and pixel layout for the buffer's stream */
+	void configureBuffer(CircularBuffer* dataBuffer);
+
+	/** Configures a disabled buffer, then allocates and enables it or frees it */
+	void reallocateBuffer(CircularBuffer* dataBuffer);
+
+	/** Reconfigures and reallocates every buffer after a storage setting changed */
+	void reconfigureBuffers();
+
+	/** Reallocates only the buffers whose ingest mode or enabled state no longer matches */
+	void updateBufferRoles();
+
+	/**
+	 *  Blocks until process() is not inside a block that started before
+	 *  this call, so buffers disabled beforehand are no longer being written.
+	 */
+	void waitForProcessToFinish();
+
+	/** Set while updateSettings() changes the stream selection */
+	bool isUpdatingSettings;
+
+	/** Set by process() for the duration of each block */
+	std::atomic<bool> isInProcess;
+
+	/** Incremented by process() at the end of each block */
+	std::atomic<int64> numProcessedBlocks;
+
 	int streamToDraw;
 	int numStreams;
 	int lastChannelInStream;
@@ -0,0 +1,131 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "BatchedFFT.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace ProbeViewer;
+
+namespace
+{
+const double pi = 3.14159265358979323846;
+}
+
+#pragma mark - FFTPlan -
+
+FFTPlan::FFTPlan(int size)
+    : window(size)
+    , bitReversed(size / 2)
+    , cosines(size / 2 + 1)
+    , sines(size / 2 + 1)
+{
+    assert(size >= 4 && (size & (size - 1)) == 0);
+
+    // symmetric, as the window the band power has always used
+    for (int i = 0; i < size; ++i)
+        window[i] = float(0.5 * (1.0 - std::cos(2.0 * pi * i / (size - 1))));
+
+    const int numPoints = size / 2;
+    int numBits = 0;
+
+    while ((1 << numBits) < numPoints)
+        ++numBits;
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        int reversed = 0;
+
+        for (int bit = 0; bit < numBits; ++bit)
+            reversed |= ((point >> bit) & 1) << (numBits - 1 - bit);
+
+        bitReversed[point] = reversed;
+    }
+
+    for (int k = 0; k <= numPoints; ++k)
+    {
+        cosines[k] = float(std::cos(2.0 * pi * k / size));
+        sines[k] = float(std::sin(2.0 * pi * k / size));
+    }
+
+    tables.size = size;
+    tables.window = window.data();
+    tables.bitReversed = bitReversed.data();
+    tables.cosines = cosines.data();
+    tables.sines = sines.data();
+}
+
+const FFTPlan& FFTPlan::getPlan(int size)
+{
+    static std::mutex mutex;
+    static std::map<int, std::unique_ptr<FFTPlan>> plans;
+
+    const std::lock_guard<std::mutex> lock(mutex);
+
+    std::unique_ptr<FFTPlan>& plan = plans[size];
+
+    if (plan == nullptr)
+        plan.reset(new FFTPlan(size));
+
+    return *plan;
+}
+
+#pragma mark - BatchedFFT -
+
+BatchedFFT::BatchedFFT()
+    : plan(nullptr)
+    , kernels(&getPixelKernels())
+{ }
+
+void BatchedFFT::prepare(int size)
+{
+    plan = &FFTPlan::getPlan(size);
+
+    input.assign(size_t(size) * numLanes, 0.0f);
+    work.assign(size_t(size) * numLanes, 0.0f);
+    power.assign(size_t(getNumBins()) * numLanes, 0.0f);
+}
+
+void BatchedFFT::reserve(int maxSize)
+{
+    for (int size = 4; size <= maxSize; size *= 2)
+        FFTPlan::getPlan(size);
+
+    input.reserve(size_t(maxSize) * numLanes);
+    work.reserve(size_t(maxSize) * numLanes);
+    power.reserve(size_t(maxSize / 2 + 1) * numLanes);
+}
+
+const float* BatchedFFT::computePowerSpectrum()
+{
+    assert(plan != nullptr);
+
+    kernels->powerSpectrumLanes(plan->getTables(), input.data(), work.data(), power.data());
+
+    return power.data();
+}
@@ -0,0 +1,120 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef BatchedFFT_hpp
+#define BatchedFFT_hpp
+
+#include "PixelKernels.hpp"
+
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  The tables of a real FFT of one size: a symmetric Hann window, the
+ *  bit-reversal permutation and the twiddles. Plans are built once per size
+ *  and shared by every BatchedFFT of that size.
+ */
+class FFTPlan
+{
+public:
+    /**
+     *  The plan for size points, a power of two of at least 4, built on
+     *  first use. Thread-safe; the plan lives as long as the process.
+     */
+    static const FFTPlan& getPlan(int size);
+
+    int getSize() const { return tables.size; }
+
+    const FFTPlanTables& getTables() const { return tables; }
+
+private:
+    explicit FFTPlan(int size);
+
+    std::vector<float> window;
+    std::vector<int> bitReversed;
+    std::vector<float> cosines;
+    std::vector<float> sines;
+
+    FFTPlanTables tables;
+};
+
+/**
+ *  Power spectra of ::numLanes channels at once, one channel per SIMD lane
+ *  (see PixelKernels::powerSpectrumLanes).
+ *
+ *  The caller writes each channel's samples, oldest first, into its lane of
+ *  ::getInput, then calls ::computePowerSpectrum:
+ *
+ *      for (int lane = 0; lane < numGroupChannels; ++lane)
+ *          for (int i = 0; i < fft.getSize(); ++i)
+ *              fft.getInput()[i * BatchedFFT::numLanes + lane] = samples[lane][i];
+ *
+ *      const float* power = fft.computePowerSpectrum();
+ *      // power[bin * BatchedFFT::numLanes + lane] is |X[bin]|^2 of a lane
+ *
+ *  Each instance owns its scratch, so one per thread can run at once.
+ */
+class BatchedFFT
+{
+public:
+    BatchedFFT();
+
+    static constexpr int numLanes = filterLaneCount;
+
+    /** Use the plan of size points and allocate the scratch for it */
+    void prepare(int size);
+
+    /**
+     *  Build the plans of every size up to maxSize and allocate the scratch
+     *  for the largest, so ::prepare at those sizes does not allocate
+     */
+    void reserve(int maxSize);
+
+    int getSize() const { return plan != nullptr ? plan->getSize() : 0; }
+
+    /** Number of bins of the power spectrum, size / 2 + 1 */
+    int getNumBins() const { return getSize() / 2 + 1; }
+
+    /** size samples of every lane, interleaved sample by sample ([sample][lane]) */
+    float* getInput() { return input.data(); }
+
+    /**
+     *  Window the input and return the unnormalized power |X[k]|^2 of its
+     *  bins ([bin][lane]); it stays valid until the next call
+     */
+    const float* computePowerSpectrum();
+
+private:
+    const FFTPlan* plan;
+    const PixelKernels* kernels;
+
+    std::vector<float> input;
+    std::vector<float> work;
+    std::vector<float> power;
+};
+
+}
+
+#endif /* BatchedFFT_hpp */
@@ -0,0 +1,184 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "BiquadFilterBank.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace ProbeViewer;
+
+namespace
+{
+const double pi = 3.14159265358979323846;
+
+// Q of the two sections of a 4th order Butterworth filter
+const double butterworth4thOrderQs[] = { 0.54119610, 1.30656296 };
+
+// cutoffs above this fraction of the sample rate are left out of a band
+const double maxCutoffRatio = 0.45;
+
+BiquadCoefficients normalize(double b0, double b1, double b2, double a0, double a1, double a2)
+{
+    return { float(b0 / a0), float(b1 / a0), float(b2 / a0), float(a1 / a0), float(a2 / a0) };
+}
+}
+
+#pragma mark - BiquadFilterBank -
+
+BiquadFilterBank::BiquadFilterBank()
+    : numChannels(0)
+    , kernels(&getPixelKernels())
+{ }
+
+BiquadCoefficients BiquadFilterBank::makeLowPass(double frequency, double q, double sampleRate)
+{
+    const double w0 = 2.0 * pi * frequency / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+
+    return normalize((1.0 - cosW0) / 2.0, 1.0 - cosW0, (1.0 - cosW0) / 2.0,
+                     1.0 + alpha, -2.0 * cosW0, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadFilterBank::makeHighPass(double frequency, double q, double sampleRate)
+{
+    const double w0 = 2.0 * pi * frequency / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+
+    return normalize((1.0 + cosW0) / 2.0, -(1.0 + cosW0), (1.0 + cosW0) / 2.0,
+                     1.0 + alpha, -2.0 * cosW0, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadFilterBank::makeFirstOrderHighPass(double frequency, double sampleRate)
+{
+    const double k = std::tan(pi * frequency / sampleRate);
+
+    return normalize(1.0, -1.0, 0.0, 1.0 + k, k - 1.0, 0.0);
+}
+
+std::vector<BiquadCoefficients> BiquadFilterBank::designBand(FilterBand band, float sampleRate)
+{
+    std::vector<BiquadCoefficients> bandSections;
+
+    if (sampleRate <= 0.0f)
+        return bandSections;
+
+    const double maxCutoff = maxCutoffRatio * sampleRate;
+
+    switch (band)
+    {
+        case FilterBand::AP:
+            if (300.0 < maxCutoff)
+            {
+                for (double q : butterworth4thOrderQs)
+                    bandSections.push_back(makeHighPass(300.0, q, sampleRate));
+            }
+
+            if (6000.0 < maxCutoff)
+                bandSections.push_back(makeLowPass(6000.0, std::sqrt(0.5), sampleRate));
+
+            break;
+
+        case FilterBand::LFP:
+            bandSections.push_back(makeFirstOrderHighPass(1.0, sampleRate));
+
+            if (300.0 < maxCutoff)
+            {
+                for (double q : butterworth4thOrderQs)
+                    bandSections.push_back(makeLowPass(300.0, q, sampleRate));
+            }
+
+            break;
+
+        case FilterBand::NONE:
+        default:
+            break;
+    }
+
+    return bandSections;
+}
+
+void BiquadFilterBank::prepare(int numChannels_, const std::vector<BiquadCoefficients>& sections_)
+{
+    numChannels = std::max(0, numChannels_);
+    sections = sections_;
+
+    const int numGroups = (numChannels + numLanes - 1) / numLanes;
+    state.assign(size_t(numGroups) * sections.size() * 2 * numLanes, 0.0f);
+}
+
+void BiquadFilterBank::reserve(int numChannels_, int maxNumSections)
+{
+    const int numGroups = (std::max(0, numChannels_) + numLanes - 1) / numLanes;
+
+    sections.reserve(maxNumSections);
+    state.reserve(size_t(numGroups) * maxNumSections * 2 * numLanes);
+}
+
+void BiquadFilterBank::reset()
+{
+    std::fill(state.begin(), state.end(), 0.0f);
+}
+
+template <typename SampleType>
+void BiquadFilterBank::process(int firstChannel, int numGroupChannels, const SampleType* const* inputs, const float* scales,
+                               int numSamples, float* lanes, float* const* outputs)
+{
+    assert(firstChannel % numLanes == 0 && numGroupChannels <= numLanes);
+    assert(firstChannel + numGroupChannels <= numChannels);
+    assert(numSamples <= maxTileSamples);
+
+    // unused lanes of the last group are filtered as silence
+    if (numGroupChannels < numLanes)
+        std::fill(lanes, lanes + numLanes * numSamples, 0.0f);
+
+    // both copies write sequentially and gather their reads, which
+    // measured faster than reading sequentially and scattering the writes
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float* frame = lanes + i * numLanes;
+
+        for (int lane = 0; lane < numGroupChannels; ++lane)
+            frame[lane] = inputs[lane][i] * scales[lane];
+    }
+
+    const int numSections = int(sections.size());
+    float* groupState = state.data() + size_t(firstChannel / numLanes) * numSections * 2 * numLanes;
+
+    kernels->filterBiquadLanes(sections.data(), numSections, groupState, lanes, numSamples);
+
+    for (int lane = 0; lane < numGroupChannels; ++lane)
+    {
+        float* output = outputs[lane];
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = lanes[i * numLanes + lane];
+    }
+}
+
+template void BiquadFilterBank::process<float>(int, int, const float* const*, const float*, int, float*, float* const*);
+template void BiquadFilterBank::process<int16_t>(int, int, const int16_t* const*, const float*, int, float*, float* const*);
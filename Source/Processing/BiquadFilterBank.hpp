@@ -0,0 +1,136 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef BiquadFilterBank_hpp
+#define BiquadFilterBank_hpp
+
+#include "PixelKernels.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  The band the displayed channels are filtered to before their RMS and
+ *  spike rate are reduced.
+ */
+enum class FilterBand : int
+{
+    /** Wide-band, as recorded */
+    NONE,
+
+    /** Action potentials: 300 Hz to 6 kHz */
+    AP,
+
+    /** Local field potentials: 1 Hz to 300 Hz */
+    LFP
+};
+
+constexpr int NUM_FILTER_BANDS = int(FilterBand::LFP) + 1;
+
+/**
+ *  A cascade of biquads applied to every channel of a stream, with the
+ *  filter state of each channel carried from one run of samples to the next.
+ *
+ *  Channels are filtered in groups of ::numLanes, one channel per SIMD
+ *  lane (see PixelKernels::filterBiquadLanes). A group's samples are
+ *  interleaved into a short tile, filtered in place, and copied back out
+ *  to one row per channel, so the state of a whole group is a handful of
+ *  vectors and different groups can run on different threads.
+ */
+class BiquadFilterBank
+{
+public:
+    BiquadFilterBank();
+
+    static constexpr int numLanes = filterLaneCount;
+
+    /** Longest run ::process accepts; a tile of a group fits in L1 */
+    static constexpr int maxTileSamples = 256;
+
+    /**
+     *  The sections for a band at a sample rate: a 4th order Butterworth
+     *  high-pass at 300 Hz and a 2nd order low-pass at 6 kHz for
+     *  FilterBand::AP, a 1st order high-pass at 1 Hz and a 4th order
+     *  low-pass at 300 Hz for FilterBand::LFP. Cutoffs too close to Nyquist
+     *  are left out. Empty for FilterBand::NONE.
+     */
+    static std::vector<BiquadCoefficients> designBand(FilterBand band, float sampleRate);
+
+    /** 2nd order low-pass (bilinear transform, RBJ cookbook) */
+    static BiquadCoefficients makeLowPass(double frequency, double q, double sampleRate);
+
+    /** 2nd order high-pass (bilinear transform, RBJ cookbook) */
+    static BiquadCoefficients makeHighPass(double frequency, double q, double sampleRate);
+
+    /**
+     *  1st order high-pass as a biquad. Used for very low cutoffs, where the
+     *  poles of a 2nd order section are too close to 1 for float coefficients.
+     */
+    static BiquadCoefficients makeFirstOrderHighPass(double frequency, double sampleRate);
+
+    /** Set the sections and clear the state of numChannels channels */
+    void prepare(int numChannels, const std::vector<BiquadCoefficients>& sections);
+
+    /** Allocate for numChannels channels and up to maxNumSections sections, so ::prepare within them does not */
+    void reserve(int numChannels, int maxNumSections);
+
+    /** Clear the state of every channel, as if they had been silent */
+    void reset();
+
+    /** Returns false if there are no sections, so ::process would copy */
+    bool isActive() const { return !sections.empty(); }
+
+    int getNumChannels() const { return numChannels; }
+
+    /**
+     *  Filter numSamples (at most ::maxTileSamples) samples of the channels
+     *  firstChannel..firstChannel + numGroupChannels - 1, which must lie in
+     *  one group (firstChannel a multiple of ::numLanes). Channel c is read
+     *  from inputs[c - firstChannel] multiplied by scales[c - firstChannel], and
+     *  written to outputs[c - firstChannel]. lanes is scratch for
+     *  numLanes * maxTileSamples floats.
+     *
+     *  Groups are independent, so different groups may be filtered on
+     *  different threads at once.
+     */
+    template <typename SampleType>
+    void process(int firstChannel, int numGroupChannels, const SampleType* const* inputs, const float* scales,
+                 int numSamples, float* lanes, float* const* outputs);
+
+private:
+    int numChannels;
+
+    std::vector<BiquadCoefficients> sections;
+
+    /** [group][section][2][lane], see PixelKernels::filterBiquadLanes */
+    std::vector<float> state;
+
+    const PixelKernels* kernels;
+};
+
+}
+
+#endif /* BiquadFilterBank_hpp */
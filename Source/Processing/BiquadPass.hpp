@@ -0,0 +1,100 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef BiquadPass_hpp
+#define BiquadPass_hpp
+
+#include "LaneOps.hpp"
+#include "PixelKernels.hpp"
+
+namespace ProbeViewer {
+
+// only included by the kernel files, like CrossingScan.hpp
+namespace
+{
+
+/**
+ *  Transposed direct form II, one section at a time over the whole run, so
+ *  a section's coefficients and the delays of all its lanes stay in
+ *  registers. Runs are short enough (see BiquadFilterBank) to stay in L1
+ *  between sections. Each vector of lanes is an independent recurrence,
+ *  so narrower instruction sets overlap several of them.
+ */
+template <typename Ops>
+void filterBiquadLanes(const BiquadCoefficients* sections, int numSections, float* state, float* lanes, int numSamples)
+{
+    typedef typename Ops::Vector Vector;
+
+    constexpr int numVectors = filterLaneCount / Ops::width;
+    static_assert(numVectors * Ops::width == filterLaneCount, "lanes must fill whole vectors");
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        const Vector b0 = Ops::broadcast(sections[section].b0);
+        const Vector b1 = Ops::broadcast(sections[section].b1);
+        const Vector b2 = Ops::broadcast(sections[section].b2);
+        const Vector a1 = Ops::broadcast(sections[section].a1);
+        const Vector a2 = Ops::broadcast(sections[section].a2);
+
+        float* z1State = state + section * 2 * filterLaneCount;
+        float* z2State = z1State + filterLaneCount;
+
+        Vector z1[numVectors];
+        Vector z2[numVectors];
+
+        for (int v = 0; v < numVectors; ++v)
+        {
+            z1[v] = Ops::load(z1State + v * Ops::width);
+            z2[v] = Ops::load(z2State + v * Ops::width);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = lanes + i * filterLaneCount;
+
+            for (int v = 0; v < numVectors; ++v)
+            {
+                const Vector x = Ops::load(frame + v * Ops::width);
+                const Vector y = Ops::add(Ops::mul(b0, x), z1[v]);
+
+                z1[v] = Ops::add(Ops::sub(Ops::mul(b1, x), Ops::mul(a1, y)), z2[v]);
+                z2[v] = Ops::sub(Ops::mul(b2, x), Ops::mul(a2, y));
+
+                Ops::store(frame + v * Ops::width, y);
+            }
+        }
+
+        for (int v = 0; v < numVectors; ++v)
+        {
+            Ops::store(z1State + v * Ops::width, z1[v]);
+            Ops::store(z2State + v * Ops::width, z2[v]);
+        }
+    }
+}
+
+}
+
+}
+
+#endif /* BiquadPass_hpp */
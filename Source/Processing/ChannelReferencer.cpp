@@ -0,0 +1,99 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "ChannelReferencer.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace ProbeViewer;
+
+#pragma mark - ChannelReferencer -
+
+ChannelReferencer::ChannelReferencer()
+    : numRows(0)
+    , maxBlockSamples(0)
+    , mode(int(ReferenceMode::NONE))
+    , kernels(&getPixelKernels())
+{ }
+
+bool ChannelReferencer::prepare(int numRows_, int maxBlockSamples_)
+{
+    numRows = std::max(0, numRows_);
+    maxBlockSamples = std::max(1, maxBlockSamples_);
+
+    // every row starts on a cache line, so the passes never split a line between rows
+    const size_t rowBytes = MemoryArena::getPaddedSize(size_t(maxBlockSamples) * sizeof(float));
+
+    if (!rowMemory.reserve(size_t(numRows) * rowBytes))
+    {
+        release();
+        return false;
+    }
+
+    rowMemory.rewind();
+
+    rows.resize(numRows);
+
+    for (auto& row : rows)
+        row = static_cast<float*>(rowMemory.allocate(rowBytes));
+
+    return true;
+}
+
+void ChannelReferencer::release()
+{
+    numRows = 0;
+
+    rowMemory.release();
+    std::vector<float*>().swap(rows);
+}
+
+void ChannelReferencer::setMode(ReferenceMode newMode)
+{
+    mode.store(int(newMode), std::memory_order_relaxed);
+}
+
+const float* const* ChannelReferencer::process(const float* const* sources, int numSamples, ReferenceMode blockMode)
+{
+    assert(blockMode != ReferenceMode::NONE);
+    assert(numSamples <= maxBlockSamples);
+
+    // local groups are spread evenly, so a remainder never forms a group of a few channels
+    const int numGroups = blockMode == ReferenceMode::LOCAL_MEDIAN
+        ? std::max(1, (numRows + localBlockRows / 2) / localBlockRows)
+        : 1;
+
+    const auto pass = blockMode == ReferenceMode::COMMON_AVERAGE ? kernels->subtractAverage : kernels->subtractMedian;
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        const int firstRow = group * numRows / numGroups;
+        const int endRow = (group + 1) * numRows / numGroups;
+
+        pass(sources + firstRow, rows.data() + firstRow, endRow - firstRow, numSamples);
+    }
+
+    return rows.data();
+}
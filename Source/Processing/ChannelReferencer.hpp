@@ -0,0 +1,118 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef ChannelReferencer_hpp
+#define ChannelReferencer_hpp
+
+#include "PixelKernels.hpp"
+#include "../Utilities/MemoryArena.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  What is subtracted from every channel of a stream before it is stored
+ *  and reduced, to remove noise shared across the probe (licking artifacts,
+ *  line noise) that would otherwise show as stripes across all rows.
+ */
+enum class ReferenceMode : int
+{
+    /** Channels are used as they arrive */
+    NONE,
+
+    /** Subtract the mean of all channels at each sample (CAR) */
+    COMMON_AVERAGE,
+
+    /** Subtract the median of all channels at each sample */
+    COMMON_MEDIAN,
+
+    /**
+     *  Subtract the median of blocks of about ChannelReferencer::localBlockRows
+     *  channels that are adjacent in depth
+     */
+    LOCAL_MEDIAN
+};
+
+/**
+ *  Applies a ReferenceMode to a stream's blocks on the audio thread.
+ *
+ *  The referenced samples go to scratch rows owned by this object, so the
+ *  input buffer is left as it is for the processors downstream. Blocks
+ *  longer than the scratch are referenced in parts by the caller, which
+ *  also keeps each part in cache between referencing and storing it.
+ *
+ *  Every mode costs a fixed number of passes per sample (see
+ *  ReferencePass.hpp), so 384 channels at 30 kHz stay a small fraction
+ *  of one core even for the median.
+ */
+class ChannelReferencer
+{
+public:
+    ChannelReferencer();
+
+    /** Channels per group in ReferenceMode::LOCAL_MEDIAN */
+    static constexpr int localBlockRows = 32;
+
+    /**
+     *  Allocate scratch for numRows rows of maxBlockSamples samples. Not
+     *  thread-safe; call while the audio thread is not using this object.
+     *  Returns false, holding no rows, if the memory could not be reserved.
+     */
+    bool prepare(int numRows, int maxBlockSamples);
+
+    /** Free the scratch rows */
+    void release();
+
+    /** Set the mode applied from the next block on. Any thread. */
+    void setMode(ReferenceMode mode);
+
+    ReferenceMode getMode() const { return ReferenceMode(mode.load(std::memory_order_relaxed)); }
+
+    int getMaxBlockSamples() const { return maxBlockSamples; }
+
+    /**
+     *  Reference numSamples samples (at most ::getMaxBlockSamples) of every
+     *  row, reading row r from sources[r], and return the referenced rows.
+     *  They stay valid until the next call. mode must not be NONE.
+     */
+    const float* const* process(const float* const* sources, int numSamples, ReferenceMode mode);
+
+private:
+    int numRows;
+    int maxBlockSamples;
+
+    std::atomic<int> mode;
+
+    /** Reference passes for this CPU */
+    const PixelKernels* kernels;
+
+    MemoryArena rowMemory;
+    std::vector<float*> rows;
+};
+
+}
+
+#endif /* ChannelReferencer_hpp */
@@ -0,0 +1,113 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef CrossingScan_hpp
+#define CrossingScan_hpp
+
+#include "PixelKernels.hpp"
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ProbeViewer {
+
+// only included by the kernel files; the anonymous namespace gives every
+// one of them its own copy, built for its own instruction set, and nothing
+// here calls into the standard library for the same reason
+namespace
+{
+
+/**
+ *  Finds the crossing events of one kernel call. The kernels compare whole
+ *  vectors against the threshold and hand over the result as a bit mask;
+ *  only the rare masks that contain an onset are walked bit by bit.
+ */
+struct CrossingScan
+{
+    explicit CrossingScan(const CrossingState& state)
+        : wasBelow(state.wasBelow ? 1u : 0u)
+        , lastEvent(-state.samplesSinceEvent)
+        , refractorySamples(state.refractorySamples)
+    { }
+
+    /**
+     *  Count the events among `width` consecutive samples starting at index
+     *  `first` of the run; bit j of belowMask is set if sample first + j is
+     *  below threshold.
+     */
+    int add(uint32_t belowMask, int width, int first)
+    {
+        uint32_t onsets = belowMask & ~((belowMask << 1) | wasBelow);
+        wasBelow = (belowMask >> (width - 1)) & 1u;
+
+        int events = 0;
+
+        while (onsets != 0)
+        {
+            const int index = first + countTrailingZeros(onsets);
+
+            if (index - lastEvent >= refractorySamples)
+            {
+                ++events;
+                lastEvent = index;
+            }
+
+            onsets &= onsets - 1;
+        }
+
+        return events;
+    }
+
+    /** Store the state for the next run, after a run of numSamples */
+    void finish(CrossingState& state, int numSamples) const
+    {
+        state.wasBelow = wasBelow != 0;
+        const int samplesSinceEvent = numSamples - lastEvent;
+        state.samplesSinceEvent = samplesSinceEvent < refractorySamples ? samplesSinceEvent : refractorySamples;
+    }
+
+private:
+    static int countTrailingZeros(uint32_t bits)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return int(index);
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+
+    uint32_t wasBelow;
+    int lastEvent;              // index of the last event, relative to the run
+    int refractorySamples;
+};
+
+}
+
+}
+
+#endif /* CrossingScan_hpp */
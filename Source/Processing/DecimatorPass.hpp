@@ -0,0 +1,122 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef DecimatorPass_hpp
+#define DecimatorPass_hpp
+
+#include "LaneOps.hpp"
+#include "PixelKernels.hpp"
+
+namespace ProbeViewer {
+
+// only included by the kernel files, like CrossingScan.hpp
+namespace
+{
+
+/**
+ *  A half-band FIR evaluated only at the kept samples. Its even taps other
+ *  than the centre are zero and the odd ones are symmetric, so each output
+ *  costs one multiply per pair of side taps. Every frame is a row of
+ *  lanes, so each tap is a broadcast coefficient against whole vectors of
+ *  channels, as in BiquadPass.hpp.
+ */
+template <typename Ops>
+void decimateHalfBandLanes(const float* sideTaps, int numSideTaps, const float* lanes, int numOutputs, float* output)
+{
+    typedef typename Ops::Vector Vector;
+
+    constexpr int numVectors = filterLaneCount / Ops::width;
+    static_assert(numVectors * Ops::width == filterLaneCount, "lanes must fill whole vectors");
+
+    const Vector half = Ops::broadcast(0.5f);
+
+    for (int k = 0; k < numOutputs; ++k)
+    {
+        const float* centre = lanes + (2 * k + 2 * numSideTaps - 1) * filterLaneCount;
+        Vector sum[numVectors];
+
+        for (int v = 0; v < numVectors; ++v)
+            sum[v] = Ops::mul(half, Ops::load(centre + v * Ops::width));
+
+        for (int j = 0; j < numSideTaps; ++j)
+        {
+            const Vector tap = Ops::broadcast(sideTaps[j]);
+            const float* before = centre - (2 * j + 1) * filterLaneCount;
+            const float* after = centre + (2 * j + 1) * filterLaneCount;
+
+            for (int v = 0; v < numVectors; ++v)
+            {
+                const Vector pair = Ops::add(Ops::load(before + v * Ops::width), Ops::load(after + v * Ops::width));
+                sum[v] = Ops::add(sum[v], Ops::mul(tap, pair));
+            }
+        }
+
+        for (int v = 0; v < numVectors; ++v)
+            Ops::store(output + k * filterLaneCount + v * Ops::width, sum[v]);
+    }
+}
+
+/**
+ *  A rational resampler: only the outputs are computed, each from the
+ *  one phase of the interpolation filter that lands on it, so the cost is
+ *  numTaps per output whatever the number of phases.
+ */
+template <typename Ops>
+void resampleLanes(const float* phases, int numTaps, int numPhases, int step, int phase,
+                   const float* lanes, int numOutputs, float* output)
+{
+    typedef typename Ops::Vector Vector;
+
+    constexpr int numVectors = filterLaneCount / Ops::width;
+    static_assert(numVectors * Ops::width == filterLaneCount, "lanes must fill whole vectors");
+
+    int position = phase;
+
+    for (int j = 0; j < numOutputs; ++j, position += step)
+    {
+        const float* taps = phases + (position % numPhases) * numTaps;
+        const float* frame = lanes + (position / numPhases) * filterLaneCount;
+        Vector sum[numVectors];
+
+        for (int v = 0; v < numVectors; ++v)
+            sum[v] = Ops::broadcast(0.0f);
+
+        for (int t = 0; t < numTaps; ++t, frame += filterLaneCount)
+        {
+            const Vector tap = Ops::broadcast(taps[t]);
+
+            for (int v = 0; v < numVectors; ++v)
+                sum[v] = Ops::add(sum[v], Ops::mul(tap, Ops::load(frame + v * Ops::width)));
+        }
+
+        for (int v = 0; v < numVectors; ++v)
+            Ops::store(output + j * filterLaneCount + v * Ops::width, sum[v]);
+    }
+}
+
+}
+
+}
+
+#endif /* DecimatorPass_hpp */
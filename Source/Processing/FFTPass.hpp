@@ -0,0 +1,154 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef FFTPass_hpp
+#define FFTPass_hpp
+
+#include "LaneOps.hpp"
+#include "PixelKernels.hpp"
+
+namespace ProbeViewer {
+
+// only included by the kernel files, like CrossingScan.hpp
+namespace
+{
+
+/**
+ *  The real FFT of each lane, done as a complex FFT of half the size: the
+ *  even samples are the real parts and the odd ones the imaginary parts,
+ *  and the two interleaved spectra are split apart after an iterative
+ *  radix-2 transform. Every point is a row of lanes, so each butterfly
+ *  works on whole vectors of channels with a broadcast twiddle, and the
+ *  work of a plan size is the same whatever the instruction set.
+ */
+template <typename Ops>
+void powerSpectrumLanes(const FFTPlanTables& plan, const float* lanes, float* work, float* power)
+{
+    typedef typename Ops::Vector Vector;
+
+    constexpr int numVectors = filterLaneCount / Ops::width;
+    static_assert(numVectors * Ops::width == filterLaneCount, "lanes must fill whole vectors");
+
+    const int numPoints = plan.size / 2;
+    float* re = work;
+    float* im = work + numPoints * filterLaneCount;
+
+    // windowed, in bit-reversed order for the butterflies
+    for (int point = 0; point < numPoints; ++point)
+    {
+        const int source = 2 * plan.bitReversed[point];
+        const Vector evenWindow = Ops::broadcast(plan.window[source]);
+        const Vector oddWindow = Ops::broadcast(plan.window[source + 1]);
+
+        const float* even = lanes + source * filterLaneCount;
+        const float* odd = even + filterLaneCount;
+
+        for (int v = 0; v < numVectors; ++v)
+        {
+            const int offset = point * filterLaneCount + v * Ops::width;
+
+            Ops::store(re + offset, Ops::mul(Ops::load(even + v * Ops::width), evenWindow));
+            Ops::store(im + offset, Ops::mul(Ops::load(odd + v * Ops::width), oddWindow));
+        }
+    }
+
+    for (int span = 1; span < numPoints; span *= 2)
+    {
+        // exp(-2 pi i j / (2 span)) is entry j * stride of the plan's tables
+        const int stride = numPoints / span;
+
+        for (int j = 0; j < span; ++j)
+        {
+            const Vector c = Ops::broadcast(plan.cosines[j * stride]);
+            const Vector s = Ops::broadcast(plan.sines[j * stride]);
+
+            for (int first = j; first < numPoints; first += 2 * span)
+            {
+                float* aRe = re + first * filterLaneCount;
+                float* aIm = im + first * filterLaneCount;
+                float* bRe = aRe + span * filterLaneCount;
+                float* bIm = aIm + span * filterLaneCount;
+
+                for (int v = 0; v < numVectors; ++v)
+                {
+                    const int offset = v * Ops::width;
+
+                    const Vector br = Ops::load(bRe + offset);
+                    const Vector bi = Ops::load(bIm + offset);
+
+                    // b (c - i s)
+                    const Vector tr = Ops::add(Ops::mul(br, c), Ops::mul(bi, s));
+                    const Vector ti = Ops::sub(Ops::mul(bi, c), Ops::mul(br, s));
+
+                    const Vector ar = Ops::load(aRe + offset);
+                    const Vector ai = Ops::load(aIm + offset);
+
+                    Ops::store(aRe + offset, Ops::add(ar, tr));
+                    Ops::store(aIm + offset, Ops::add(ai, ti));
+                    Ops::store(bRe + offset, Ops::sub(ar, tr));
+                    Ops::store(bIm + offset, Ops::sub(ai, ti));
+                }
+            }
+        }
+    }
+
+    // X[k] = E + exp(-2 pi i k / size) O, with E = (Z[k] + conj Z[-k]) / 2 the
+    // spectrum of the even samples and O = (Z[k] - conj Z[-k]) / 2i that of the odd ones
+    const Vector half = Ops::broadcast(0.5f);
+
+    for (int k = 0; k <= numPoints; ++k)
+    {
+        const int a = k == numPoints ? 0 : k;
+        const int b = k == 0 ? 0 : numPoints - k;
+
+        const Vector c = Ops::broadcast(plan.cosines[k]);
+        const Vector s = Ops::broadcast(plan.sines[k]);
+
+        for (int v = 0; v < numVectors; ++v)
+        {
+            const int offset = v * Ops::width;
+
+            const Vector ar = Ops::load(re + a * filterLaneCount + offset);
+            const Vector ai = Ops::load(im + a * filterLaneCount + offset);
+            const Vector br = Ops::load(re + b * filterLaneCount + offset);
+            const Vector bi = Ops::load(im + b * filterLaneCount + offset);
+
+            const Vector er = Ops::mul(Ops::add(ar, br), half);
+            const Vector ei = Ops::mul(Ops::sub(ai, bi), half);
+            const Vector odr = Ops::mul(Ops::add(ai, bi), half);
+            const Vector odi = Ops::mul(Ops::sub(br, ar), half);
+
+            const Vector xr = Ops::add(er, Ops::add(Ops::mul(c, odr), Ops::mul(s, odi)));
+            const Vector xi = Ops::add(ei, Ops::sub(Ops::mul(c, odi), Ops::mul(s, odr)));
+
+            Ops::store(power + k * filterLaneCount + offset, Ops::add(Ops::mul(xr, xr), Ops::mul(xi, xi)));
+        }
+    }
+}
+
+}
+
+}
+
+#endif /* FFTPass_hpp */
@@ -0,0 +1,68 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef LaneOps_hpp
+#define LaneOps_hpp
+
+namespace ProbeViewer {
+
+// only included by the kernel files, like CrossingScan.hpp
+namespace
+{
+
+/**
+ *  The lane operations the multi-channel passes (ReferencePass.hpp,
+ *  BiquadPass.hpp, FFTPass.hpp) are written in. Each kernel file supplies its own with
+ *  the same members; these are used for the scalar kernels and for the
+ *  samples that do not fill a whole vector.
+ */
+struct ScalarLaneOps
+{
+    typedef float Vector;
+    static constexpr int width = 1;
+
+    static Vector load(const float* p) { return *p; }
+    static void store(float* p, Vector v) { *p = v; }
+    static Vector broadcast(float v) { return v; }
+    static Vector add(Vector a, Vector b) { return a + b; }
+    static Vector sub(Vector a, Vector b) { return a - b; }
+    static Vector mul(Vector a, Vector b) { return a * b; }
+    static Vector min(Vector a, Vector b) { return a < b ? a : b; }
+    static Vector max(Vector a, Vector b) { return a > b ? a : b; }
+
+    /** count + 1 in the lanes where x <= limit */
+    static Vector countAtOrBelow(Vector count, Vector x, Vector limit) { return x <= limit ? count + 1.0f : count; }
+
+    /** ifTrue in the lanes where count >= rank, ifFalse in the others */
+    static Vector selectAtLeast(Vector count, Vector rank, Vector ifTrue, Vector ifFalse) { return count >= rank ? ifTrue : ifFalse; }
+
+    /** min(current, x) in the lanes where x >= limit, current in the others */
+    static Vector minAtOrAbove(Vector current, Vector x, Vector limit) { return (x >= limit && x < current) ? x : current; }
+};
+
+}
+
+}
+
+#endif /* LaneOps_hpp */
@@ -0,0 +1,111 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "PixelAccumulator.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace ProbeViewer;
+
+PixelAccumulator::PixelAccumulator()
+    : samplesPerPixel(1)
+    , samplesPerSegment(1)
+    , hasBaseline(false)
+{
+    stats.reset(0.0f);
+    segment.reset(0.0f);
+}
+
+void PixelAccumulator::reset(int samplesPerPixel_, int samplesPerSegment_)
+{
+    samplesPerPixel = std::max(1, samplesPerPixel_);
+    samplesPerSegment = samplesPerSegment_ > 0 ? samplesPerSegment_ : samplesPerPixel;
+    hasBaseline = false;
+
+    stats.reset(0.0f);
+    segment.reset(0.0f);
+}
+
+int PixelAccumulator::getNumSamplesToRunEnd() const
+{
+    return std::min(getNumSamplesToPixelEnd(), samplesPerSegment - segment.numSamples);
+}
+
+void PixelAccumulator::add(const PixelKernels& kernels, CrossingState& crossing, const float* samples, int numSamples)
+{
+    assert(numSamples <= getNumSamplesToRunEnd());
+
+    if (numSamples <= 0)
+        return;
+
+    if (!hasBaseline)
+    {
+        segment.baseline = samples[0];
+        hasBaseline = true;
+    }
+
+    PixelStats run;
+    run.reset(segment.baseline);
+
+    kernels.accumulate(run, crossing, samples, numSamples);
+    addRun(run);
+}
+
+void PixelAccumulator::add(const PixelKernels& kernels, CrossingState& crossing, const int16_t* samples, int numSamples, float scale)
+{
+    assert(numSamples <= getNumSamplesToRunEnd());
+
+    if (numSamples <= 0)
+        return;
+
+    if (!hasBaseline)
+    {
+        segment.baseline = samples[0] * scale;
+        hasBaseline = true;
+    }
+
+    PixelStats run;
+    run.reset(segment.baseline);
+
+    kernels.accumulateInt16(run, crossing, samples, numSamples, scale);
+    addRun(run);
+}
+
+void PixelAccumulator::addRun(const PixelStats& run)
+{
+    segment.add(run);
+    stats.add(run);
+}
+
+void PixelAccumulator::startNextPixel()
+{
+    // the next run brings the current segment baseline along
+    stats.reset(0.0f);
+}
+
+void PixelAccumulator::startNextSegment()
+{
+    segment.reset(segment.getMidpoint());
+}
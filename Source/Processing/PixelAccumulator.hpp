@@ -0,0 +1,120 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef PixelAccumulator_hpp
+#define PixelAccumulator_hpp
+
+#include "PixelKernels.hpp"
+
+namespace ProbeViewer {
+
+/**
+ *  Streams one channel's samples into pixels of samplesPerPixel samples.
+ *
+ *  The pixel in progress is carried from one call to the next as running
+ *  statistics, so a pixel that straddles two refreshes (or the wrap of the
+ *  ring) is never cached or read twice.
+ *
+ *  Sums and crossings are taken relative to a baseline that moves once per
+ *  segment of samplesPerSegment samples, to the midpoint of the segment
+ *  before, and the caller adapts its SpikeDetector over the same segments.
+ *  By default a segment is a pixel, as in PixelColumnReducer; a display at
+ *  another zoom keeps the default pixel as its segment, so its crossings
+ *  are counted against the same baseline and threshold.
+ *
+ *  The caller splits its runs at pixel and segment boundaries:
+ *
+ *      while (pos < numSamples)
+ *      {
+ *          const int n = std::min(numSamples - pos, acc.getNumSamplesToRunEnd());
+ *          acc.add(kernels, detector.getCrossingState(), samples + pos, n);
+ *          pos += n;
+ *
+ *          if (acc.isSegmentComplete())
+ *          {
+ *              detector.update(acc.getSegmentStats(), thresholdFactor);
+ *              acc.startNextSegment();
+ *          }
+ *
+ *          if (acc.isPixelComplete())
+ *          {
+ *              draw(acc.getStats());
+ *              acc.startNextPixel();
+ *          }
+ *      }
+ */
+class PixelAccumulator
+{
+public:
+    PixelAccumulator();
+
+    /**
+     *  Drop the pixel and segment in progress and the baseline, and set the
+     *  pixel size and the segment size (the pixel size if 0)
+     */
+    void reset(int samplesPerPixel, int samplesPerSegment = 0);
+
+    int getSamplesPerPixel() const { return samplesPerPixel; }
+
+    /** Number of samples that complete the pixel in progress */
+    int getNumSamplesToPixelEnd() const { return samplesPerPixel - stats.numSamples; }
+
+    /** The longest run ::add takes: to the end of the pixel or of the segment, whichever comes first */
+    int getNumSamplesToRunEnd() const;
+
+    /** Fold a run into the pixel in progress; the run must not be longer than ::getNumSamplesToRunEnd */
+    void add(const PixelKernels& kernels, CrossingState& crossing, const float* samples, int numSamples);
+
+    /** Fold a run of int16 samples, scaled to floats, into the pixel in progress */
+    void add(const PixelKernels& kernels, CrossingState& crossing, const int16_t* samples, int numSamples, float scale);
+
+    bool isPixelComplete() const { return stats.numSamples == samplesPerPixel; }
+
+    bool isSegmentComplete() const { return segment.numSamples == samplesPerSegment; }
+
+    /** The pixel in progress */
+    const PixelStats& getStats() const { return stats; }
+
+    /** The segment in progress, which the spike detector adapts to */
+    const PixelStats& getSegmentStats() const { return segment; }
+
+    void startNextPixel();
+
+    /** Start the next segment relative to the midpoint of the completed one */
+    void startNextSegment();
+
+private:
+    /** Fold a run reduced relative to the segment baseline into the pixel and segment */
+    void addRun(const PixelStats& run);
+
+    PixelStats stats;
+    PixelStats segment;
+    int samplesPerPixel;
+    int samplesPerSegment;
+    bool hasBaseline;
+};
+
+}
+
+#endif /* PixelAccumulator_hpp */
@@ -0,0 +1,265 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "PixelColumnReducer.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace ProbeViewer;
+
+#pragma mark - PixelColumnReducer -
+
+PixelColumnReducer::PixelColumnReducer()
+    : numChannels(0)
+    , samplesPerPixel(0)
+    , maxDecimatedPerColumn(0)
+    , spikeThresholdFactor(4.5f)
+    , kernels(&getPixelKernels())
+    , pixelPhase(0)
+    , blockThresholdFactor(4.5f)
+    , blockColumns(0)
+    , columns(nullptr)
+    , decimated(nullptr)
+{ }
+
+bool PixelColumnReducer::prepare(int numChannels_, int samplesPerPixel_, double sampleRate, double spectralSampleRate,
+                                 int columnCapacity, int refractorySamples)
+{
+    numChannels = std::max(0, numChannels_);
+    samplesPerPixel = std::max(1, samplesPerPixel_);
+
+    decimator.prepare(numChannels, sampleRate, spectralSampleRate);
+    maxDecimatedPerColumn = decimator.getMaxNumOutputs(samplesPerPixel);
+
+    decimatorScratch.assign(decimator.getScratchSize(), 0.0f);
+    decimatorOutput.assign(size_t(maxDecimatedPerColumn) * SpectralDecimator::numLanes, 0.0f);
+
+    pixelPhase = 0;
+    blockColumns = 0;
+
+    accumulators.assign(numChannels, Accumulator());
+
+    for (auto& acc : accumulators)
+    {
+        acc.hasBaseline = false;
+        acc.detector.reset(refractorySamples);
+        resetAccumulator(acc, 0.0f);
+    }
+
+    pendingDecimated.assign(size_t(numChannels) * maxDecimatedPerColumn, 0.0f);
+
+    // columns are only read after they are written, so the arena is not cleared
+    const size_t numColumnStats = size_t(columnCapacity) * numChannels;
+    const size_t numDecimated = numColumnStats * maxDecimatedPerColumn;
+
+    if (!columnMemory.reserve(MemoryArena::getPaddedSize(numColumnStats * sizeof(PixelStats))
+                              + MemoryArena::getPaddedSize(numDecimated * sizeof(float))))
+    {
+        release();
+        return false;
+    }
+
+    columnMemory.rewind();
+
+    columns = columnMemory.allocateArray<PixelStats>(numColumnStats);
+    decimated = columnMemory.allocateArray<float>(numDecimated);
+    decimatedCount.assign(columnCapacity, 0);
+
+    cursor.reset(columnCapacity);
+
+    return true;
+}
+
+void PixelColumnReducer::release()
+{
+    numChannels = 0;
+
+    // swap with empty vectors so the memory is actually returned
+    std::vector<Accumulator>().swap(accumulators);
+    std::vector<float>().swap(pendingDecimated);
+    std::vector<float>().swap(decimatorScratch);
+    std::vector<float>().swap(decimatorOutput);
+    decimator.prepare(0, 0.0, 0.0);
+    columnMemory.release();
+    columns = nullptr;
+    decimated = nullptr;
+    std::vector<int>().swap(decimatedCount);
+
+    cursor.reset(0);
+}
+
+void PixelColumnReducer::setSpikeThresholdFactor(float thresholdFactor)
+{
+    spikeThresholdFactor.store(thresholdFactor, std::memory_order_relaxed);
+}
+
+void PixelColumnReducer::resetAccumulator(Accumulator& acc, float baseline)
+{
+    acc.stats.reset(baseline);
+    acc.numDecimated = 0;
+}
+
+void PixelColumnReducer::beginBlock(int numSamples)
+{
+    blockThresholdFactor = spikeThresholdFactor.load(std::memory_order_relaxed);
+    blockColumns = (pixelPhase + numSamples) / samplesPerPixel;
+
+    cursor.beginWrite(blockColumns);
+}
+
+void PixelColumnReducer::addChannelGroup(int firstChannel, int numGroupChannels, const float* const* rows, int numSamples)
+{
+    const int numLanes = SpectralDecimator::numLanes;
+    assert(firstChannel % numLanes == 0 && numGroupChannels <= numLanes);
+
+    // a null row is decimated as silence, read from a row that is there
+    const float* fallback = nullptr;
+
+    for (int lane = 0; lane < numGroupChannels && fallback == nullptr; ++lane)
+        fallback = rows[lane];
+
+    if (fallback == nullptr || numSamples <= 0)
+        return;
+
+    const float* sources[numLanes];
+    float scales[numLanes];
+
+    for (int lane = 0; lane < numGroupChannels; ++lane)
+    {
+        sources[lane] = rows[lane] != nullptr ? rows[lane] : fallback;
+        scales[lane] = rows[lane] != nullptr ? 1.0f : 0.0f;
+
+        Accumulator& acc = accumulators[firstChannel + lane];
+
+        if (rows[lane] != nullptr && !acc.hasBaseline)
+        {
+            acc.stats.baseline = rows[lane][0];
+            acc.hasBaseline = true;
+        }
+    }
+
+    int64_t column = cursor.getWritePosition();
+    int phase = pixelPhase;
+    int pos = 0;
+
+    while (pos < numSamples)
+    {
+        const int segmentSize = std::min(numSamples - pos, samplesPerPixel - phase);
+
+        for (int lane = 0; lane < numGroupChannels; ++lane)
+        {
+            if (rows[lane] != nullptr)
+            {
+                Accumulator& acc = accumulators[firstChannel + lane];
+                kernels->accumulate(acc.stats, acc.detector.getCrossingState(), rows[lane] + pos, segmentSize);
+            }
+        }
+
+        // the decimated samples go with the pixel the segment belongs to
+        const float* segmentSources[numLanes];
+
+        for (int lane = 0; lane < numGroupChannels; ++lane)
+            segmentSources[lane] = sources[lane] + pos;
+
+        const int numDecimated = decimator.process(firstChannel, numGroupChannels, segmentSources, scales, segmentSize,
+                                                   decimatorScratch.data(), decimatorOutput.data());
+
+        for (int lane = 0; lane < numGroupChannels; ++lane)
+        {
+            Accumulator& acc = accumulators[firstChannel + lane];
+            float* pending = pendingDecimated.data() + size_t(firstChannel + lane) * maxDecimatedPerColumn;
+
+            for (int i = 0; i < numDecimated && acc.numDecimated < maxDecimatedPerColumn; ++i)
+                pending[acc.numDecimated++] = decimatorOutput[i * numLanes + lane];
+        }
+
+        phase += segmentSize;
+        pos += segmentSize;
+
+        if (phase == samplesPerPixel)
+        {
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+            {
+                if (rows[lane] != nullptr)
+                    completeColumn(firstChannel + lane, accumulators[firstChannel + lane], column);
+            }
+
+            ++column;
+            phase = 0;
+        }
+    }
+}
+
+void PixelColumnReducer::completeColumn(int channel, Accumulator& acc, int64_t position)
+{
+    const int slot = cursor.getIndexForPosition(position);
+    const size_t offset = size_t(slot) * numChannels + channel;
+
+    columns[offset] = acc.stats;
+
+    const float* pending = pendingDecimated.data() + size_t(channel) * maxDecimatedPerColumn;
+    std::copy(pending, pending + acc.numDecimated, decimated + offset * maxDecimatedPerColumn);
+
+    // every group of the decimator sees the same samples, so every
+    // channel writes the same count here
+    decimatedCount[slot] = acc.numDecimated;
+
+    acc.detector.update(acc.stats, blockThresholdFactor);
+
+    resetAccumulator(acc, acc.stats.getMidpoint());
+}
+
+void PixelColumnReducer::finishBlock(int numSamples)
+{
+    cursor.endWrite(blockColumns);
+
+    pixelPhase = (pixelPhase + numSamples) % samplesPerPixel;
+    blockColumns = 0;
+}
+
+const PixelStats& PixelColumnReducer::getColumn(int64_t position, int channel) const
+{
+    const int slot = cursor.getIndexForPosition(position);
+    return columns[size_t(slot) * numChannels + channel];
+}
+
+int PixelColumnReducer::getNumDecimatedSamples(int64_t position) const
+{
+    return decimatedCount[cursor.getIndexForPosition(position)];
+}
+
+const float* PixelColumnReducer::getDecimatedSamples(int64_t position, int channel) const
+{
+    const int slot = cursor.getIndexForPosition(position);
+    return decimated + (size_t(slot) * numChannels + channel) * maxDecimatedPerColumn;
+}
+
+size_t PixelColumnReducer::getMemoryFootprint() const
+{
+    return columnMemory.getCapacity()
+           + decimatedCount.capacity() * sizeof(int)
+           + accumulators.capacity() * sizeof(Accumulator)
+           + pendingDecimated.capacity() * sizeof(float)
+           + (decimatorScratch.capacity() + decimatorOutput.capacity()) * sizeof(float);
+}
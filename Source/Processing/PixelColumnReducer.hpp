@@ -0,0 +1,164 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef PixelColumnReducer_hpp
+#define PixelColumnReducer_hpp
+
+#include "PixelKernels.hpp"
+#include "SpectralDecimator.hpp"
+#include "SpikeDetector.hpp"
+#include "../Utilities/MemoryArena.hpp"
+#include "../Utilities/RingBufferCursor.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  Folds incoming blocks straight into per-channel pixel accumulators and
+ *  keeps only completed pixel columns, instead of every raw sample.
+ *
+ *  The audio thread calls ::beginBlock, then ::addChannelGroup for every
+ *  group of channels of the block, then ::finishBlock, which publishes the
+ *  completed columns. The message thread reads them with ::beginRead /
+ *  ::getColumn / ::endRead.
+ *
+ *  Alongside the statistics, the samples are decimated to the band power
+ *  rate by a SpectralDecimator and kept with their column, offset and all,
+ *  so the band power path still has input.
+ */
+class PixelColumnReducer
+{
+public:
+    PixelColumnReducer();
+
+    /**
+     *  Allocate accumulators and storage for `columnCapacity` columns and
+     *  rewind everything. Not thread-safe; call while the audio thread is
+     *  not feeding this object. Returns false, holding no storage, if the
+     *  columns could not be reserved.
+     */
+    bool prepare(int numChannels, int samplesPerPixel, double sampleRate, double spectralSampleRate,
+                 int columnCapacity, int refractorySamples);
+
+    /** Free all storage. */
+    void release();
+
+    /** Returns true if ::prepare was called with a non-empty layout */
+    bool isPrepared() const { return numChannels > 0 && samplesPerPixel > 0; }
+
+    /** Set the spike threshold in noise standard deviations. Any thread. */
+    void setSpikeThresholdFactor(float thresholdFactor);
+
+    // WRITER SIDE (audio thread)
+
+    /** Start a block of numSamples; must precede the ::addChannelGroup calls for it. */
+    void beginBlock(int numSamples);
+
+    /**
+     *  Fold the samples of the channels firstChannel..firstChannel +
+     *  numGroupChannels - 1 for the current block into their accumulators
+     *  and decimate them. The channels lie in one group of the decimator
+     *  (firstChannel a multiple of SpectralDecimator::numLanes); null rows
+     *  are skipped.
+     */
+    void addChannelGroup(int firstChannel, int numGroupChannels, const float* const* rows, int numSamples);
+
+    /** Advance the shared pixel position and publish the completed columns. */
+    void finishBlock(int numSamples);
+
+    // READER SIDE (message thread)
+
+    bool hasColumnsReady() const { return cursor.hasItemsReady(); }
+
+    RingBufferCursor::Range beginRead() { return cursor.beginRead(); }
+
+    bool endRead(const RingBufferCursor::Range& range) { return cursor.endRead(range); }
+
+    void skipToEnd() { cursor.skipToEnd(); }
+
+    /** Return the statistics of one channel in a column within a read range */
+    const PixelStats& getColumn(int64_t position, int channel) const;
+
+    /** Number of decimated samples stored for the column at this position */
+    int getNumDecimatedSamples(int64_t position) const;
+
+    /** Pointer to the decimated samples of one channel in a column */
+    const float* getDecimatedSamples(int64_t position, int channel) const;
+
+    int getNumChannels() const { return numChannels; }
+    int getSamplesPerPixel() const { return samplesPerPixel; }
+    int getMaxDecimatedPerColumn() const { return maxDecimatedPerColumn; }
+
+    /** The rate of the decimated samples */
+    double getSpectralSampleRate() const { return decimator.getOutputRate(); }
+
+    /** Bytes held by this reducer, for comparison with raw sample storage */
+    size_t getMemoryFootprint() const;
+
+private:
+    struct Accumulator
+    {
+        PixelStats stats;
+        SpikeDetector detector;
+        int numDecimated;
+        bool hasBaseline;
+    };
+
+    void resetAccumulator(Accumulator& acc, float baseline);
+    void completeColumn(int channel, Accumulator& acc, int64_t position);
+
+    int numChannels;
+    int samplesPerPixel;
+    int maxDecimatedPerColumn;
+
+    std::atomic<float> spikeThresholdFactor;
+
+    /** Single-pass reduction for this CPU */
+    const PixelKernels* kernels;
+
+    // writer state, shared by every channel of a stream
+    int pixelPhase;         // samples already accumulated in the current pixel
+    float blockThresholdFactor;     // latched for the block in progress
+    int blockColumns;       // columns completed by the block in progress
+
+    std::vector<Accumulator> accumulators;
+    std::vector<float> pendingDecimated;   // numChannels x maxDecimatedPerColumn
+
+    SpectralDecimator decimator;
+    std::vector<float> decimatorScratch;
+    std::vector<float> decimatorOutput;    // a pixel of a group, [sample][lane]
+
+    // completed columns
+    RingBufferCursor cursor;
+    MemoryArena columnMemory;              // reused by every ::prepare
+    PixelStats* columns;                   // capacity x numChannels
+    float* decimated;                      // capacity x numChannels x maxDecimatedPerColumn
+    std::vector<int> decimatedCount;       // capacity
+};
+
+}
+
+#endif /* PixelColumnReducer_hpp */
@@ -0,0 +1,235 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "PixelKernels.hpp"
+#include "CrossingScan.hpp"
+#include "ReferencePass.hpp"
+#include "BiquadPass.hpp"
+#include "FFTPass.hpp"
+#include "DecimatorPass.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+using namespace ProbeViewer;
+
+#pragma mark - PixelStats -
+
+void PixelStats::reset(float baseline_)
+{
+    min = std::numeric_limits<float>::max();
+    max = std::numeric_limits<float>::lowest();
+    sum = 0.0f;
+    sumSquares = 0.0f;
+    baseline = baseline_;
+    crossings = 0;
+    numAboveNoiseLevel = 0;
+    numSamples = 0;
+}
+
+void PixelStats::add(const PixelStats& next)
+{
+    if (next.numSamples == 0)
+        return;
+
+    if (numSamples == 0)
+    {
+        *this = next;
+        return;
+    }
+
+    // sum((x - b)^2) = sum((x - b')^2) + 2 d sum(x - b') + n d^2, with d = b' - b
+    const float shift = next.baseline - baseline;
+
+    sumSquares += next.sumSquares + 2.0f * shift * next.sum + float(next.numSamples) * shift * shift;
+    sum += next.sum + float(next.numSamples) * shift;
+    min = std::min(min, next.min);
+    max = std::max(max, next.max);
+    crossings += next.crossings;
+    numAboveNoiseLevel += next.numAboveNoiseLevel;
+    numSamples += next.numSamples;
+}
+
+float PixelStats::getRMS() const
+{
+    if (numSamples == 0)
+        return 0.0f;
+
+    // mean((x - m)^2) expanded around the baseline the sums were taken from
+    const float offset = getMidpoint() - baseline;
+    const float meanSquare = sumSquares / numSamples
+                             - 2.0f * offset * sum / numSamples
+                             + offset * offset;
+
+    return sqrtf(std::max(0.0f, meanSquare));
+}
+
+#pragma mark - Scalar kernels -
+
+namespace
+{
+template <typename SampleType>
+void accumulateScalar(PixelStats& stats, CrossingState& crossing, const SampleType* samples, int numSamples, float scale)
+{
+    const float baseline = stats.baseline;
+    const float threshold = crossing.threshold;
+    const float noiseLevel = crossing.noiseLevel;
+
+    float min = stats.min;
+    float max = stats.max;
+    float sum = stats.sum;
+    float sumSquares = stats.sumSquares;
+    int crossings = stats.crossings;
+    int numAboveNoiseLevel = stats.numAboveNoiseLevel;
+
+    CrossingScan scan(crossing);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float val = samples[i] * scale;
+        const float offsetVal = val - baseline;
+
+        min = std::min(min, val);
+        max = std::max(max, val);
+        sum += offsetVal;
+        sumSquares += offsetVal * offsetVal;
+        numAboveNoiseLevel += (std::fabs(offsetVal) > noiseLevel);
+        crossings += scan.add(offsetVal < threshold, 1, i);
+    }
+
+    scan.finish(crossing, numSamples);
+
+    stats.min = min;
+    stats.max = max;
+    stats.sum = sum;
+    stats.sumSquares = sumSquares;
+    stats.crossings = crossings;
+    stats.numAboveNoiseLevel = numAboveNoiseLevel;
+    stats.numSamples += numSamples;
+}
+
+void accumulateFloat(PixelStats& stats, CrossingState& crossing, const float* samples, int numSamples)
+{
+    accumulateScalar(stats, crossing, samples, numSamples, 1.0f);
+}
+
+void accumulateInt16(PixelStats& stats, CrossingState& crossing, const int16_t* samples, int numSamples, float scale)
+{
+    accumulateScalar(stats, crossing, samples, numSamples, scale);
+}
+
+const PixelKernels scalarKernels = { "scalar", accumulateFloat, accumulateInt16,
+                                     subtractAverage<ScalarLaneOps>, subtractMedian<ScalarLaneOps>,
+                                     filterBiquadLanes<ScalarLaneOps>,
+                                     powerSpectrumLanes<ScalarLaneOps>,
+                                     decimateHalfBandLanes<ScalarLaneOps>, resampleLanes<ScalarLaneOps> };
+
+#pragma mark - CPU detection -
+
+struct CpuFeatures
+{
+    bool sse41 = false;
+    bool avx2 = false;
+    bool avx512 = false;
+};
+
+CpuFeatures detectCpuFeatures()
+{
+    CpuFeatures features;
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // these also check that the OS saves the wider registers
+    __builtin_cpu_init();
+    features.sse41 = __builtin_cpu_supports("sse4.1");
+    features.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    features.avx512 = __builtin_cpu_supports("avx512f");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool hasFma = (info[2] & (1 << 12)) != 0;
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    features.sse41 = (info[2] & (1 << 19)) != 0;
+
+    // the OS must save the ymm (and zmm) state across context switches
+    const unsigned long long xcr0 = hasOsxsave ? _xgetbv(0) : 0;
+    const bool ymmEnabled = (xcr0 & 0x06) == 0x06;
+    const bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2 = ymmEnabled && hasFma && (info[1] & (1 << 5)) != 0;
+        features.avx512 = zmmEnabled && (info[1] & (1 << 16)) != 0;
+    }
+#endif
+
+    return features;
+}
+
+const PixelKernels& selectPixelKernels()
+{
+    // NEON is part of the baseline on 64-bit ARM, so it needs no check
+    if (const PixelKernels* neon = getNEONPixelKernels())
+        return *neon;
+
+    const CpuFeatures features = detectCpuFeatures();
+
+    const PixelKernels* avx512 = getAVX512PixelKernels();
+    const PixelKernels* avx2 = getAVX2PixelKernels();
+    const PixelKernels* sse41 = getSSE41PixelKernels();
+
+    if (features.avx512 && avx512 != nullptr)
+        return *avx512;
+
+    if (features.avx2 && avx2 != nullptr)
+        return *avx2;
+
+    if (features.sse41 && sse41 != nullptr)
+        return *sse41;
+
+    return scalarKernels;
+}
+}
+
+#pragma mark - Dispatch -
+
+const PixelKernels& ProbeViewer::getPixelKernels()
+{
+    static const PixelKernels& kernels = selectPixelKernels();
+    return kernels;
+}
+
+const PixelKernels* ProbeViewer::getScalarPixelKernels()
+{
+    return &scalarKernels;
+}
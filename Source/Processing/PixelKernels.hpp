@@ -0,0 +1,200 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef PixelKernels_hpp
+#define PixelKernels_hpp
+
+#include <cstdint>
+
+namespace ProbeViewer {
+
+/**
+ *  Summary of the samples of one channel that fall into one pixel column.
+ *
+ *  Sums are taken relative to `baseline` (the midpoint of the channel's
+ *  previous pixel) so that a large DC offset does not eat the precision of
+ *  the float accumulators, and so that crossings can be counted in the same
+ *  pass that finds the pixel's own midpoint.
+ */
+struct PixelStats
+{
+    float min;
+    float max;
+    float sum;          // sum of (x - baseline)
+    float sumSquares;   // sum of (x - baseline)^2
+    float baseline;
+    int crossings;      // threshold crossing events, see CrossingState
+    int numAboveNoiseLevel;     // samples further than CrossingState::noiseLevel from baseline
+    int numSamples;
+
+    /** Empty the statistics, taking the next sums relative to baseline */
+    void reset(float baseline);
+
+    /**
+     *  Fold in the statistics of the samples that follow these, moving
+     *  their sums onto this baseline if they were taken from another one
+     */
+    void add(const PixelStats& next);
+
+    /** Midpoint between min and max, used as the DC reference of a pixel */
+    float getMidpoint() const { return (max + min) / 2.0f; }
+
+    /**
+     *  RMS of the samples around the pixel midpoint, identical to reducing
+     *  the raw samples with the midpoint subtracted.
+     */
+    float getRMS() const;
+};
+
+/**
+ *  Per-channel state of the spike detection done by the kernels, carried
+ *  from one run (and pixel) to the next. The levels are set by a
+ *  SpikeDetector.
+ *
+ *  A crossing event is a sample more than `threshold` below the pixel
+ *  baseline whose predecessor was not, at least refractorySamples after
+ *  the previous event, so a spike is counted once however long it lasts.
+ */
+struct CrossingState
+{
+    float threshold;            // relative to the pixel baseline, negative
+    float noiseLevel;           // deviation from the baseline counted in PixelStats::numAboveNoiseLevel
+    int refractorySamples;
+    int samplesSinceEvent;      // saturates at refractorySamples
+    bool wasBelow;              // the last sample was below threshold
+};
+
+/**
+ *  One second-order IIR section, normalized so a0 = 1:
+ *  y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ */
+struct BiquadCoefficients
+{
+    float b0, b1, b2;
+    float a1, a2;
+};
+
+/** Channels filtered together by PixelKernels::filterBiquadLanes, one per SIMD lane */
+const int filterLaneCount = 16;
+
+/**
+ *  Precomputed tables of a real FFT of `size` points, a power of two of at
+ *  least 4, for PixelKernels::powerSpectrumLanes (see FFTPlan)
+ */
+struct FFTPlanTables
+{
+    int size;
+    const float* window;        // size points, applied to the input
+    const int* bitReversed;     // size / 2: the bit-reversed index of each complex point
+    const float* cosines;       // size / 2 + 1: cos(2 pi k / size)
+    const float* sines;         // size / 2 + 1: sin(2 pi k / size)
+};
+
+/**
+ *  Single-pass kernels that fold a contiguous run of samples into a
+ *  PixelStats: min, max, sum, sum of squares, the noise level count and
+ *  crossing events at once. Alongside them are the passes that reference
+ *  a group of channels (see ChannelReferencer) or filter them (see
+ *  BiquadFilterBank) before they are reduced, the FFT that takes the
+ *  band power of a group (see BatchedFFT) and the filters that decimate
+ *  its input (see SpectralDecimator).
+ *
+ *  There is one set per instruction set, each in its own translation unit
+ *  built with that instruction set enabled (see CMakeLists.txt), and
+ *  ::getPixelKernels picks the widest one the CPU supports.
+ */
+struct PixelKernels
+{
+    /** Instruction set of the kernels, for logging and benchmarks */
+    const char* name;
+
+    /** Fold float samples into stats, detecting crossings with the given state */
+    void (*accumulate)(PixelStats& stats, CrossingState& crossing, const float* samples, int numSamples);
+
+    /** Fold int16 samples into stats after scaling them to floats */
+    void (*accumulateInt16)(PixelStats& stats, CrossingState& crossing, const int16_t* samples, int numSamples, float scale);
+
+    /**
+     *  Write sources[row][i] minus the mean of sources[0..numRows)[i] to
+     *  dests[row][i], for each of numSamples samples. dests may be sources.
+     */
+    void (*subtractAverage)(const float* const* sources, float* const* dests, int numRows, int numSamples);
+
+    /** As subtractAverage, with the median across rows (see ReferencePass.hpp) */
+    void (*subtractMedian)(const float* const* sources, float* const* dests, int numRows, int numSamples);
+
+    /**
+     *  Run filterLaneCount channels through a cascade of numSections
+     *  biquads, in place. lanes holds the channels interleaved sample by
+     *  sample ([sample][lane]); state holds the two delays of every
+     *  section and lane ([section][2][lane]) and carries over to the next call.
+     */
+    void (*filterBiquadLanes)(const BiquadCoefficients* sections, int numSections, float* state, float* lanes, int numSamples);
+
+    /**
+     *  Window and transform filterLaneCount channels of plan.size real
+     *  samples, interleaved sample by sample ([sample][lane]) in lanes, and
+     *  write the power |X[k]|^2 of bins 0..size / 2 to power ([bin][lane]).
+     *  work is scratch for size * filterLaneCount floats. The transform is
+     *  unnormalized, like kiss_fftr.
+     */
+    void (*powerSpectrumLanes)(const FFTPlanTables& plan, const float* lanes, float* work, float* power);
+
+    /**
+     *  Halve the rate of filterLaneCount channels with a half-band FIR of
+     *  4 * numSideTaps - 1 taps: a centre tap of 0.5 and sideTaps[j] at
+     *  2j + 1 samples either side of it. Output k is centred on frame
+     *  2k + 2 * numSideTaps - 1 of lanes ([sample][lane]), so the input
+     *  holds 2 * numOutputs + 4 * numSideTaps - 3 frames; output is
+     *  [sample][lane] too (see SpectralDecimator).
+     */
+    void (*decimateHalfBandLanes)(const float* sideTaps, int numSideTaps, const float* lanes, int numOutputs, float* output);
+
+    /**
+     *  Resample filterLaneCount channels by numPhases / step with a
+     *  polyphase FIR of numTaps taps per phase (phases, [phase][tap], each
+     *  row applied to its frames oldest first). Output j starts at frame
+     *  (phase + j * step) / numPhases of lanes and uses phase
+     *  (phase + j * step) % numPhases; lanes and output are [sample][lane].
+     */
+    void (*resampleLanes)(const float* phases, int numTaps, int numPhases, int step, int phase,
+                          const float* lanes, int numOutputs, float* output);
+};
+
+/** The widest kernels this CPU supports, selected on first use */
+const PixelKernels& getPixelKernels();
+
+/**
+ *  The kernels of one instruction set, or nullptr if they were not built
+ *  for this target. These do not check the CPU; use ::getPixelKernels.
+ */
+const PixelKernels* getScalarPixelKernels();
+const PixelKernels* getSSE41PixelKernels();
+const PixelKernels* getAVX2PixelKernels();
+const PixelKernels* getAVX512PixelKernels();
+const PixelKernels* getNEONPixelKernels();
+
+}
+
+#endif /* PixelKernels_hpp */
@@ -0,0 +1,214 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "PixelKernels.hpp"
+#include "CrossingScan.hpp"
+#include "ReferencePass.hpp"
+#include "BiquadPass.hpp"
+#include "FFTPass.hpp"
+#include "DecimatorPass.hpp"
+
+// built with AVX2 and FMA enabled; see CMakeLists.txt
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+using namespace ProbeViewer;
+
+namespace
+{
+// everything here has internal linkage, so no AVX2 code can be picked up by
+// the linker in place of an inline function shared with the rest of the plugin
+
+float horizontalMin(__m256 v)
+{
+    __m128 m = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+float horizontalMax(__m256 v)
+{
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+float horizontalSum(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+int horizontalSum(__m256i v)
+{
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+/** Eight samples at a time, then the tail one by one; load(i) returns samples i..i+7 as floats */
+template <typename Load, typename LoadOne>
+void accumulateVectors(PixelStats& stats, CrossingState& crossing, int numSamples, Load load, LoadOne loadOne)
+{
+    const __m256 baseline = _mm256_set1_ps(stats.baseline);
+    const __m256 limit = _mm256_set1_ps(crossing.threshold);
+    const __m256 noiseLevel = _mm256_set1_ps(crossing.noiseLevel);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    __m256 min = _mm256_set1_ps(stats.min);
+    __m256 max = _mm256_set1_ps(stats.max);
+    __m256 sum = _mm256_setzero_ps();
+    __m256 sumSquares = _mm256_setzero_ps();
+    __m256i aboveNoiseLevel = _mm256_setzero_si256();
+
+    CrossingScan scan(crossing);
+    int numCrossings = stats.crossings;
+
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m256 val = load(i);
+        const __m256 offsetVal = _mm256_sub_ps(val, baseline);
+
+        min = _mm256_min_ps(min, val);
+        max = _mm256_max_ps(max, val);
+        sum = _mm256_add_ps(sum, offsetVal);
+        sumSquares = _mm256_fmadd_ps(offsetVal, offsetVal, sumSquares);
+
+        // a true comparison is all ones, i.e. -1
+        const __m256 isAboveNoiseLevel = _mm256_cmp_ps(_mm256_and_ps(offsetVal, absMask), noiseLevel, _CMP_GT_OQ);
+        aboveNoiseLevel = _mm256_sub_epi32(aboveNoiseLevel, _mm256_castps_si256(isAboveNoiseLevel));
+
+        const int isBelow = _mm256_movemask_ps(_mm256_cmp_ps(offsetVal, limit, _CMP_LT_OQ));
+        numCrossings += scan.add(uint32_t(isBelow), 8, i);
+    }
+
+    float minValue = horizontalMin(min);
+    float maxValue = horizontalMax(max);
+    float sumValue = stats.sum + horizontalSum(sum);
+    float sumSquaresValue = stats.sumSquares + horizontalSum(sumSquares);
+    int numAboveNoiseLevel = stats.numAboveNoiseLevel + horizontalSum(aboveNoiseLevel);
+
+    for (; i < numSamples; ++i)
+    {
+        const float val = loadOne(i);
+        const float offsetVal = val - stats.baseline;
+
+        minValue = val < minValue ? val : minValue;
+        maxValue = val > maxValue ? val : maxValue;
+        sumValue += offsetVal;
+        sumSquaresValue += offsetVal * offsetVal;
+        numAboveNoiseLevel += ((offsetVal < 0.0f ? -offsetVal : offsetVal) > crossing.noiseLevel);
+        numCrossings += scan.add(offsetVal < crossing.threshold, 1, i);
+    }
+
+    scan.finish(crossing, numSamples);
+
+    stats.min = minValue;
+    stats.max = maxValue;
+    stats.sum = sumValue;
+    stats.sumSquares = sumSquaresValue;
+    stats.crossings = numCrossings;
+    stats.numAboveNoiseLevel = numAboveNoiseLevel;
+    stats.numSamples += numSamples;
+}
+
+void accumulateFloat(PixelStats& stats, CrossingState& crossing, const float* samples, int numSamples)
+{
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples](int i) { return _mm256_loadu_ps(samples + i); },
+                      [samples](int i) { return samples[i]; });
+}
+
+void accumulateInt16(PixelStats& stats, CrossingState& crossing, const int16_t* samples, int numSamples, float scale)
+{
+    const __m256 scaleVector = _mm256_set1_ps(scale);
+
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples, scaleVector](int i)
+                      {
+                          const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                          return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(packed)), scaleVector);
+                      },
+                      [samples, scale](int i) { return samples[i] * scale; });
+}
+
+/** The lanes of the multi-channel passes, eight samples per vector */
+struct AVX2LaneOps
+{
+    typedef __m256 Vector;
+    static constexpr int width = 8;
+
+    static Vector load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+    static Vector broadcast(float v) { return _mm256_set1_ps(v); }
+    static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+    static Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+
+    static Vector countAtOrBelow(Vector count, Vector x, Vector limit)
+    {
+        return _mm256_add_ps(count, _mm256_and_ps(_mm256_cmp_ps(x, limit, _CMP_LE_OQ), _mm256_set1_ps(1.0f)));
+    }
+
+    static Vector selectAtLeast(Vector count, Vector rank, Vector ifTrue, Vector ifFalse)
+    {
+        return _mm256_blendv_ps(ifFalse, ifTrue, _mm256_cmp_ps(count, rank, _CMP_GE_OQ));
+    }
+
+    static Vector minAtOrAbove(Vector current, Vector x, Vector limit)
+    {
+        return _mm256_blendv_ps(current, _mm256_min_ps(current, x), _mm256_cmp_ps(x, limit, _CMP_GE_OQ));
+    }
+};
+
+const PixelKernels avx2Kernels = { "AVX2", accumulateFloat, accumulateInt16,
+                                   subtractAverage<AVX2LaneOps>, subtractMedian<AVX2LaneOps>,
+                                   filterBiquadLanes<AVX2LaneOps>,
+                                   powerSpectrumLanes<AVX2LaneOps>,
+                                   decimateHalfBandLanes<AVX2LaneOps>, resampleLanes<AVX2LaneOps> };
+}
+
+const PixelKernels* ProbeViewer::getAVX2PixelKernels()
+{
+    return &avx2Kernels;
+}
+
+#else
+
+const ProbeViewer::PixelKernels* ProbeViewer::getAVX2PixelKernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "PixelKernels.hpp"
+#include "CrossingScan.hpp"
+#include "ReferencePass.hpp"
+#include "BiquadPass.hpp"
+#include "FFTPass.hpp"
+#include "DecimatorPass.hpp"
+
+// built with AVX-512F enabled; see CMakeLists.txt
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+using namespace ProbeViewer;
+
+namespace
+{
+// everything here has internal linkage, so no AVX-512 code can be picked up by
+// the linker in place of an inline function shared with the rest of the plugin
+
+/** Sixteen samples at a time, then the tail one by one; load(i) returns samples i..i+15 as floats */
+template <typename Load, typename LoadOne>
+void accumulateVectors(PixelStats& stats, CrossingState& crossing, int numSamples, Load load, LoadOne loadOne)
+{
+    const __m512 baseline = _mm512_set1_ps(stats.baseline);
+    const __m512 limit = _mm512_set1_ps(crossing.threshold);
+    const __m512 noiseLevel = _mm512_set1_ps(crossing.noiseLevel);
+    const __m512i one = _mm512_set1_epi32(1);
+
+    __m512 min = _mm512_set1_ps(stats.min);
+    __m512 max = _mm512_set1_ps(stats.max);
+    __m512 sum = _mm512_setzero_ps();
+    __m512 sumSquares = _mm512_setzero_ps();
+    __m512i aboveNoiseLevel = _mm512_setzero_si512();
+
+    CrossingScan scan(crossing);
+    int numCrossings = stats.crossings;
+
+    int i = 0;
+
+    for (; i + 16 <= numSamples; i += 16)
+    {
+        const __m512 val = load(i);
+        const __m512 offsetVal = _mm512_sub_ps(val, baseline);
+
+        min = _mm512_min_ps(min, val);
+        max = _mm512_max_ps(max, val);
+        sum = _mm512_add_ps(sum, offsetVal);
+        sumSquares = _mm512_fmadd_ps(offsetVal, offsetVal, sumSquares);
+
+        const __mmask16 isAboveNoiseLevel = _mm512_cmp_ps_mask(_mm512_abs_ps(offsetVal), noiseLevel, _CMP_GT_OQ);
+        aboveNoiseLevel = _mm512_mask_add_epi32(aboveNoiseLevel, isAboveNoiseLevel, aboveNoiseLevel, one);
+
+        const __mmask16 isBelow = _mm512_cmp_ps_mask(offsetVal, limit, _CMP_LT_OQ);
+        numCrossings += scan.add(uint32_t(isBelow), 16, i);
+    }
+
+    float minValue = _mm512_reduce_min_ps(min);
+    float maxValue = _mm512_reduce_max_ps(max);
+    float sumValue = stats.sum + _mm512_reduce_add_ps(sum);
+    float sumSquaresValue = stats.sumSquares + _mm512_reduce_add_ps(sumSquares);
+    int numAboveNoiseLevel = stats.numAboveNoiseLevel + _mm512_reduce_add_epi32(aboveNoiseLevel);
+
+    for (; i < numSamples; ++i)
+    {
+        const float val = loadOne(i);
+        const float offsetVal = val - stats.baseline;
+
+        minValue = val < minValue ? val : minValue;
+        maxValue = val > maxValue ? val : maxValue;
+        sumValue += offsetVal;
+        sumSquaresValue += offsetVal * offsetVal;
+        numAboveNoiseLevel += ((offsetVal < 0.0f ? -offsetVal : offsetVal) > crossing.noiseLevel);
+        numCrossings += scan.add(offsetVal < crossing.threshold, 1, i);
+    }
+
+    scan.finish(crossing, numSamples);
+
+    stats.min = minValue;
+    stats.max = maxValue;
+    stats.sum = sumValue;
+    stats.sumSquares = sumSquaresValue;
+    stats.crossings = numCrossings;
+    stats.numAboveNoiseLevel = numAboveNoiseLevel;
+    stats.numSamples += numSamples;
+}
+
+void accumulateFloat(PixelStats& stats, CrossingState& crossing, const float* samples, int numSamples)
+{
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples](int i) { return _mm512_loadu_ps(samples + i); },
+                      [samples](int i) { return samples[i]; });
+}
+
+void accumulateInt16(PixelStats& stats, CrossingState& crossing, const int16_t* samples, int numSamples, float scale)
+{
+    const __m512 scaleVector = _mm512_set1_ps(scale);
+
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples, scaleVector](int i)
+                      {
+                          const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+                          return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(packed)), scaleVector);
+                      },
+                      [samples, scale](int i) { return samples[i] * scale; });
+}
+
+/** The lanes of the multi-channel passes, sixteen samples per vector */
+struct AVX512LaneOps
+{
+    typedef __m512 Vector;
+    static constexpr int width = 16;
+
+    static Vector load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, Vector v) { _mm512_storeu_ps(p, v); }
+    static Vector broadcast(float v) { return _mm512_set1_ps(v); }
+    static Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm512_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm512_mul_ps(a, b); }
+    static Vector min(Vector a, Vector b) { return _mm512_min_ps(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm512_max_ps(a, b); }
+
+    static Vector countAtOrBelow(Vector count, Vector x, Vector limit)
+    {
+        return _mm512_mask_add_ps(count, _mm512_cmp_ps_mask(x, limit, _CMP_LE_OQ), count, _mm512_set1_ps(1.0f));
+    }
+
+    static Vector selectAtLeast(Vector count, Vector rank, Vector ifTrue, Vector ifFalse)
+    {
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(count, rank, _CMP_GE_OQ), ifFalse, ifTrue);
+    }
+
+    static Vector minAtOrAbove(Vector current, Vector x, Vector limit)
+    {
+        return _mm512_mask_min_ps(current, _mm512_cmp_ps_mask(x, limit, _CMP_GE_OQ), current, x);
+    }
+};
+
+const PixelKernels avx512Kernels = { "AVX-512", accumulateFloat, accumulateInt16,
+                                     subtractAverage<AVX512LaneOps>, subtractMedian<AVX512LaneOps>,
+                                     filterBiquadLanes<AVX512LaneOps>,
+                                     powerSpectrumLanes<AVX512LaneOps>,
+                                     decimateHalfBandLanes<AVX512LaneOps>, resampleLanes<AVX512LaneOps> };
+}
+
+const PixelKernels* ProbeViewer::getAVX512PixelKernels()
+{
+    return &avx512Kernels;
+}
+
+#else
+
+const ProbeViewer::PixelKernels* ProbeViewer::getAVX512PixelKernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "PixelKernels.hpp"
+#include "CrossingScan.hpp"
+#include "ReferencePass.hpp"
+#include "BiquadPass.hpp"
+#include "FFTPass.hpp"
+#include "DecimatorPass.hpp"
+
+// NEON is always available on 64-bit ARM, so this needs no extra flags
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+#include <arm_neon.h>
+
+using namespace ProbeViewer;
+
+namespace
+{
+/** Four samples at a time, then the tail one by one; load(i) returns samples i..i+3 as floats */
+template <typename Load, typename LoadOne>
+void accumulateVectors(PixelStats& stats, CrossingState& crossing, int numSamples, Load load, LoadOne loadOne)
+{
+    const float32x4_t baseline = vdupq_n_f32(stats.baseline);
+    const float32x4_t limit = vdupq_n_f32(crossing.threshold);
+    const float32x4_t noiseLevel = vdupq_n_f32(crossing.noiseLevel);
+
+    // turns a comparison into a four bit mask, lane j into bit j
+    const uint32_t laneBitValues[4] = { 1, 2, 4, 8 };
+    const uint32x4_t laneBits = vld1q_u32(laneBitValues);
+
+    float32x4_t min = vdupq_n_f32(stats.min);
+    float32x4_t max = vdupq_n_f32(stats.max);
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    float32x4_t sumSquares = vdupq_n_f32(0.0f);
+    uint32x4_t aboveNoiseLevel = vdupq_n_u32(0);
+
+    CrossingScan scan(crossing);
+    int numCrossings = stats.crossings;
+
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const float32x4_t val = load(i);
+        const float32x4_t offsetVal = vsubq_f32(val, baseline);
+
+        min = vminq_f32(min, val);
+        max = vmaxq_f32(max, val);
+        sum = vaddq_f32(sum, offsetVal);
+        sumSquares = vfmaq_f32(sumSquares, offsetVal, offsetVal);
+
+        // a true comparison is all ones, i.e. -1
+        aboveNoiseLevel = vsubq_u32(aboveNoiseLevel, vcgtq_f32(vabsq_f32(offsetVal), noiseLevel));
+
+        const uint32_t isBelow = vaddvq_u32(vandq_u32(vcltq_f32(offsetVal, limit), laneBits));
+        numCrossings += scan.add(isBelow, 4, i);
+    }
+
+    float minValue = vminvq_f32(min);
+    float maxValue = vmaxvq_f32(max);
+    float sumValue = stats.sum + vaddvq_f32(sum);
+    float sumSquaresValue = stats.sumSquares + vaddvq_f32(sumSquares);
+    int numAboveNoiseLevel = stats.numAboveNoiseLevel + int(vaddvq_u32(aboveNoiseLevel));
+
+    for (; i < numSamples; ++i)
+    {
+        const float val = loadOne(i);
+        const float offsetVal = val - stats.baseline;
+
+        minValue = val < minValue ? val : minValue;
+        maxValue = val > maxValue ? val : maxValue;
+        sumValue += offsetVal;
+        sumSquaresValue += offsetVal * offsetVal;
+        numAboveNoiseLevel += ((offsetVal < 0.0f ? -offsetVal : offsetVal) > crossing.noiseLevel);
+        numCrossings += scan.add(offsetVal < crossing.threshold, 1, i);
+    }
+
+    scan.finish(crossing, numSamples);
+
+    stats.min = minValue;
+    stats.max = maxValue;
+    stats.sum = sumValue;
+    stats.sumSquares = sumSquaresValue;
+    stats.crossings = numCrossings;
+    stats.numAboveNoiseLevel = numAboveNoiseLevel;
+    stats.numSamples += numSamples;
+}
+
+void accumulateFloat(PixelStats& stats, CrossingState& crossing, const float* samples, int numSamples)
+{
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples](int i) { return vld1q_f32(samples + i); },
+                      [samples](int i) { return samples[i]; });
+}
+
+void accumulateInt16(PixelStats& stats, CrossingState& crossing, const int16_t* samples, int numSamples, float scale)
+{
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples, scale](int i)
+                      {
+                          return vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(samples + i))), scale);
+                      },
+                      [samples, scale](int i) { return samples[i] * scale; });
+}
+
+/** The lanes of the multi-channel passes, four samples per vector */
+struct NEONLaneOps
+{
+    typedef float32x4_t Vector;
+    static constexpr int width = 4;
+
+    static Vector load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, Vector v) { vst1q_f32(p, v); }
+    static Vector broadcast(float v) { return vdupq_n_f32(v); }
+    static Vector add(Vector a, Vector b) { return vaddq_f32(a, b); }
+    static Vector sub(Vector a, Vector b) { return vsubq_f32(a, b); }
+    static Vector mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+    static Vector min(Vector a, Vector b) { return vminq_f32(a, b); }
+    static Vector max(Vector a, Vector b) { return vmaxq_f32(a, b); }
+
+    static Vector countAtOrBelow(Vector count, Vector x, Vector limit)
+    {
+        const uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+        return vaddq_f32(count, vreinterpretq_f32_u32(vandq_u32(vcleq_f32(x, limit), one)));
+    }
+
+    static Vector selectAtLeast(Vector count, Vector rank, Vector ifTrue, Vector ifFalse)
+    {
+        return vbslq_f32(vcgeq_f32(count, rank), ifTrue, ifFalse);
+    }
+
+    static Vector minAtOrAbove(Vector current, Vector x, Vector limit)
+    {
+        return vbslq_f32(vcgeq_f32(x, limit), vminq_f32(current, x), current);
+    }
+};
+
+const PixelKernels neonKernels = { "NEON", accumulateFloat, accumulateInt16,
+                                   subtractAverage<NEONLaneOps>, subtractMedian<NEONLaneOps>,
+                                   filterBiquadLanes<NEONLaneOps>,
+                                   powerSpectrumLanes<NEONLaneOps>,
+                                   decimateHalfBandLanes<NEONLaneOps>, resampleLanes<NEONLaneOps> };
+}
+
+const PixelKernels* ProbeViewer::getNEONPixelKernels()
+{
+    return &neonKernels;
+}
+
+#else
+
+const ProbeViewer::PixelKernels* ProbeViewer::getNEONPixelKernels()
+{
+    return nullptr;
+}
+
+#endif
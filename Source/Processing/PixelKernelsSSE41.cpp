@@ -0,0 +1,210 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "PixelKernels.hpp"
+#include "CrossingScan.hpp"
+#include "ReferencePass.hpp"
+#include "BiquadPass.hpp"
+#include "FFTPass.hpp"
+#include "DecimatorPass.hpp"
+
+// built with SSE4.1 enabled (always available to MSVC on x86); see CMakeLists.txt
+#if defined(__SSE4_1__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+
+#include <smmintrin.h>
+
+using namespace ProbeViewer;
+
+namespace
+{
+// everything here has internal linkage, so no SSE4.1 code can be picked up by
+// the linker in place of an inline function shared with the rest of the plugin
+
+float horizontalMin(__m128 m)
+{
+    m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+float horizontalMax(__m128 m)
+{
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+float horizontalSum(__m128 s)
+{
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+int horizontalSum(__m128i s)
+{
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+/** Four samples at a time, then the tail one by one; load(i) returns samples i..i+3 as floats */
+template <typename Load, typename LoadOne>
+void accumulateVectors(PixelStats& stats, CrossingState& crossing, int numSamples, Load load, LoadOne loadOne)
+{
+    const __m128 baseline = _mm_set1_ps(stats.baseline);
+    const __m128 limit = _mm_set1_ps(crossing.threshold);
+    const __m128 noiseLevel = _mm_set1_ps(crossing.noiseLevel);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    __m128 min = _mm_set1_ps(stats.min);
+    __m128 max = _mm_set1_ps(stats.max);
+    __m128 sum = _mm_setzero_ps();
+    __m128 sumSquares = _mm_setzero_ps();
+    __m128i aboveNoiseLevel = _mm_setzero_si128();
+
+    CrossingScan scan(crossing);
+    int numCrossings = stats.crossings;
+
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128 val = load(i);
+        const __m128 offsetVal = _mm_sub_ps(val, baseline);
+
+        min = _mm_min_ps(min, val);
+        max = _mm_max_ps(max, val);
+        sum = _mm_add_ps(sum, offsetVal);
+        sumSquares = _mm_add_ps(sumSquares, _mm_mul_ps(offsetVal, offsetVal));
+
+        // a true comparison is all ones, i.e. -1
+        const __m128 isAboveNoiseLevel = _mm_cmpgt_ps(_mm_and_ps(offsetVal, absMask), noiseLevel);
+        aboveNoiseLevel = _mm_sub_epi32(aboveNoiseLevel, _mm_castps_si128(isAboveNoiseLevel));
+
+        const int isBelow = _mm_movemask_ps(_mm_cmplt_ps(offsetVal, limit));
+        numCrossings += scan.add(uint32_t(isBelow), 4, i);
+    }
+
+    float minValue = horizontalMin(min);
+    float maxValue = horizontalMax(max);
+    float sumValue = stats.sum + horizontalSum(sum);
+    float sumSquaresValue = stats.sumSquares + horizontalSum(sumSquares);
+    int numAboveNoiseLevel = stats.numAboveNoiseLevel + horizontalSum(aboveNoiseLevel);
+
+    for (; i < numSamples; ++i)
+    {
+        const float val = loadOne(i);
+        const float offsetVal = val - stats.baseline;
+
+        minValue = val < minValue ? val : minValue;
+        maxValue = val > maxValue ? val : maxValue;
+        sumValue += offsetVal;
+        sumSquaresValue += offsetVal * offsetVal;
+        numAboveNoiseLevel += ((offsetVal < 0.0f ? -offsetVal : offsetVal) > crossing.noiseLevel);
+        numCrossings += scan.add(offsetVal < crossing.threshold, 1, i);
+    }
+
+    scan.finish(crossing, numSamples);
+
+    stats.min = minValue;
+    stats.max = maxValue;
+    stats.sum = sumValue;
+    stats.sumSquares = sumSquaresValue;
+    stats.crossings = numCrossings;
+    stats.numAboveNoiseLevel = numAboveNoiseLevel;
+    stats.numSamples += numSamples;
+}
+
+void accumulateFloat(PixelStats& stats, CrossingState& crossing, const float* samples, int numSamples)
+{
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples](int i) { return _mm_loadu_ps(samples + i); },
+                      [samples](int i) { return samples[i]; });
+}
+
+void accumulateInt16(PixelStats& stats, CrossingState& crossing, const int16_t* samples, int numSamples, float scale)
+{
+    const __m128 scaleVector = _mm_set1_ps(scale);
+
+    accumulateVectors(stats, crossing, numSamples,
+                      [samples, scaleVector](int i)
+                      {
+                          const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(samples + i));
+                          return _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(packed)), scaleVector);
+                      },
+                      [samples, scale](int i) { return samples[i] * scale; });
+}
+
+/** The lanes of the multi-channel passes, four samples per vector */
+struct SSE41LaneOps
+{
+    typedef __m128 Vector;
+    static constexpr int width = 4;
+
+    static Vector load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Vector v) { _mm_storeu_ps(p, v); }
+    static Vector broadcast(float v) { return _mm_set1_ps(v); }
+    static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+    static Vector min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+
+    static Vector countAtOrBelow(Vector count, Vector x, Vector limit)
+    {
+        return _mm_add_ps(count, _mm_and_ps(_mm_cmple_ps(x, limit), _mm_set1_ps(1.0f)));
+    }
+
+    static Vector selectAtLeast(Vector count, Vector rank, Vector ifTrue, Vector ifFalse)
+    {
+        return _mm_blendv_ps(ifFalse, ifTrue, _mm_cmpge_ps(count, rank));
+    }
+
+    static Vector minAtOrAbove(Vector current, Vector x, Vector limit)
+    {
+        return _mm_blendv_ps(current, _mm_min_ps(current, x), _mm_cmpge_ps(x, limit));
+    }
+};
+
+const PixelKernels sse41Kernels = { "SSE4.1", accumulateFloat, accumulateInt16,
+                                    subtractAverage<SSE41LaneOps>, subtractMedian<SSE41LaneOps>,
+                                    filterBiquadLanes<SSE41LaneOps>,
+                                    powerSpectrumLanes<SSE41LaneOps>,
+                                    decimateHalfBandLanes<SSE41LaneOps>, resampleLanes<SSE41LaneOps> };
+}
+
+const PixelKernels* ProbeViewer::getSSE41PixelKernels()
+{
+    return &sse41Kernels;
+}
+
+#else
+
+const ProbeViewer::PixelKernels* ProbeViewer::getSSE41PixelKernels()
+{
+    return nullptr;
+}
+
+#endif
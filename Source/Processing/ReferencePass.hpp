@@ -0,0 +1,183 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef ReferencePass_hpp
+#define ReferencePass_hpp
+
+#include "LaneOps.hpp"
+
+namespace ProbeViewer {
+
+// only included by the kernel files, like CrossingScan.hpp: every one of
+// them gets its own copy of these templates, built for its own instruction set
+namespace
+{
+
+/** Bisection steps of the median; each one halves the interval it is known to lie in */
+const int medianBisectionSteps = 16;
+
+/** Subtract a reference from one vector of samples of every row */
+template <typename Ops>
+void subtractFromRows(const float* const* sources, float* const* dests, int numRows, int first,
+                      typename Ops::Vector reference)
+{
+    for (int row = 0; row < numRows; ++row)
+        Ops::store(dests[row] + first, Ops::sub(Ops::load(sources[row] + first), reference));
+}
+
+/**
+ *  The mean across rows of the samples first..first + Ops::width - 1,
+ *  subtracted from each of them. Four partial sums hide the add latency.
+ */
+template <typename Ops>
+void subtractAverageLanes(const float* const* sources, float* const* dests, int numRows, int first)
+{
+    typedef typename Ops::Vector Vector;
+
+    Vector sum0 = Ops::broadcast(0.0f);
+    Vector sum1 = sum0;
+    Vector sum2 = sum0;
+    Vector sum3 = sum0;
+
+    int row = 0;
+
+    for (; row + 4 <= numRows; row += 4)
+    {
+        sum0 = Ops::add(sum0, Ops::load(sources[row] + first));
+        sum1 = Ops::add(sum1, Ops::load(sources[row + 1] + first));
+        sum2 = Ops::add(sum2, Ops::load(sources[row + 2] + first));
+        sum3 = Ops::add(sum3, Ops::load(sources[row + 3] + first));
+    }
+
+    for (; row < numRows; ++row)
+        sum0 = Ops::add(sum0, Ops::load(sources[row] + first));
+
+    const Vector sum = Ops::add(Ops::add(sum0, sum1), Ops::add(sum2, sum3));
+
+    subtractFromRows<Ops>(sources, dests, numRows, first, Ops::mul(sum, Ops::broadcast(1.0f / numRows)));
+}
+
+/**
+ *  The lower median across rows of the samples first..first + Ops::width - 1,
+ *  subtracted from each of them.
+ *
+ *  Rather than sorting each column, every lane bisects the range between
+ *  its smallest and largest sample, counting the samples at or below the
+ *  midpoint with one compare per row. The work is a fixed number of passes,
+ *  and the smallest sample at or above the final lower bound is within
+ *  (max - min) / 2^medianBisectionSteps of the median (exact unless two
+ *  samples are that close).
+ */
+template <typename Ops>
+void subtractMedianLanes(const float* const* sources, float* const* dests, int numRows, int first)
+{
+    typedef typename Ops::Vector Vector;
+
+    // invariant: the median is in [low, high]
+    Vector low = Ops::load(sources[0] + first);
+    Vector high = low;
+
+    for (int row = 1; row < numRows; ++row)
+    {
+        const Vector x = Ops::load(sources[row] + first);
+        low = Ops::min(low, x);
+        high = Ops::max(high, x);
+    }
+
+    const Vector rank = Ops::broadcast(float((numRows + 1) / 2));
+    const Vector half = Ops::broadcast(0.5f);
+    const Vector zero = Ops::broadcast(0.0f);
+
+    for (int step = 0; step < medianBisectionSteps; ++step)
+    {
+        const Vector middle = Ops::mul(Ops::add(low, high), half);
+
+        Vector count0 = zero;
+        Vector count1 = zero;
+
+        int row = 0;
+
+        for (; row + 2 <= numRows; row += 2)
+        {
+            count0 = Ops::countAtOrBelow(count0, Ops::load(sources[row] + first), middle);
+            count1 = Ops::countAtOrBelow(count1, Ops::load(sources[row + 1] + first), middle);
+        }
+
+        if (row < numRows)
+            count0 = Ops::countAtOrBelow(count0, Ops::load(sources[row] + first), middle);
+
+        const Vector count = Ops::add(count0, count1);
+
+        high = Ops::selectAtLeast(count, rank, middle, high);
+        low = Ops::selectAtLeast(count, rank, low, middle);
+    }
+
+    Vector median = high;
+
+    for (int row = 0; row < numRows; ++row)
+        median = Ops::minAtOrAbove(median, Ops::load(sources[row] + first), low);
+
+    subtractFromRows<Ops>(sources, dests, numRows, first, median);
+}
+
+/**
+ *  Run a lane pass over numSamples samples of the rows, a vector at a time.
+ *
+ *  Each vector reads the same few bytes of every row several times before
+ *  moving on, so the lines it touches (one per row) stay in L1 for all of
+ *  its passes, and the next vector finds the rest of those lines there.
+ */
+template <typename Ops, void (*vectorPass)(const float* const*, float* const*, int, int),
+          void (*scalarPass)(const float* const*, float* const*, int, int)>
+void runReferencePass(const float* const* sources, float* const* dests, int numRows, int numSamples)
+{
+    if (numRows <= 0)
+        return;
+
+    int i = 0;
+
+    for (; i + Ops::width <= numSamples; i += Ops::width)
+        vectorPass(sources, dests, numRows, i);
+
+    for (; i < numSamples; ++i)
+        scalarPass(sources, dests, numRows, i);
+}
+
+template <typename Ops>
+void subtractAverage(const float* const* sources, float* const* dests, int numRows, int numSamples)
+{
+    runReferencePass<Ops, subtractAverageLanes<Ops>, subtractAverageLanes<ScalarLaneOps>>(sources, dests, numRows, numSamples);
+}
+
+template <typename Ops>
+void subtractMedian(const float* const* sources, float* const* dests, int numRows, int numSamples)
+{
+    runReferencePass<Ops, subtractMedianLanes<Ops>, subtractMedianLanes<ScalarLaneOps>>(sources, dests, numRows, numSamples);
+}
+
+}
+
+}
+
+#endif /* ReferencePass_hpp */
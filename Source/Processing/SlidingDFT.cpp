@@ -0,0 +1,124 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "SlidingDFT.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace ProbeViewer;
+
+namespace
+{
+const double pi = 3.14159265358979323846;
+
+// weights of the three sums in the Hann window
+const double termWeights[] = { 0.5, -0.25, -0.25 };
+}
+
+#pragma mark - SlidingDFTBank -
+
+SlidingDFTBank::SlidingDFTBank()
+    : numChannels(0)
+    , size(0)
+    , bin(0)
+{
+    for (int term = 0; term < numTerms; ++term)
+    {
+        frequencies[term] = 0.0;
+        rotations[term] = { 1.0, 0.0 };
+        entries[term] = { 1.0, 0.0 };
+    }
+}
+
+void SlidingDFTBank::prepare(int numChannels_, int size_, int bin_)
+{
+    assert(size_ >= 3);
+
+    numChannels = std::max(0, numChannels_);
+    size = size_;
+
+    channelSums.assign(size_t(numChannels) * numSums, 0.0);
+
+    setBin(bin_);
+}
+
+void SlidingDFTBank::setBin(int bin_)
+{
+    bin = bin_;
+    updateFrequencies();
+}
+
+void SlidingDFTBank::updateFrequencies()
+{
+    const double binFrequency = 2.0 * pi * bin / size;
+    const double hannStep = 2.0 * pi / (size - 1);
+
+    frequencies[0] = binFrequency;
+    frequencies[1] = binFrequency - hannStep;
+    frequencies[2] = binFrequency + hannStep;
+
+    for (int term = 0; term < numTerms; ++term)
+    {
+        rotations[term] = { std::cos(frequencies[term]), std::sin(frequencies[term]) };
+        entries[term] = { std::cos(frequencies[term] * (size - 2)), -std::sin(frequencies[term] * (size - 2)) };
+    }
+}
+
+void SlidingDFTBank::resync(int channel, const float* samples)
+{
+    double* sums = channelSums.data() + channel * numSums;
+
+    for (int term = 0; term < numTerms; ++term)
+    {
+        double re = 0.0;
+        double im = 0.0;
+
+        for (int n = 0; n < size - 1; ++n)
+        {
+            re += samples[n] * std::cos(frequencies[term] * n);
+            im -= samples[n] * std::sin(frequencies[term] * n);
+        }
+
+        sums[2 * term] = re;
+        sums[2 * term + 1] = im;
+    }
+}
+
+float SlidingDFTBank::getPower(int channel) const
+{
+    const double* sums = channelSums.data() + channel * numSums;
+
+    double re = 0.0;
+    double im = 0.0;
+
+    for (int term = 0; term < numTerms; ++term)
+    {
+        re += termWeights[term] * sums[2 * term];
+        im += termWeights[term] * sums[2 * term + 1];
+    }
+
+    return float(re * re + im * im);
+}
@@ -0,0 +1,132 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef SlidingDFT_hpp
+#define SlidingDFT_hpp
+
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  The power of one bin of a Hann-windowed DFT of every channel of a
+ *  stream, updated in O(1) per sample instead of transforming a whole
+ *  window per pixel.
+ *
+ *  The window is the symmetric Hann window w[n] = 0.5 - 0.5 cos(2 pi n /
+ *  (size - 1)) the band power has always used. It is zero at both ends,
+ *  so the size-th point never contributes and the transform covers the
+ *  newest size - 1 samples, oldest first. Writing the window as
+ *  0.5 - 0.25 e^(i theta n) - 0.25 e^(-i theta n), theta = 2 pi / (size - 1),
+ *  turns the windowed bin into three plain sliding sums: at the bin's
+ *  frequency and one theta either side. Each sum slides by one sample with
+ *  a rotation, a subtraction and an addition.
+ *
+ *  The sums are kept in double precision, so the rounding they pick up
+ *  while sliding stays far below float resolution for days of data.
+ *
+ *  Usage, for every decimated sample of a channel:
+ *
+ *      bank.push(channel, newest, leaving);    // leaving: the sample size - 1 pushes ago
+ *      ...
+ *      const float power = bank.getPower(channel);    // |X[bin]|^2, unnormalized like kiss_fftr
+ */
+class SlidingDFTBank
+{
+public:
+    SlidingDFTBank();
+
+    /**
+     *  Track bin of a size-point window (size at least 3) for numChannels
+     *  channels, all starting from silence
+     */
+    void prepare(int numChannels, int size, int bin);
+
+    int getNumChannels() const { return numChannels; }
+    int getSize() const { return size; }
+    int getBin() const { return bin; }
+
+    /**
+     *  Track another bin. The sums of every channel are then stale until
+     *  ::resync is called with its window.
+     */
+    void setBin(int bin);
+
+    /**
+     *  Recompute a channel's sums from its newest size - 1 samples, oldest
+     *  first, e.g. after the bin changed
+     */
+    void resync(int channel, const float* samples);
+
+    /**
+     *  Slide a channel's window by one sample: newest enters, and leaving,
+     *  the oldest sample of the window (pushed size - 1 pushes ago), drops out
+     */
+    void push(int channel, float newest, float leaving)
+    {
+        double* sums = channelSums.data() + channel * numSums;
+
+        for (int term = 0; term < numTerms; ++term)
+        {
+            double* sum = sums + 2 * term;
+
+            // (sum - leaving) e^(i w), then the newest at position size - 2
+            const double re = sum[0] - leaving;
+            const double im = sum[1];
+
+            sum[0] = re * rotations[term].re - im * rotations[term].im + newest * entries[term].re;
+            sum[1] = re * rotations[term].im + im * rotations[term].re + newest * entries[term].im;
+        }
+    }
+
+    /** |X[bin]|^2 of the channel's windowed samples, as BatchedFFT or kiss_fftr would give it */
+    float getPower(int channel) const;
+
+private:
+    struct Complex
+    {
+        double re;
+        double im;
+    };
+
+    // the bin's frequency, then one Hann step below and above it
+    static constexpr int numTerms = 3;
+    static constexpr int numSums = 2 * numTerms;
+
+    void updateFrequencies();
+
+    int numChannels;
+    int size;
+    int bin;
+
+    double frequencies[numTerms];   // radians per sample
+    Complex rotations[numTerms];    // e^(i w)
+    Complex entries[numTerms];      // e^(-i w (size - 2)), the phase of the newest sample
+
+    std::vector<double> channelSums;    // [channel][term][re, im]
+};
+
+}
+
+#endif /* SlidingDFT_hpp */
@@ -0,0 +1,144 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "SpectralBands.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace ProbeViewer;
+
+namespace
+{
+struct BandEdges
+{
+    const char* name;
+    float low;
+    float high;
+};
+
+// indexed by SpectralBand
+const BandEdges bandEdges[NUM_SPECTRAL_BANDS] =
+{
+    { "Delta", 1.0f, 4.0f },
+    { "Theta", 4.0f, 8.0f },
+    { "Alpha", 8.0f, 13.0f },
+    { "Beta", 13.0f, 30.0f },
+    { "Gamma", 30.0f, 80.0f },
+    { "High Gamma", 80.0f, 200.0f }
+};
+
+/**
+ *  The bins of a size-point FFT at sampleRate whose centre lies between a
+ *  band's edges, first..end - 1; empty when end <= first
+ */
+void getBandBins(const BandEdges& edges, int fftSize, float sampleRate, int& first, int& end)
+{
+    const float binWidth = sampleRate / fftSize;
+
+    first = std::max(1, int(std::ceil(edges.low / binWidth)));
+    end = std::min(fftSize / 2 + 1, int(std::ceil(edges.high / binWidth)));
+}
+}
+
+#pragma mark - BandPowerMap -
+
+BandPowerMap::BandPowerMap()
+    : fftSize(0)
+{
+    std::fill(firstBins, firstBins + NUM_SPECTRAL_BANDS, 0);
+    std::fill(numBins, numBins + NUM_SPECTRAL_BANDS, 0);
+}
+
+const char* BandPowerMap::getName(SpectralBand band)
+{
+    return bandEdges[int(band)].name;
+}
+
+float BandPowerMap::getLowFrequency(SpectralBand band)
+{
+    return bandEdges[int(band)].low;
+}
+
+float BandPowerMap::getHighFrequency(SpectralBand band)
+{
+    return bandEdges[int(band)].high;
+}
+
+int BandPowerMap::getMinFFTSize(SpectralBand band, float sampleRate)
+{
+    assert(sampleRate > 0.0f);
+
+    const BandEdges& edges = bandEdges[int(band)];
+
+    // once the bins are no wider than the band one of them lies in it, unless it is above nyquist
+    for (int fftSize = 4;; fftSize *= 2)
+    {
+        int first, end;
+        getBandBins(edges, fftSize, sampleRate, first, end);
+
+        if (end > first || fftSize * (edges.high - edges.low) >= sampleRate)
+            return fftSize;
+    }
+}
+
+void BandPowerMap::prepare(int fftSize_, float sampleRate)
+{
+    assert(fftSize_ >= 4 && sampleRate > 0.0f);
+
+    fftSize = fftSize_;
+
+    for (int band = 0; band < NUM_SPECTRAL_BANDS; ++band)
+    {
+        int first, end;
+        getBandBins(bandEdges[band], fftSize, sampleRate, first, end);
+
+        // bands without a bin of their own are left empty rather than
+        // borrowing a neighbour's
+        firstBins[band] = first;
+        numBins[band] = std::max(0, end - first);
+    }
+}
+
+float BandPowerMap::getMeanPower(const float* power, int numLanes, int lane, SpectralBand band) const
+{
+    if (numBins[int(band)] == 0)
+        return std::numeric_limits<float>::quiet_NaN();
+
+    const float* bins = power + firstBins[int(band)] * numLanes + lane;
+    float sum = 0.0f;
+
+    for (int bin = 0; bin < numBins[int(band)]; ++bin, bins += numLanes)
+        sum += *bins;
+
+    return sum / numBins[int(band)];
+}
+
+float BandPowerMap::toDecibels(float power) const
+{
+    // the scale of StreamAnalyser::getBandPowerForChannel
+    return 20.0f * std::log10(power * 2.0f / fftSize);
+}
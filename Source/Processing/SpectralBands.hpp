@@ -0,0 +1,108 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef SpectralBands_hpp
+#define SpectralBands_hpp
+
+namespace ProbeViewer {
+
+/** The canonical LFP bands the multi-band power render modes show */
+enum class SpectralBand : int
+{
+    DELTA,
+    THETA,
+    ALPHA,
+    BETA,
+    GAMMA,
+    HIGH_GAMMA
+};
+
+/** Number of SpectralBands */
+constexpr int NUM_SPECTRAL_BANDS = 6;
+
+/**
+ *  Averages power spectra over the bins of every SpectralBand, so all bands
+ *  come from one transform per channel. The spectra are laid out as
+ *  BatchedFFT::computePowerSpectrum returns them ([bin][lane]).
+ *
+ *  A band's power is the mean power of its bins, in dB on the scale of the
+ *  single-bin band power, 20*log10(P*2/N), so the bands and the selected
+ *  bin can share colour bounds.
+ *
+ *  A band is only resolved when at least one bin centre lies between its
+ *  edges; narrower bands would otherwise share a bin with their
+ *  neighbours. At 1 kHz every band is resolved from 256 points up, while a
+ *  128-point FFT leaves delta and alpha without a bin.
+ */
+class BandPowerMap
+{
+public:
+    BandPowerMap();
+
+    /** Display name of a band, e.g. "Theta" */
+    static const char* getName(SpectralBand band);
+
+    /** Lower edge of a band in Hz; the band includes it */
+    static float getLowFrequency(SpectralBand band);
+
+    /** Upper edge of a band in Hz; the band excludes it */
+    static float getHighFrequency(SpectralBand band);
+
+    /**
+     *  The smallest FFT size, a power of two, that resolves a band at
+     *  sampleRate
+     */
+    static int getMinFFTSize(SpectralBand band, float sampleRate);
+
+    /**
+     *  Map the bands onto the bins of a size-point FFT of samples at
+     *  sampleRate. A band gets the bins whose centre lies between its
+     *  edges, and none when it is not resolved; DC is never used.
+     */
+    void prepare(int fftSize, float sampleRate);
+
+    int getFFTSize() const { return fftSize; }
+    int getFirstBin(SpectralBand band) const { return firstBins[int(band)]; }
+    int getNumBins(SpectralBand band) const { return numBins[int(band)]; }
+    bool isResolved(SpectralBand band) const { return numBins[int(band)] > 0; }
+
+    /**
+     *  The mean power of a band's bins in one lane of a spectrum with
+     *  numLanes lanes, or NaN when the band is not resolved
+     */
+    float getMeanPower(const float* power, int numLanes, int lane, SpectralBand band) const;
+
+    /** A mean bin power in dB, 20*log10(P*2/N) */
+    float toDecibels(float power) const;
+
+private:
+    int fftSize;
+
+    int firstBins[NUM_SPECTRAL_BANDS];
+    int numBins[NUM_SPECTRAL_BANDS];
+};
+
+}
+
+#endif /* SpectralBands_hpp */
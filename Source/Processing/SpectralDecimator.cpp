@@ -0,0 +1,368 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "SpectralDecimator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+
+using namespace ProbeViewer;
+
+namespace
+{
+const double pi = 3.14159265358979323846;
+
+/** Modified Bessel function of the first kind, order 0, by its power series */
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; k < 50 && term > sum * 1.0e-12; ++k)
+    {
+        const double half = x / (2.0 * k);
+        term *= half * half;
+        sum += term;
+    }
+
+    return sum;
+}
+
+/** Kaiser's beta for a stopband attenuation in dB above 50 */
+double getKaiserBeta(double attenuation)
+{
+    return 0.1102 * (attenuation - 8.7);
+}
+
+double sinc(double x)
+{
+    return x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+}
+}
+
+#pragma mark - SpectralDecimator -
+
+SpectralDecimator::SpectralDecimator()
+    : numChannels(0)
+    , inputRate(0.0)
+    , outputRate(0.0)
+    , numPhases(0)
+    , step(1)
+    , numTaps(0)
+    , scratchSize(0)
+    , historyPerGroup(0)
+    , kernels(&getPixelKernels())
+{ }
+
+int SpectralDecimator::getKaiserLength(double relativeTransition)
+{
+    return int(std::ceil((stopbandAttenuation - 7.95) / (2.285 * 2.0 * pi * relativeTransition))) + 1;
+}
+
+double SpectralDecimator::getKaiserWindow(int n, int length)
+{
+    const double centre = 0.5 * (length - 1);
+    const double x = (n - centre) / centre;
+
+    return besselI0(getKaiserBeta(stopbandAttenuation) * std::sqrt(std::max(0.0, 1.0 - x * x)))
+           / besselI0(getKaiserBeta(stopbandAttenuation));
+}
+
+SpectralDecimator::HalfBand SpectralDecimator::designHalfBand(double rate, double targetRate)
+{
+    // what lands within the passband after halving comes from the top
+    // passbandRatio * targetRate below the input's Nyquist frequency
+    const double passbandEdge = passbandRatio * targetRate;
+    const int minLength = getKaiserLength((0.5 * rate - 2.0 * passbandEdge) / rate);
+
+    HalfBand halfBand;
+    const int numSideTaps = std::max(1, (minLength + 1 + 3) / 4);
+    halfBand.numTaps = 4 * numSideTaps - 1;
+
+    const int centre = 2 * numSideTaps - 1;
+    double sum = 0.0;
+
+    for (int j = 0; j < numSideTaps; ++j)
+    {
+        const int offset = 2 * j + 1;
+        const double tap = 0.5 * sinc(0.5 * offset) * getKaiserWindow(centre + offset, halfBand.numTaps);
+
+        halfBand.sideTaps.push_back(float(tap));
+        sum += tap;
+    }
+
+    // a gain of exactly 1 at DC: 0.5 from the centre and twice the side taps
+    for (float& tap : halfBand.sideTaps)
+        tap = float(tap * 0.25 / sum);
+
+    return halfBand;
+}
+
+void SpectralDecimator::prepare(int numChannels_, double inputRate_, double targetRate)
+{
+    numChannels = std::max(0, numChannels_);
+    inputRate = inputRate_;
+    outputRate = inputRate_;
+
+    halfBands.clear();
+    phaseTaps.clear();
+    numPhases = 0;
+    step = 1;
+    numTaps = 0;
+    stageCarry.clear();
+    stageOffsets.clear();
+    scratchSize = 0;
+
+    if (inputRate > targetRate && targetRate > 0.0)
+    {
+        double rate = inputRate;
+
+        while (rate >= 4.0 * targetRate)
+        {
+            halfBands.push_back(designHalfBand(rate, targetRate));
+            rate /= 2.0;
+        }
+
+        // the ratio left, as the fewest phases that take it exactly, or
+        // else as closely as maxPhases do
+        const double ratio = rate / targetRate;
+        double bestError = 1.0e9;
+
+        for (int phases = 1; phases <= maxPhases && bestError > 1.0e-9; ++phases)
+        {
+            const int steps = int(std::lround(ratio * phases));
+            const double error = std::abs(double(steps) / phases - ratio) / ratio;
+
+            if (steps >= phases && error < bestError)
+            {
+                bestError = error;
+                numPhases = phases;
+                step = steps;
+            }
+        }
+
+        outputRate = rate * numPhases / step;
+
+        // a low-pass at the output's Nyquist frequency, at the rate of the
+        // input upsampled by numPhases, with every phase normalized to a
+        // gain of 1 at DC
+        const double upsampledRate = rate * numPhases;
+        const double cutoff = 0.5 * outputRate;
+        const double transition = (1.0 - 2.0 * passbandRatio) * outputRate;
+
+        numTaps = std::max(step / numPhases + 1, (getKaiserLength(transition / upsampledRate) + numPhases - 1) / numPhases);
+
+        const int length = numTaps * numPhases;
+        const double centre = 0.5 * (length - 1);
+
+        phaseTaps.assign(size_t(length), 0.0f);
+
+        for (int phase = 0; phase < numPhases; ++phase)
+        {
+            float* taps = phaseTaps.data() + phase * numTaps;
+            double sum = 0.0;
+
+            // a row meets its frames oldest first, the prototype newest first
+            for (int t = 0; t < numTaps; ++t)
+            {
+                const int n = (numTaps - 1 - t) * numPhases + phase;
+                const double tap = sinc(2.0 * cutoff / upsampledRate * (n - centre)) * getKaiserWindow(n, length);
+
+                taps[t] = float(tap);
+                sum += tap;
+            }
+
+            for (int t = 0; t < numTaps; ++t)
+                taps[t] = float(taps[t] / sum);
+        }
+
+        // each stage's scratch holds what it carries and what the stage before it hands on
+        int maxInput = maxBlockSamples;
+
+        for (const HalfBand& halfBand : halfBands)
+        {
+            stageCarry.push_back(halfBand.numTaps - 1);
+            stageOffsets.push_back(scratchSize);
+            scratchSize += (stageCarry.back() + maxInput) * numLanes;
+            maxInput = (maxInput + 1) / 2;
+        }
+
+        stageCarry.push_back(numTaps - 1);
+        stageOffsets.push_back(scratchSize);
+        scratchSize += (stageCarry.back() + maxInput) * numLanes;
+    }
+
+    historyPerGroup = 0;
+
+    for (int carry : stageCarry)
+        historyPerGroup += carry * numLanes;
+
+    const int numGroups = (numChannels + numLanes - 1) / numLanes;
+
+    history.assign(size_t(numGroups) * historyPerGroup, 0.0f);
+    historySizes.assign(size_t(numGroups) * stageCarry.size(), 0);
+    resamplePhases.assign(numGroups, 0);
+
+    reset();
+}
+
+void SpectralDecimator::reset()
+{
+    const int numStages = int(stageCarry.size());
+    const int numGroups = numStages > 0 ? int(historySizes.size()) / numStages : 0;
+
+    // every stage starts out full of silence, so the first input already
+    // has a whole window behind it
+    std::fill(history.begin(), history.end(), 0.0f);
+    std::fill(resamplePhases.begin(), resamplePhases.end(), 0);
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        for (int stage = 0; stage < numStages; ++stage)
+            historySizes[group * numStages + stage] = stageCarry[stage];
+    }
+}
+
+int SpectralDecimator::getMaxNumOutputs(int numSamples) const
+{
+    if (!isActive())
+        return numSamples;
+
+    // each half-band keeps at most one more than half of what it gets, and
+    // the resampler at most one more than its share
+    const int64_t divisor = int64_t(step) << halfBands.size();
+
+    return int(int64_t(numSamples) * numPhases / divisor) + 3;
+}
+
+int SpectralDecimator::restoreStage(int group, int stage, float* frames) const
+{
+    const int numStages = int(stageCarry.size());
+    const int numFrames = historySizes[group * numStages + stage];
+
+    const float* source = history.data() + size_t(group) * historyPerGroup;
+
+    for (int s = 0; s < stage; ++s)
+        source += stageCarry[s] * numLanes;
+
+    std::copy(source, source + numFrames * numLanes, frames);
+
+    return numFrames;
+}
+
+void SpectralDecimator::saveStage(int group, int stage, const float* frames, int numFrames)
+{
+    assert(numFrames >= 0 && numFrames <= stageCarry[stage]);
+
+    const int numStages = int(stageCarry.size());
+    float* dest = history.data() + size_t(group) * historyPerGroup;
+
+    for (int s = 0; s < stage; ++s)
+        dest += stageCarry[s] * numLanes;
+
+    std::copy(frames, frames + numFrames * numLanes, dest);
+    historySizes[group * numStages + stage] = numFrames;
+}
+
+template <typename SampleType>
+int SpectralDecimator::process(int firstChannel, int numGroupChannels, const SampleType* const* inputs, const float* scales,
+                               int numSamples, float* scratch, float* output)
+{
+    assert(firstChannel % numLanes == 0 && numGroupChannels <= numLanes);
+    assert(firstChannel + numGroupChannels <= numChannels);
+
+    const int group = firstChannel / numLanes;
+    const int numHalfBands = int(halfBands.size());
+    int numOutputs = 0;
+
+    for (int first = 0; first < numSamples; first += maxBlockSamples)
+    {
+        const int blockSamples = std::min(maxBlockSamples, numSamples - first);
+
+        // the first stage's frames: what it carried over, then the block
+        float* frames = isActive() ? scratch + stageOffsets[0] : output + numOutputs * numLanes;
+        int numFrames = isActive() ? restoreStage(group, 0, frames) : 0;
+        float* block = frames + numFrames * numLanes;
+
+        // unused lanes of the last group are decimated as silence
+        if (numGroupChannels < numLanes)
+            std::fill(block, block + blockSamples * numLanes, 0.0f);
+
+        for (int i = 0; i < blockSamples; ++i)
+        {
+            float* frame = block + i * numLanes;
+
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+                frame[lane] = inputs[lane][first + i] * scales[lane];
+        }
+
+        numFrames += blockSamples;
+
+        if (!isActive())
+        {
+            numOutputs += blockSamples;
+            continue;
+        }
+
+        for (int stage = 0; stage < numHalfBands; ++stage)
+        {
+            const HalfBand& halfBand = halfBands[stage];
+            float* next = scratch + stageOffsets[stage + 1];
+            const int numNextFrames = restoreStage(group, stage + 1, next);
+
+            const int numKept = numFrames >= halfBand.numTaps ? (numFrames - halfBand.numTaps) / 2 + 1 : 0;
+
+            kernels->decimateHalfBandLanes(halfBand.sideTaps.data(), int(halfBand.sideTaps.size()), frames, numKept,
+                                           next + numNextFrames * numLanes);
+
+            saveStage(group, stage, frames + 2 * numKept * numLanes, numFrames - 2 * numKept);
+
+            frames = next;
+            numFrames = numNextFrames + numKept;
+        }
+
+        // every output whose window ends within the frames
+        int& phase = resamplePhases[group];
+        const int lastStart = numFrames - numTaps;
+        const int numResampled = lastStart >= 0 ? ((lastStart + 1) * numPhases - phase - 1) / step + 1 : 0;
+
+        kernels->resampleLanes(phaseTaps.data(), numTaps, numPhases, step, phase, frames, numResampled,
+                               output + numOutputs * numLanes);
+
+        const int end = phase + numResampled * step;
+        const int numDropped = end / numPhases;
+        phase = end % numPhases;
+
+        saveStage(group, numHalfBands, frames + numDropped * numLanes, numFrames - numDropped);
+
+        numOutputs += numResampled;
+    }
+
+    return numOutputs;
+}
+
+template int SpectralDecimator::process<float>(int, int, const float* const*, const float*, int, float*, float*);
+template int SpectralDecimator::process<int16_t>(int, int, const int16_t* const*, const float*, int, float*, float*);
@@ -0,0 +1,178 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef SpectralDecimator_hpp
+#define SpectralDecimator_hpp
+
+#include "PixelKernels.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  Brings every channel of a stream down to about the rate of the band
+ *  power path, low-pass filtering it first so nothing above the new
+ *  Nyquist frequency aliases into the bins that are measured.
+ *
+ *  The rate is halved by half-band FIRs while it is at least four times
+ *  the target, then a polyphase FIR resamples it by a ratio L / M to the
+ *  target, e.g. 30 kHz -> 15 kHz -> 7.5 kHz -> 3.75 kHz -> 1 kHz (L / M
+ *  = 4 / 15) or 2.5 kHz -> 1 kHz (L / M = 2 / 5). Each stage only
+ *  computes the samples it keeps. Rates at or below the target are passed
+ *  through as they are.
+ *
+ *  Channels are decimated in groups of ::numLanes, one channel per SIMD
+ *  lane (see PixelKernels::decimateHalfBandLanes and
+ *  PixelKernels::resampleLanes), as BiquadFilterBank filters them; the
+ *  samples each stage still needs are carried per group from one run to
+ *  the next, so different groups can run on different threads.
+ */
+class SpectralDecimator
+{
+public:
+    SpectralDecimator();
+
+    static constexpr int numLanes = filterLaneCount;
+
+    /** Input samples decimated per pass through the stages; longer runs are split */
+    static constexpr int maxBlockSamples = 256;
+
+    /** Stopband attenuation of every stage, in dB */
+    static constexpr double stopbandAttenuation = 80.0;
+
+    /**
+     *  The output passes up to this fraction of the target rate unaliased;
+     *  the filters roll off between it and 1 minus it
+     */
+    static constexpr double passbandRatio = 0.4;
+
+    /** Most phases of the final resampler, which bounds the ratios it takes exactly */
+    static constexpr int maxPhases = 64;
+
+    /**
+     *  Design the stages from inputRate to targetRate and clear the state
+     *  of numChannels channels, as if they had been silent
+     */
+    void prepare(int numChannels, double inputRate, double targetRate);
+
+    /** Clear the state of every channel */
+    void reset();
+
+    int getNumChannels() const { return numChannels; }
+
+    /** False if the input is passed through as it is */
+    bool isActive() const { return numPhases > 0; }
+
+    double getInputRate() const { return inputRate; }
+
+    /**
+     *  The rate of the output: the target, or the nearest rate a ratio of
+     *  at most ::maxPhases phases reaches, or the input rate if that is
+     *  no higher than the target
+     */
+    double getOutputRate() const { return outputRate; }
+
+    int getNumHalfBandStages() const { return int(halfBands.size()); }
+    int getNumPhases() const { return numPhases; }
+    int getStep() const { return step; }
+    int getNumTapsPerPhase() const { return numTaps; }
+
+    /** The most output samples ::process writes per channel for numSamples input samples */
+    int getMaxNumOutputs(int numSamples) const;
+
+    /** Floats of scratch ::process needs */
+    int getScratchSize() const { return scratchSize; }
+
+    /**
+     *  Decimate numSamples samples of the channels firstChannel..firstChannel
+     *  + numGroupChannels - 1, which must lie in one group (firstChannel a
+     *  multiple of ::numLanes). Channel c is read from inputs[c - firstChannel]
+     *  multiplied by scales[c - firstChannel]. Writes the output samples
+     *  of the group to output, interleaved sample by sample ([sample][lane]
+     *  with ::numLanes lanes, room for ::getMaxNumOutputs), and returns
+     *  how many there are. scratch holds ::getScratchSize floats.
+     *
+     *  Groups are independent, so different groups may be decimated on
+     *  different threads at once.
+     */
+    template <typename SampleType>
+    int process(int firstChannel, int numGroupChannels, const SampleType* const* inputs, const float* scales,
+                int numSamples, float* scratch, float* output);
+
+private:
+    /** A half-band FIR of 4 * sideTaps.size() - 1 taps, see PixelKernels::decimateHalfBandLanes */
+    struct HalfBand
+    {
+        std::vector<float> sideTaps;
+        int numTaps;
+    };
+
+    /** Kaiser-windowed half-band filter for a stage whose input runs at rate */
+    static HalfBand designHalfBand(double rate, double targetRate);
+
+    /** Number of taps a Kaiser-windowed FIR needs for the given transition width, relative to its rate */
+    static int getKaiserLength(double relativeTransition);
+
+    /** The Kaiser window of length taps at tap n */
+    static double getKaiserWindow(int n, int length);
+
+    /** Copy the frames a group carried over for a stage to frames; returns their number */
+    int restoreStage(int group, int stage, float* frames) const;
+
+    /** Keep numFrames frames of a stage for the group's next run */
+    void saveStage(int group, int stage, const float* frames, int numFrames);
+
+    int numChannels;
+    double inputRate;
+    double outputRate;
+
+    std::vector<HalfBand> halfBands;
+
+    /** The final resampler, [phase][tap]; no phases when passing through */
+    std::vector<float> phaseTaps;
+    int numPhases;
+    int step;
+    int numTaps;
+
+    /** Frames carried over per stage: the taps of the stage less one */
+    std::vector<int> stageCarry;
+
+    /** Where each stage's frames start in the scratch, in floats */
+    std::vector<int> stageOffsets;
+    int scratchSize;
+
+    /** [group][stage][frame][lane], stageCarry[stage] frames per stage */
+    std::vector<float> history;
+    int historyPerGroup;
+    std::vector<int> historySizes;      // [group][stage]
+    std::vector<int> resamplePhases;    // [group]
+
+    const PixelKernels* kernels;
+};
+
+}
+
+#endif /* SpectralDecimator_hpp */
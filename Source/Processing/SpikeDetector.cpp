@@ -0,0 +1,96 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "SpikeDetector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace ProbeViewer;
+
+namespace
+{
+// MAD of Gaussian noise in standard deviations
+const float madPerSigma = 0.6745f;
+
+// how quickly the estimate moves: by up to e^(n * rate) per pixel of n
+// samples, so it settles within a few thousand samples
+const float adaptationPerSample = 1.0f / 4096.0f;
+const float maxAdaptationPerPixel = 0.5f;
+
+// no events are counted closer together than this
+const float refractoryPeriodSeconds = 0.001f;
+}
+
+SpikeDetector::SpikeDetector()
+{
+    reset(0);
+}
+
+void SpikeDetector::reset(int refractorySamples)
+{
+    state.threshold = std::numeric_limits<float>::lowest();
+    state.noiseLevel = 0.0f;
+    state.refractorySamples = std::max(1, refractorySamples);
+    state.samplesSinceEvent = state.refractorySamples;
+    state.wasBelow = false;
+
+    medianAbsoluteDeviation = 0.0f;
+}
+
+void SpikeDetector::update(const PixelStats& stats, float thresholdFactor)
+{
+    if (stats.numSamples == 0)
+        return;
+
+    if (medianAbsoluteDeviation > 0.0f)
+    {
+        // half the samples deviate by more than the MAD; push the estimate
+        // towards the level where that holds
+        const float fractionAbove = float(stats.numAboveNoiseLevel) / stats.numSamples;
+        const float rate = std::min(maxAdaptationPerPixel, adaptationPerSample * stats.numSamples);
+
+        medianAbsoluteDeviation *= std::exp(rate * (2.0f * fractionAbove - 1.0f));
+    }
+    else
+    {
+        // the first pixel (or a flat channel) seeds it from the RMS
+        medianAbsoluteDeviation = stats.getRMS() * madPerSigma;
+    }
+
+    state.noiseLevel = medianAbsoluteDeviation;
+    state.threshold = medianAbsoluteDeviation > 0.0f
+        ? -thresholdFactor * getNoiseSigma()
+        : std::numeric_limits<float>::lowest();
+}
+
+float SpikeDetector::getNoiseSigma() const
+{
+    return medianAbsoluteDeviation / madPerSigma;
+}
+
+int SpikeDetector::getRefractorySamples(float sampleRate)
+{
+    return std::max(1, int(sampleRate * refractoryPeriodSeconds));
+}
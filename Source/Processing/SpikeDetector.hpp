@@ -0,0 +1,81 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef SpikeDetector_hpp
+#define SpikeDetector_hpp
+
+#include "PixelKernels.hpp"
+
+namespace ProbeViewer {
+
+/**
+ *  Adaptive spike threshold of one channel: tracks the channel's noise
+ *  with a running median absolute deviation (MAD) and sets the crossing
+ *  threshold to a multiple of the noise standard deviation, so quiet and
+ *  noisy channels of a probe are judged alike.
+ *
+ *  The MAD is estimated incrementally. While a pixel is reduced the
+ *  kernels count the samples that deviate from the baseline by more than
+ *  the current estimate (one vector compare per sample); ::update then
+ *  scales the estimate up or down by how far that fraction is from one
+ *  half. This converges on the median of the deviations with O(1) state
+ *  and no sorting, and follows slow changes in the noise.
+ *
+ *  Usage, once per pixel:
+ *
+ *      kernels.accumulate(stats, detector.getCrossingState(), samples, n);
+ *      ...
+ *      detector.update(stats, thresholdFactor);
+ */
+class SpikeDetector
+{
+public:
+    SpikeDetector();
+
+    /** Forget the noise estimate and set the refractory period between events */
+    void reset(int refractorySamples);
+
+    /** The state the kernels read the levels from and carry events across runs in */
+    CrossingState& getCrossingState() { return state; }
+
+    /**
+     *  Adapt the noise estimate to a completed pixel, and set the threshold
+     *  for the next one to thresholdFactor noise standard deviations below
+     *  the baseline. Until the first pixel, nothing is detected.
+     */
+    void update(const PixelStats& stats, float thresholdFactor);
+
+    /** Current estimate of the noise standard deviation, or 0 before the first pixel */
+    float getNoiseSigma() const;
+
+    /** Refractory period for a sample rate, as a number of samples */
+    static int getRefractorySamples(float sampleRate);
+
+private:
+    CrossingState state;
+    float medianAbsoluteDeviation;
+};
+
+}
+
+#endif /* SpikeDetector_hpp */
@@ -0,0 +1,531 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "StreamAnalyser.hpp"
+
+#include "PixelColumnReducer.hpp"
+#include "../Utilities/PixelColumnQueue.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+using namespace ProbeViewer;
+
+namespace
+{
+// fraction of the difference to each decimated sample a raw offset moves by,
+// following drift slower than about a second
+const float rawOffsetTrackingRate = 1.0f / 1024.0f;
+
+void accumulateRun(const PixelKernels& kernels, PixelAccumulator& accumulator, CrossingState& crossing, const float* samples, int numSamples, float /*scale*/)
+{
+    accumulator.add(kernels, crossing, samples, numSamples);
+}
+
+void accumulateRun(const PixelKernels& kernels, PixelAccumulator& accumulator, CrossingState& crossing, const int16_t* samples, int numSamples, float scale)
+{
+    accumulator.add(kernels, crossing, samples, numSamples, scale);
+}
+
+float* getMetric(float* column, PixelMetric metric, int numChannels)
+{
+    return column + int(metric) * numChannels;
+}
+}
+
+#pragma mark - StreamAnalyser::ThreadWorkspace -
+
+struct StreamAnalyser::ThreadWorkspace
+{
+    ThreadWorkspace()
+        : lanes(BiquadFilterBank::numLanes * BiquadFilterBank::maxTileSamples, 0.0f)
+        , filtered(BiquadFilterBank::numLanes * BiquadFilterBank::maxTileSamples, 0.0f)
+    {
+        for (int lane = 0; lane < BiquadFilterBank::numLanes; ++lane)
+            rows[lane] = filtered.data() + lane * BiquadFilterBank::maxTileSamples;
+    }
+
+    BatchedFFT fft;
+
+    std::vector<float> lanes;
+    std::vector<float> filtered;
+    float* rows[BiquadFilterBank::numLanes];
+
+    /** spectralDecimator's scratch, and its output for a run of the group */
+    std::vector<float> decimatorScratch;
+    std::vector<float> decimated;
+};
+
+#pragma mark - StreamAnalyser -
+
+StreamAnalyser::StreamAnalyser()
+    : numChannels(0)
+    , sampleRate(0.0)
+    , baselineSamples(0)
+    , kernels(&getPixelKernels())
+    , filterBankBand(-1)
+    , spectrumFFTSize(-1)
+    , spectrumNumSegments(-1)
+    , spectrumHopSize(-1)
+{ }
+
+StreamAnalyser::~StreamAnalyser()
+{ }
+
+void StreamAnalyser::prepare(int numChannels_, double sampleRate_, int baselineSamples_, double spectralSampleRate, int numThreads)
+{
+    numChannels = std::max(0, numChannels_);
+    sampleRate = sampleRate_;
+    baselineSamples = std::max(1, baselineSamples_);
+
+    // every channel starts a pixel at its next sample
+    pixelAccumulators.assign(numChannels, PixelAccumulator());
+    spikeDetectors.assign(numChannels, SpikeDetector());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        pixelAccumulators[channel].reset(baselineSamples, baselineSamples);
+        spikeDetectors[channel].reset(SpikeDetector::getRefractorySamples(float(sampleRate)));
+    }
+
+    rawOffsets.assign(numChannels, std::numeric_limits<float>::quiet_NaN());
+
+    fftSampleCaches.clear();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        fftSampleCaches.emplace_back(new FFTSampleCacheBuffer(0));
+        fftSampleCaches.back()->reserve(maxFFTSize);
+    }
+
+    spectralDecimator.prepare(numChannels, sampleRate, spectralSampleRate);
+
+    while (int(workspaces.size()) < numThreads)
+        workspaces.emplace_back(new ThreadWorkspace());
+
+    // a run never crosses a baseline segment, so it decimates to at most this
+    for (auto& workspace : workspaces)
+    {
+        workspace->decimatorScratch.assign(spectralDecimator.getScratchSize(), 0.0f);
+        workspace->decimated.assign(size_t(spectralDecimator.getMaxNumOutputs(baselineSamples)) * SpectralDecimator::numLanes, 0.0f);
+        workspace->fft.reserve(maxFFTSize);
+    }
+
+    // room for any of the settings, so changing them does not allocate
+    size_t maxNumSections = 0;
+
+    for (int band = 0; band < NUM_FILTER_BANDS; ++band)
+    {
+        bandSections[band] = BiquadFilterBank::designBand(FilterBand(band), float(sampleRate));
+        maxNumSections = std::max(maxNumSections, bandSections[band].size());
+    }
+
+    filterBank.reserve(numChannels, int(maxNumSections));
+
+    bandPowerDFT.prepare(numChannels, maxFFTSize, 1);
+    welch.reserve(numChannels, maxNumSegments);
+    spectrumScratch.reserve(maxFFTSize);
+
+    // designed for the new channels by the next settings
+    filterBankBand = -1;
+    spectrumFFTSize = -1;
+    spectrumNumSegments = -1;
+    spectrumHopSize = -1;
+}
+
+int StreamAnalyser::getSamplesPerPixel() const
+{
+    return numChannels > 0 ? pixelAccumulators[0].getSamplesPerPixel() : 0;
+}
+
+int StreamAnalyser::getNumSamplesToPixelEnd() const
+{
+    return numChannels > 0 ? pixelAccumulators[0].getNumSamplesToPixelEnd() : 0;
+}
+
+void StreamAnalyser::setPixelSize(int samplesPerPixel)
+{
+    assert(samplesPerPixel > 0 && samplesPerPixel <= baselineSamples);
+
+    // the pixels in progress are dropped; the baseline stays the same at
+    // every pixel size, so the spike rate is measured the same way
+    for (auto& accumulator : pixelAccumulators)
+        accumulator.reset(samplesPerPixel, baselineSamples);
+}
+
+void StreamAnalyser::setFilterBand(FilterBand band)
+{
+    if (int(band) == filterBankBand)
+        return;
+
+    filterBank.prepare(numChannels, bandSections[int(band)]);
+    filterBankBand = int(band);
+}
+
+void StreamAnalyser::resetFilter()
+{
+    filterBank.reset();
+}
+
+void StreamAnalyser::setSpectrum(int fftSize, int numSegments, int hopSize, int fftBin)
+{
+    assert(fftSize <= maxFFTSize && numSegments <= maxNumSegments);
+
+    fftBin = std::min(fftBin, fftSize / 2);
+
+    if (fftSize != spectrumFFTSize || numSegments != spectrumNumSegments || hopSize != spectrumHopSize)
+    {
+        // only a new size empties the caches and restarts the estimates;
+        // averaging and overlap keep the segments collected so far
+        if (fftSize != spectrumFFTSize)
+        {
+            for (auto& fftSamples : fftSampleCaches)
+                fftSamples->resize(fftSize);
+
+            for (auto& workspace : workspaces)
+                workspace->fft.prepare(fftSize);
+
+            spectrumScratch.assign(fftSize, 0.0f);
+            bandPowerDFT.prepare(numChannels, fftSize, fftBin);
+
+            // the bands sit at the rate the caches are actually decimated to
+            welch.prepare(numChannels, fftSize, numSegments, hopSize,
+                          float(std::max(1.0, spectralDecimator.getOutputRate())), fftBin);
+        }
+        else
+        {
+            welch.setAveraging(numSegments, hopSize);
+        }
+
+        spectrumFFTSize = fftSize;
+        spectrumNumSegments = numSegments;
+        spectrumHopSize = hopSize;
+    }
+
+    if (fftBin == bandPowerDFT.getBin())
+        return;
+
+    bandPowerDFT.setBin(fftBin);
+    welch.setBin(fftBin);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        fftSampleCaches[channel]->copyTo(spectrumScratch.data(), 1);
+        bandPowerDFT.resync(channel, spectrumScratch.data());
+    }
+}
+
+template <typename SampleType>
+int StreamAnalyser::reduceChannelGroup(int begin, int end, const SampleType* const* inputs, const float* scales, int numSamples,
+                                       float spikeThresholdFactor, int threadIndex, PixelColumnQueue& columns, int firstColumn)
+{
+    assert(end - begin <= BiquadFilterBank::numLanes && begin % BiquadFilterBank::numLanes == 0);
+    assert(threadIndex < int(workspaces.size()) && spectrumFFTSize > 0);
+
+    ThreadWorkspace& workspace = *workspaces[threadIndex];
+
+    if (filterBank.isActive())
+        return reduceRunForChannelGroup<SampleType, true>(begin, end, inputs, scales, numSamples, spikeThresholdFactor,
+                                                          workspace, columns, firstColumn);
+
+    return reduceRunForChannelGroup<SampleType, false>(begin, end, inputs, scales, numSamples, spikeThresholdFactor,
+                                                       workspace, columns, firstColumn);
+}
+
+template <typename SampleType, bool isFiltered>
+int StreamAnalyser::reduceRunForChannelGroup(int begin, int end, const SampleType* const* inputs, const float* scales, int numSamples,
+                                             float spikeThresholdFactor, ThreadWorkspace& workspace, PixelColumnQueue& columns, int firstColumn)
+{
+    const int numGroupChannels = end - begin;
+
+    // the filter works through the group a tile at a time, so the tile is
+    // still in cache when it is reduced; unfiltered runs are reduced whole
+    const int tileSize = isFiltered ? BiquadFilterBank::maxTileSamples : std::max(1, numSamples);
+    const PixelAccumulator& phase = pixelAccumulators[begin];
+    const SampleType* tileInputs[BiquadFilterBank::numLanes];
+    const SampleType* segmentInputs[BiquadFilterBank::numLanes];
+    int numPixelsCreated = 0;
+
+    for (int start = 0; start < numSamples; start += tileSize)
+    {
+        const int tileSamples = std::min(tileSize, numSamples - start);
+
+        for (int lane = 0; lane < numGroupChannels; ++lane)
+            tileInputs[lane] = inputs[lane] + start;
+
+        if constexpr (isFiltered)
+            filterBank.process(begin, numGroupChannels, tileInputs, scales, tileSamples,
+                               workspace.lanes.data(), workspace.rows);
+
+        int pos = 0;
+
+        while (pos < tileSamples)
+        {
+            const int segmentSize = std::min(tileSamples - pos, phase.getNumSamplesToRunEnd());
+
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+            {
+                reduceSegmentForChannel<SampleType, isFiltered>(begin + lane, tileInputs[lane] + pos, workspace.rows[lane] + pos,
+                                                                segmentSize, scales[lane]);
+            }
+
+            // the band power always uses the raw samples, decimated
+            // while the segment is still in cache
+            for (int lane = 0; lane < numGroupChannels; ++lane)
+                segmentInputs[lane] = tileInputs[lane] + pos;
+
+            const int numDecimated = spectralDecimator.process(begin, numGroupChannels, segmentInputs, scales, segmentSize,
+                                                               workspace.decimatorScratch.data(),
+                                                               workspace.decimated.data());
+
+            pushDecimatedFramesForChannelGroup(begin, end, workspace.decimated.data(), numDecimated, workspace);
+
+            pos += segmentSize;
+
+            if (phase.isSegmentComplete())
+                completeSegmentForChannelGroup(begin, end, spikeThresholdFactor);
+
+            if (phase.isPixelComplete())
+            {
+                completePixelForChannelGroup(begin, end, columns.getWritableColumn(firstColumn + numPixelsCreated));
+                ++numPixelsCreated;
+            }
+        }
+    }
+
+    return numPixelsCreated;
+}
+
+template <typename SampleType, bool isFiltered>
+void StreamAnalyser::reduceSegmentForChannel(int channel, const SampleType* samples, const float* filtered, int numSamples, float scale)
+{
+    PixelAccumulator& accumulator = pixelAccumulators[channel];
+    SpikeDetector& detector = spikeDetectors[channel];
+
+    assert(numSamples <= accumulator.getNumSamplesToRunEnd());
+
+    if (numSamples <= 0)
+        return;
+
+    if constexpr (isFiltered)
+        accumulator.add(*kernels, detector.getCrossingState(), filtered, numSamples);
+    else
+        accumulateRun(*kernels, accumulator, detector.getCrossingState(), samples, numSamples, scale);
+}
+
+// the sample storages of CircularBuffer
+template int StreamAnalyser::reduceChannelGroup<float>(int, int, const float* const*, const float*, int, float, int, PixelColumnQueue&, int);
+template int StreamAnalyser::reduceChannelGroup<int16_t>(int, int, const int16_t* const*, const float*, int, float, int, PixelColumnQueue&, int);
+
+void StreamAnalyser::completeSegmentForChannelGroup(int begin, int end, float spikeThresholdFactor)
+{
+    for (int channel = begin; channel < end; ++channel)
+    {
+        PixelAccumulator& accumulator = pixelAccumulators[channel];
+        assert(accumulator.isSegmentComplete());
+
+        spikeDetectors[channel].update(accumulator.getSegmentStats(), spikeThresholdFactor);
+        accumulator.startNextSegment();
+    }
+}
+
+void StreamAnalyser::completePixelForChannelGroup(int begin, int end, float* column)
+{
+    for (int channel = begin; channel < end; ++channel)
+    {
+        PixelAccumulator& accumulator = pixelAccumulators[channel];
+        assert(accumulator.isPixelComplete());
+
+        writePixelValues(column, channel, accumulator.getStats());
+        accumulator.startNextPixel();
+    }
+}
+
+void StreamAnalyser::addReducedColumnForChannelGroup(int begin, int end, const PixelColumnReducer& reducer, int64_t position,
+                                                     float* values, int threadIndex)
+{
+    assert(end - begin <= BatchedFFT::numLanes && threadIndex < int(workspaces.size()) && spectrumFFTSize > 0);
+
+    ThreadWorkspace& workspace = *workspaces[threadIndex];
+    const int numDecimated = reducer.getNumDecimatedSamples(position);
+
+    // the group completes its Welch segments together, possibly more than
+    // one per column at small hops
+    for (int first = 0; first < numDecimated;)
+    {
+        const int numPushed = std::min(numDecimated - first, welch.getSamplesToSegmentEnd(begin));
+
+        for (int channel = begin; channel < end; ++channel)
+        {
+            const float* decimated = reducer.getDecimatedSamples(position, channel);
+
+            for (int i = first; i < first + numPushed; ++i)
+                pushBandPowerSample(channel, decimated[i]);
+        }
+
+        first += numPushed;
+
+        if (welch.getSamplesToSegmentEnd(begin) == 0)
+            addWelchSegmentForChannelGroup(begin, end, workspace);
+    }
+
+    for (int channel = begin; channel < end; ++channel)
+        writePixelValues(values, channel, reducer.getColumn(position, channel));
+}
+
+void StreamAnalyser::writePixelValues(float* column, int channel, const PixelStats& stats) const
+{
+    getMetric(column, PixelMetric::RMS, numChannels)[channel] = stats.getRMS();
+    getMetric(column, PixelMetric::SPIKE_RATE, numChannels)[channel] = float(stats.crossings / (stats.numSamples / sampleRate));
+    getMetric(column, PixelMetric::BIN_POWER, numChannels)[channel] = getBandPowerForChannel(channel);
+
+    float* bandPowers = getMetric(column, PixelMetric::FIRST_BAND_POWER, numChannels);
+
+    for (int band = 0; band < NUM_SPECTRAL_BANDS; ++band)
+        bandPowers[band * numChannels + channel] = welch.getBandPower(channel, SpectralBand(band));
+}
+
+void StreamAnalyser::pushBandPowerSample(int channel, float sample)
+{
+    FFTSampleCacheBuffer& fftSamples = *fftSampleCaches[channel];
+    float& rawOffset = rawOffsets[channel];
+
+    if (std::isnan(rawOffset))
+        rawOffset = sample;
+
+    rawOffset += (sample - rawOffset) * rawOffsetTrackingRate;
+    sample = (sample - rawOffset) / 500.0f;
+
+    // the cache hands the FFT its newest size - 1 samples first and the
+    // one about to be overwritten last, where the window is zero; the
+    // first of them is the one that leaves
+    const float leaving = fftSamples.readSample(0);
+
+    fftSamples.pushSample(sample);
+    bandPowerDFT.push(channel, sample, leaving);
+    welch.advance(channel, 1);
+}
+
+void StreamAnalyser::pushDecimatedFramesForChannelGroup(int begin, int end, const float* frames, int numFrames, ThreadWorkspace& workspace)
+{
+    for (int i = 0; i < numFrames; ++i, frames += SpectralDecimator::numLanes)
+    {
+        for (int channel = begin; channel < end; ++channel)
+            pushBandPowerSample(channel, frames[channel - begin]);
+
+        if (welch.getSamplesToSegmentEnd(begin) == 0)
+            addWelchSegmentForChannelGroup(begin, end, workspace);
+    }
+}
+
+void StreamAnalyser::addWelchSegmentForChannelGroup(int begin, int end, ThreadWorkspace& workspace)
+{
+    assert(end - begin <= BatchedFFT::numLanes);
+
+    BatchedFFT& fft = workspace.fft;
+    float* input = fft.getInput();
+
+    for (int channel = begin; channel < end; ++channel)
+        fftSampleCaches[channel]->copyTo(input + (channel - begin), BatchedFFT::numLanes);
+
+    welch.addSegment(begin, end - begin, fft.computePowerSpectrum(), BatchedFFT::numLanes);
+}
+
+float StreamAnalyser::getBandPowerForChannel(int channel) const
+{
+    if (welch.getNumSegments() > 1)
+        return welch.getBinPower(channel);
+
+    return 20 * std::log10(bandPowerDFT.getPower(channel) * 2 / bandPowerDFT.getSize());
+}
+
+#pragma mark - StreamAnalyser::FFTSampleCacheBuffer -
+
+StreamAnalyser::FFTSampleCacheBuffer::FFTSampleCacheBuffer(int size)
+    : bufferSize(size), writeIdx(0), readIdx(1)
+{
+    buffer.resize(size);
+}
+
+StreamAnalyser::FFTSampleCacheBuffer::~FFTSampleCacheBuffer()
+{
+}
+
+void StreamAnalyser::FFTSampleCacheBuffer::resize(const int size)
+{
+    bufferSize = size;
+    buffer.assign(size, 0.0f);
+
+    writeIdx = 0;
+    readIdx = 1;
+}
+
+namespace
+{
+void incrementIndices(int &writeIdx, int &readIdx, int bufferSize)
+{
+    writeIdx = readIdx++;
+
+    if (readIdx >= bufferSize)
+    {
+        readIdx = 0;
+    }
+
+    assert(writeIdx < bufferSize);
+    assert(readIdx < bufferSize);
+}
+} // namespace
+
+void StreamAnalyser::FFTSampleCacheBuffer::pushSample(const float sample)
+{
+    buffer[writeIdx] = sample;
+    incrementIndices(writeIdx, readIdx, bufferSize);
+}
+
+float StreamAnalyser::FFTSampleCacheBuffer::readSample(int index) const
+{
+    assert(index < bufferSize);
+
+    index += readIdx;
+
+    if (index >= bufferSize)
+    {
+        index -= bufferSize;
+    }
+
+    assert(index < bufferSize);
+
+    return buffer[index];
+}
+
+void StreamAnalyser::FFTSampleCacheBuffer::copyTo(float* dest, int destStride) const
+{
+    for (int index = readIdx; index < bufferSize; ++index, dest += destStride)
+        *dest = buffer[index];
+
+    for (int index = 0; index < readIdx; ++index, dest += destStride)
+        *dest = buffer[index];
+}
@@ -0,0 +1,347 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef StreamAnalyser_hpp
+#define StreamAnalyser_hpp
+
+#include "BatchedFFT.hpp"
+#include "BiquadFilterBank.hpp"
+#include "PixelAccumulator.hpp"
+#include "PixelKernels.hpp"
+#include "SlidingDFT.hpp"
+#include "SpectralBands.hpp"
+#include "SpectralDecimator.hpp"
+#include "SpikeDetector.hpp"
+#include "WelchBandPower.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ProbeViewer {
+
+class PixelColumnReducer;
+class PixelColumnQueue;
+
+/**
+ *  The values a pixel column holds for every channel, laid out
+ *  [metric][channel] in this order
+ */
+enum class PixelMetric : int
+{
+    RMS,
+    SPIKE_RATE,
+    BIN_POWER,
+
+    // the power of each SpectralBand, in its order
+    FIRST_BAND_POWER
+};
+
+constexpr int NUM_PIXEL_METRICS = int(PixelMetric::FIRST_BAND_POWER) + NUM_SPECTRAL_BANDS;
+
+/**
+ *  The analysis of the displayed stream: turns its raw samples, or the
+ *  columns a PixelColumnReducer reduced on the audio thread, into pixel
+ *  columns holding every PixelMetric of every channel.
+ *
+ *  Raw samples are reduced a group of BiquadFilterBank::numLanes channels
+ *  at a time. The filter bank works through the group a tile at a time,
+ *  and each channel's PixelAccumulator and SpikeDetector take the tile
+ *  while it is still in cache. The raw samples are also decimated to the
+ *  band power rate, and pushed into each channel's FFT cache, its
+ *  SlidingDFTBank bin and its WelchBandPower segments.
+ *
+ *  Groups only touch their own channels, so the caller may hand them to
+ *  different threads, each passing its own thread index below the count
+ *  given to ::prepare:
+ *
+ *      pool.parallelFor(numChannels, BiquadFilterBank::numLanes, [&](int begin, int end, int threadIndex)
+ *      {
+ *          numPixels = analyser.reduceChannelGroup(begin, end, inputs, scales, numSamples,
+ *                                                  thresholdFactor, threadIndex, columns, 0);
+ *      });
+ *      columns.finishPush(numPixels);
+ *
+ *  The channels of a stream share their pixel phase, so every group
+ *  completes the same pixels. The settings are changed between passes.
+ *
+ *  Only ::prepare allocates. It sizes every buffer for ::maxFFTSize and
+ *  ::maxNumSegments, and designs every FilterBand, so ::setPixelSize,
+ *  ::setFilterBand and ::setSpectrum reuse that memory, as do the passes.
+ */
+class StreamAnalyser
+{
+public:
+    StreamAnalyser();
+    ~StreamAnalyser();
+
+    StreamAnalyser(const StreamAnalyser&) = delete;
+    StreamAnalyser& operator=(const StreamAnalyser&) = delete;
+
+    /** The largest FFT size and Welch averaging ::setSpectrum takes */
+    static constexpr int maxFFTSize = 4096;
+    static constexpr int maxNumSegments = 16;
+
+    /**
+     *  Size the state of numChannels channels at sampleRate, reduced by
+     *  numThreads threads, and restart it. Pixels and the spike detectors'
+     *  baseline segments are baselineSamples long; the band power is taken
+     *  at about spectralSampleRate. The filter bank and spectrum are set up
+     *  by the next ::setFilterBand and ::setSpectrum.
+     */
+    void prepare(int numChannels, double sampleRate, int baselineSamples, double spectralSampleRate, int numThreads);
+
+    int getNumChannels() const { return numChannels; }
+    double getSampleRate() const { return sampleRate; }
+    int getBaselineSamples() const { return baselineSamples; }
+
+    int getSamplesPerPixel() const;
+
+    /** Samples every channel still needs to complete its pixel */
+    int getNumSamplesToPixelEnd() const;
+
+    /**
+     *  Restart every channel's pixel at samplesPerPixel, at most the
+     *  baseline; the spike detectors keep their noise estimates
+     */
+    void setPixelSize(int samplesPerPixel);
+
+    /** Design the filter bank for band, unless it already is */
+    void setFilterBand(FilterBand band);
+
+    /** Clear the filter states, when the next samples do not follow on from the last ones */
+    void resetFilter();
+
+    /**
+     *  Resize the FFT caches when another FFT size (a power of two up to
+     *  ::maxFFTSize) is given, which empties them and restarts the band
+     *  power. Another averaging (up to ::maxNumSegments) or hop keeps the
+     *  Welch segments collected so far, and another bin retunes the band
+     *  power. The bin is clamped to fftSize / 2.
+     */
+    void setSpectrum(int fftSize, int numSegments, int hopSize, int fftBin);
+
+    /**
+     *  Reduce numSamples raw samples of the channels begin..end - 1, at
+     *  most one group of the filter bank, each multiplied by its scale.
+     *  Every pixel the group completes is written to the writable columns
+     *  of columns from firstColumn on. Returns the number of pixels
+     *  completed; the rest are carried to the next call.
+     */
+    template <typename SampleType>
+    int reduceChannelGroup(int begin, int end, const SampleType* const* inputs, const float* scales, int numSamples,
+                           float spikeThresholdFactor, int threadIndex, PixelColumnQueue& columns, int firstColumn);
+
+    /**
+     *  Push the decimated samples the channels begin..end - 1 have in a
+     *  column of reducer, and write every metric of the column to values
+     */
+    void addReducedColumnForChannelGroup(int begin, int end, const PixelColumnReducer& reducer, int64_t position,
+                                         float* values, int threadIndex);
+
+private:
+    /** The filter, decimator and FFT scratch of one thread, for a group at a time */
+    struct ThreadWorkspace;
+
+    /**
+     *  A ring of a channel's newest decimated samples, as many as the FFT
+     *  size, read from the oldest
+     */
+    class FFTSampleCacheBuffer
+    {
+    public:
+        FFTSampleCacheBuffer(int size);
+        ~FFTSampleCacheBuffer();
+
+        FFTSampleCacheBuffer(const FFTSampleCacheBuffer &) = delete;
+        FFTSampleCacheBuffer(FFTSampleCacheBuffer &&) = delete;
+        FFTSampleCacheBuffer& operator=(const FFTSampleCacheBuffer &) = delete;
+        FFTSampleCacheBuffer& operator=(FFTSampleCacheBuffer &) = delete;
+
+        /**
+         *  Resizes the internal memory structure to the size given in the
+         *  param.
+         *
+         *  Calling this method flushes all of the current values stored,
+         *  resets the write and read indices, and reverts the structure
+         *  to its initialization state at the new buffer size.
+         */
+        void resize(int size);
+
+        /** Allocate for sizes up to maxSize, so ::resize within it does not */
+        void reserve(int maxSize) { buffer.reserve(maxSize); }
+
+        /**
+         *  Push one new sample to the end of the buffer.
+         *
+         *  This method will add a new sample to the buffer, overwriting the
+         *  oldest sample and incrementing the write and read indices forward
+         *  by one position. The increment automatically wraps.
+         */
+        void pushSample(const float sample);
+
+        /**
+         *  Read one sample from the buffer at the given index.
+         *
+         *  @param index    The given index must be in the range [0, size), and
+         *                  the buffer will automatically adjust for the current
+         *                  position of the internal readIdx.
+         */
+        float readSample(int index) const;
+
+        /**
+         *  Copy every sample in readSample order to dest[0], dest[destStride],
+         *  dest[2 * destStride] and so on.
+         */
+        void copyTo(float* dest, int destStride) const;
+
+        /**
+         *  Return the number of writable samples available to this buffer
+         */
+        int size() const { return bufferSize; }
+
+    private:
+        int bufferSize;
+        int writeIdx;
+        int readIdx;
+
+        std::vector<float> buffer;
+    };
+
+    /**
+     *  Reduce a run of raw samples of a group, as ::reduceChannelGroup,
+     *  through the filter bank first if isFiltered
+     */
+    template <typename SampleType, bool isFiltered>
+    int reduceRunForChannelGroup(int begin, int end, const SampleType* const* inputs, const float* scales, int numSamples,
+                                 float spikeThresholdFactor, ThreadWorkspace& workspace, PixelColumnQueue& columns, int firstColumn);
+
+    /**
+     *  Stream a run of a channel's raw samples, no longer than the rest of
+     *  its pixel and segment, through its PixelAccumulator and
+     *  SpikeDetector, multiplying each sample by scale. If isFiltered,
+     *  filtered holds the run after the filter bank and is what they see.
+     */
+    template <typename SampleType, bool isFiltered>
+    void reduceSegmentForChannel(int channel, const SampleType* samples, const float* filtered, int numSamples, float scale);
+
+    /**
+     *  Adapt the spike detectors of the channels begin..end - 1 to the
+     *  baseline segment they have just completed, and start the next one
+     */
+    void completeSegmentForChannelGroup(int begin, int end, float spikeThresholdFactor);
+
+    /**
+     *  Write every metric of the pixel the channels begin..end - 1 have
+     *  just completed to column, and start their next pixel
+     */
+    void completePixelForChannelGroup(int begin, int end, float* column);
+
+    /** Write a channel's metrics for a pixel with these statistics to column */
+    void writePixelValues(float* column, int channel, const PixelStats& stats) const;
+
+    /**
+     *  Push a decimated raw sample, less the channel's offset, into its
+     *  FFT cache and slide its band power along
+     */
+    void pushBandPowerSample(int channel, float sample);
+
+    /**
+     *  Push numFrames decimated samples of the channels begin..end - 1,
+     *  interleaved as SpectralDecimator::process writes them, adding each
+     *  Welch segment the group completes on the way
+     */
+    void pushDecimatedFramesForChannelGroup(int begin, int end, const float* frames, int numFrames, ThreadWorkspace& workspace);
+
+    /**
+     *  Run the FFT over the caches of the channels begin..end - 1, which
+     *  have just completed a Welch segment, and add its spectra to welch
+     */
+    void addWelchSegmentForChannelGroup(int begin, int end, ThreadWorkspace& workspace);
+
+    /**
+     *  A channel's selected bin in dB: slid along every sample for a single
+     *  segment, and the Welch average otherwise
+     */
+    float getBandPowerForChannel(int channel) const;
+
+    int numChannels;
+    double sampleRate;
+    int baselineSamples;
+
+    /** Single-pass reduction for this CPU */
+    const PixelKernels* kernels;
+
+    /** The pixel in progress and the adaptive spike threshold of each channel */
+    std::vector<PixelAccumulator> pixelAccumulators;
+    std::vector<SpikeDetector> spikeDetectors;
+
+    /** Filters the raw samples ahead of the RMS and spike rate reductions */
+    BiquadFilterBank filterBank;
+
+    /** The FilterBand filterBank was designed for, or -1 after ::prepare */
+    int filterBankBand;
+
+    /** The sections of every FilterBand at sampleRate, designed by ::prepare */
+    std::vector<BiquadCoefficients> bandSections[NUM_FILTER_BANDS];
+
+    /** Low-passes and decimates the raw samples to the band power rate */
+    SpectralDecimator spectralDecimator;
+
+    /** Indexed by thread index */
+    std::vector<std::unique_ptr<ThreadWorkspace>> workspaces;
+
+    /**
+     *  Offset of each channel's raw signal, followed on its decimated
+     *  samples; the band power input is taken relative to it, so the
+     *  offset does not leak into the lowest bins
+     */
+    std::vector<float> rawOffsets;
+
+    std::vector<std::unique_ptr<FFTSampleCacheBuffer>> fftSampleCaches;
+
+    /**
+     *  The selected bin of every channel's FFT cache, slid along with it a
+     *  decimated sample at a time rather than transformed per pixel
+     */
+    SlidingDFTBank bandPowerDFT;
+
+    /**
+     *  Welch estimates of every SpectralBand and of the selected bin, from
+     *  the FFT caches transformed once per hop rather than once per pixel
+     */
+    WelchBandPower welch;
+
+    /** The FFT size, averages and hop welch was prepared for, or -1 after ::prepare */
+    int spectrumFFTSize;
+    int spectrumNumSegments;
+    int spectrumHopSize;
+
+    /** A channel's FFT cache, copied out to retune bandPowerDFT */
+    std::vector<float> spectrumScratch;
+};
+
+}
+
+#endif /* StreamAnalyser_hpp */
@@ -0,0 +1,252 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "SummaryPyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ProbeViewer;
+
+#pragma mark - SummaryBucket -
+
+float SummaryBucket::getRMS() const
+{
+    const float offset = mean - getMidpoint();
+
+    return std::sqrt(std::max(0.0f, variance + offset * offset));
+}
+
+SummaryBucket SummaryBucket::merge(const SummaryBucket& first, const SummaryBucket& second)
+{
+    const float halfDifference = (first.mean - second.mean) / 2.0f;
+
+    SummaryBucket merged;
+    merged.min = std::min(first.min, second.min);
+    merged.max = std::max(first.max, second.max);
+    merged.mean = (first.mean + second.mean) / 2.0f;
+    merged.variance = (first.variance + second.variance) / 2.0f + halfDifference * halfDifference;
+    merged.crossings = first.crossings + second.crossings;
+
+    return merged;
+}
+
+#pragma mark - SummaryPyramid -
+
+SummaryPyramid::SummaryPyramid()
+    : numChannels(0)
+    , baseBucketSize(1)
+    , numLevels(0)
+    , bucketsPerLevel(0)
+    , spikeThresholdFactor(4.5f)
+    , kernels(&getPixelKernels())
+    , bucketPhase(0)
+    , blockThresholdFactor(4.5f)
+    , buckets(nullptr)
+{ }
+
+bool SummaryPyramid::prepare(int numChannels_, int baseBucketSize_, int numLevels_, int bucketsPerLevel_, int refractorySamples)
+{
+    numChannels = std::max(0, numChannels_);
+    baseBucketSize = std::max(1, baseBucketSize_);
+    numLevels = std::max(0, numLevels_);
+    bucketsPerLevel = std::max(2, bucketsPerLevel_);
+
+    bucketPhase = 0;
+    blockBuckets.assign(numLevels, 0);
+
+    accumulators.assign(numChannels, Accumulator());
+
+    for (auto& acc : accumulators)
+    {
+        acc.hasBaseline = false;
+        acc.stats.reset(0.0f);
+        acc.detector.reset(refractorySamples);
+    }
+
+    cursors.reset(new RingBufferCursor[numLevels]);
+
+    for (int level = 0; level < numLevels; ++level)
+        cursors[level].reset(bucketsPerLevel);
+
+    // buckets are only read after they are written, so the arena is not cleared
+    const size_t numBuckets = size_t(numLevels) * bucketsPerLevel * numChannels;
+
+    if (!bucketMemory.reserve(MemoryArena::getPaddedSize(numBuckets * sizeof(SummaryBucket))))
+    {
+        release();
+        return false;
+    }
+
+    bucketMemory.rewind();
+
+    buckets = bucketMemory.allocateArray<SummaryBucket>(numBuckets);
+
+    return true;
+}
+
+void SummaryPyramid::release()
+{
+    numChannels = 0;
+    numLevels = 0;
+
+    std::vector<Accumulator>().swap(accumulators);
+    std::vector<int>().swap(blockBuckets);
+
+    cursors.reset();
+
+    bucketMemory.release();
+    buckets = nullptr;
+}
+
+void SummaryPyramid::setSpikeThresholdFactor(float thresholdFactor)
+{
+    spikeThresholdFactor.store(thresholdFactor, std::memory_order_relaxed);
+}
+
+void SummaryPyramid::beginBlock(int numSamples)
+{
+    blockThresholdFactor = spikeThresholdFactor.load(std::memory_order_relaxed);
+
+    // a bucket of level n completes whenever the level below completes an
+    // odd-numbered one, so the counts follow from the write positions
+    int64_t completedBelow = (bucketPhase + numSamples) / baseBucketSize;
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        blockBuckets[level] = int(completedBelow);
+        cursors[level].beginWrite(blockBuckets[level]);
+
+        const int64_t writePosition = cursors[level].getWritePosition();
+        completedBelow = ((writePosition + completedBelow) >> 1) - (writePosition >> 1);
+    }
+}
+
+void SummaryPyramid::addChannel(int channel, const float* samples, int numSamples)
+{
+    Accumulator& acc = accumulators[channel];
+
+    if (!acc.hasBaseline && numSamples > 0)
+    {
+        acc.stats.baseline = samples[0];
+        acc.hasBaseline = true;
+    }
+
+    int64_t position = cursors[0].getWritePosition();
+    int phase = bucketPhase;
+    int pos = 0;
+
+    while (pos < numSamples)
+    {
+        const int segmentEnd = pos + std::min(numSamples - pos, baseBucketSize - phase);
+
+        kernels->accumulate(acc.stats, acc.detector.getCrossingState(), samples + pos, segmentEnd - pos);
+
+        phase += segmentEnd - pos;
+        pos = segmentEnd;
+
+        if (phase == baseBucketSize)
+        {
+            completeBucket(channel, acc, position++);
+            phase = 0;
+        }
+    }
+
+    mergeLevels(channel);
+}
+
+void SummaryPyramid::completeBucket(int channel, Accumulator& acc, int64_t position)
+{
+    const PixelStats& stats = acc.stats;
+    const float n = float(stats.numSamples);
+    const float meanOffset = stats.sum / n;
+
+    SummaryBucket bucket;
+    bucket.min = stats.min;
+    bucket.max = stats.max;
+    bucket.mean = stats.baseline + meanOffset;
+    bucket.variance = std::max(0.0f, stats.sumSquares / n - meanOffset * meanOffset);
+    bucket.crossings = stats.crossings;
+
+    *getSlot(0, position, channel) = bucket;
+
+    acc.detector.update(stats, blockThresholdFactor);
+    acc.stats.reset(stats.getMidpoint());
+}
+
+void SummaryPyramid::mergeLevels(int channel)
+{
+    // bucket p of a level is the merge of buckets 2p and 2p + 1 below it
+    for (int level = 1; level < numLevels && blockBuckets[level] > 0; ++level)
+    {
+        const int64_t first = cursors[level].getWritePosition();
+
+        for (int64_t position = first; position < first + blockBuckets[level]; ++position)
+        {
+            *getSlot(level, position, channel) = SummaryBucket::merge(*getSlot(level - 1, 2 * position, channel),
+                                                                      *getSlot(level - 1, 2 * position + 1, channel));
+        }
+    }
+}
+
+void SummaryPyramid::finishBlock(int numSamples)
+{
+    for (int level = 0; level < numLevels; ++level)
+    {
+        cursors[level].endWrite(blockBuckets[level]);
+        blockBuckets[level] = 0;
+    }
+
+    bucketPhase = (bucketPhase + numSamples) % baseBucketSize;
+}
+
+int SummaryPyramid::getLevelForBucketSize(double samplesPerBucket) const
+{
+    const int level = int(std::lround(std::log2(std::max(1.0, samplesPerBucket / baseBucketSize))));
+
+    return std::max(0, std::min(numLevels - 1, level));
+}
+
+void SummaryPyramid::seekToLatest(int level, int numBuckets)
+{
+    RingBufferCursor& cursor = cursors[level];
+
+    cursor.seek(cursor.beginRead().end - numBuckets);
+}
+
+SummaryBucket* SummaryPyramid::getSlot(int level, int64_t position, int channel)
+{
+    const int slot = cursors[level].getIndexForPosition(position);
+    return buckets + (size_t(channel) * numLevels + level) * bucketsPerLevel + slot;
+}
+
+const SummaryBucket& SummaryPyramid::getBucket(int level, int64_t position, int channel) const
+{
+    const int slot = cursors[level].getIndexForPosition(position);
+    return buckets[(size_t(channel) * numLevels + level) * bucketsPerLevel + slot];
+}
+
+size_t SummaryPyramid::getMemoryFootprint() const
+{
+    return bucketMemory.getCapacity() + accumulators.capacity() * sizeof(Accumulator);
+}
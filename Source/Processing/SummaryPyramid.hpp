@@ -0,0 +1,175 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef SummaryPyramid_hpp
+#define SummaryPyramid_hpp
+
+#include "PixelKernels.hpp"
+#include "SpikeDetector.hpp"
+#include "../Utilities/MemoryArena.hpp"
+#include "../Utilities/RingBufferCursor.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  Summary of a run of one channel's samples: a base bucket, or a
+ *  power-of-two number of them.
+ *
+ *  Mean and variance (rather than raw sums) are kept so two buckets can be
+ *  merged exactly without a shared reference, and without the precision
+ *  loss of large float sums at the coarse levels.
+ */
+struct SummaryBucket
+{
+    float min;
+    float max;
+    float mean;
+    float variance;     // mean of (x - mean)^2
+    int crossings;      // threshold crossing events, see CrossingState
+
+    /** Midpoint between min and max, used as the DC reference of a pixel */
+    float getMidpoint() const { return (max + min) / 2.0f; }
+
+    /** RMS of the samples around the midpoint, as PixelStats::getRMS */
+    float getRMS() const;
+
+    /** Combine two buckets holding the same number of samples */
+    static SummaryBucket merge(const SummaryBucket& first, const SummaryBucket& second);
+};
+
+/**
+ *  Multi-resolution summaries of a stream: level n holds buckets of
+ *  baseBucketSize * 2^n samples, each the merge of two buckets of the
+ *  level below, in a ring that keeps at least one screen of them.
+ *
+ *  The base bucket is a pixel of the default window, reduced exactly as
+ *  PixelColumnReducer reduces one: relative to the midpoint of the bucket
+ *  before, with the spike detector adapted once per bucket. The levels
+ *  above only merge, so their spike rates are measured the same way.
+ *
+ *  Built incrementally on the audio thread as blocks arrive, so a zoom
+ *  change only has to read the level whose bucket size is closest to the
+ *  new samples-per-pixel. Each channel's buckets are stored together
+ *  ([channel][level][slot]), so a block writes and merges them in order.
+ *
+ *  Threading follows PixelColumnReducer: the audio thread calls
+ *  ::beginBlock, ::addChannel for every channel, then ::finishBlock; the
+ *  message thread reads one level at a time.
+ */
+class SummaryPyramid
+{
+public:
+    SummaryPyramid();
+
+    /**
+     *  Allocate storage for `bucketsPerLevel` buckets of every level and
+     *  rewind everything. Not thread-safe; call while the audio thread is
+     *  not feeding this object. Returns false, holding no storage, if the
+     *  buckets could not be reserved.
+     */
+    bool prepare(int numChannels, int baseBucketSize, int numLevels, int bucketsPerLevel, int refractorySamples);
+
+    /** Free all storage. */
+    void release();
+
+    bool isPrepared() const { return numChannels > 0 && numLevels > 0; }
+
+    /** Set the spike threshold in noise standard deviations. Any thread. */
+    void setSpikeThresholdFactor(float thresholdFactor);
+
+    // WRITER SIDE (audio thread)
+
+    void beginBlock(int numSamples);
+
+    void addChannel(int channel, const float* samples, int numSamples);
+
+    void finishBlock(int numSamples);
+
+    // READER SIDE (message thread)
+
+    int getNumLevels() const { return numLevels; }
+
+    /** Number of samples summarised by each bucket of a level */
+    int getBucketSize(int level) const { return baseBucketSize << level; }
+
+    /** Return the level whose bucket size is closest to samplesPerBucket */
+    int getLevelForBucketSize(double samplesPerBucket) const;
+
+    bool hasBucketsReady(int level) const { return cursors[level].hasItemsReady(); }
+
+    RingBufferCursor::Range beginRead(int level) { return cursors[level].beginRead(); }
+
+    bool endRead(int level, const RingBufferCursor::Range& range) { return cursors[level].endRead(range); }
+
+    /** Move a level's reader back so the next read returns its latest numBuckets buckets */
+    void seekToLatest(int level, int numBuckets);
+
+    const SummaryBucket& getBucket(int level, int64_t position, int channel) const;
+
+    size_t getMemoryFootprint() const;
+
+private:
+    struct Accumulator
+    {
+        PixelStats stats;   // relative to the midpoint of the previous bucket
+        SpikeDetector detector;
+        bool hasBaseline;
+    };
+    void completeBucket(int channel, Accumulator& acc, int64_t position);
+
+    /** Merge the buckets the block completed on every level above the base */
+    void mergeLevels(int channel);
+
+    SummaryBucket* getSlot(int level, int64_t position, int channel);
+
+    int numChannels;
+    int baseBucketSize;
+    int numLevels;
+    int bucketsPerLevel;
+
+    std::atomic<float> spikeThresholdFactor;
+
+    /** Single-pass reduction for this CPU */
+    const PixelKernels* kernels;
+
+    // writer state, shared by every channel of a stream
+    int bucketPhase;                    // samples already in the current base bucket
+    float blockThresholdFactor;
+    std::vector<int> blockBuckets;      // buckets completed per level by the block in progress
+
+    std::vector<Accumulator> accumulators;
+
+    std::unique_ptr<RingBufferCursor[]> cursors;
+
+    MemoryArena bucketMemory;
+    SummaryBucket* buckets;             // numChannels x numLevels x bucketsPerLevel
+};
+
+}
+
+#endif /* SummaryPyramid_hpp */
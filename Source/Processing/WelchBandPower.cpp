@@ -0,0 +1,152 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "WelchBandPower.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace ProbeViewer;
+
+#pragma mark - WelchBandPower -
+
+WelchBandPower::WelchBandPower()
+    : numSegments(1)
+    , maxNumSegments(1)
+    , hopSize(1)
+    , bin(0)
+{
+}
+
+void WelchBandPower::prepare(int numChannels, int fftSize, int numSegments_, int hopSize_, float sampleRate, int bin_)
+{
+    assert(numSegments_ >= 1 && hopSize_ >= 1);
+
+    bandMap.prepare(fftSize, sampleRate);
+
+    numSegments = numSegments_;
+    maxNumSegments = std::max(maxNumSegments, numSegments);
+    hopSize = hopSize_;
+    bin = bin_;
+
+    numChannels = std::max(0, numChannels);
+
+    countdowns.assign(numChannels, fftSize);
+    numCollected.assign(numChannels, 0);
+    numBinCollected.assign(numChannels, 0);
+    nextSlots.assign(numChannels, 0);
+
+    values.assign(size_t(numChannels) * maxNumSegments * numValues, 0.0f);
+}
+
+void WelchBandPower::reserve(int numChannels, int maxNumSegments_)
+{
+    maxNumSegments = std::max(maxNumSegments, maxNumSegments_);
+
+    countdowns.reserve(numChannels);
+    numCollected.reserve(numChannels);
+    numBinCollected.reserve(numChannels);
+    nextSlots.reserve(numChannels);
+
+    values.reserve(size_t(numChannels) * maxNumSegments * numValues);
+}
+
+void WelchBandPower::setAveraging(int numSegments_, int hopSize_)
+{
+    assert(numSegments_ >= 1 && numSegments_ <= maxNumSegments && hopSize_ >= 1);
+
+    numSegments = numSegments_;
+    hopSize = hopSize_;
+
+    // a channel still filling its first segment needs all of it
+    for (size_t channel = 0; channel < countdowns.size(); ++channel)
+    {
+        if (numCollected[channel] > 0)
+            countdowns[channel] = std::min(countdowns[channel], hopSize);
+    }
+}
+
+void WelchBandPower::setBin(int bin_)
+{
+    bin = bin_;
+    std::fill(numBinCollected.begin(), numBinCollected.end(), 0);
+}
+
+void WelchBandPower::advance(int channel, int numSamples)
+{
+    assert(numSamples <= countdowns[channel]);
+
+    countdowns[channel] -= numSamples;
+}
+
+void WelchBandPower::addSegment(int begin, int numGroupChannels, const float* power, int numLanes)
+{
+    for (int lane = 0; lane < numGroupChannels; ++lane)
+    {
+        const int channel = begin + lane;
+        assert(countdowns[channel] == 0);
+
+        float* segment = values.data() + (size_t(channel) * maxNumSegments + nextSlots[channel]) * numValues;
+
+        for (int band = 0; band < NUM_SPECTRAL_BANDS; ++band)
+            segment[band] = bandMap.getMeanPower(power, numLanes, lane, SpectralBand(band));
+
+        segment[binValue] = power[bin * numLanes + lane];
+
+        nextSlots[channel] = (nextSlots[channel] + 1) % maxNumSegments;
+        numCollected[channel] = std::min(maxNumSegments, numCollected[channel] + 1);
+        numBinCollected[channel] = std::min(maxNumSegments, numBinCollected[channel] + 1);
+        countdowns[channel] = hopSize;
+    }
+}
+
+float WelchBandPower::getBandPower(int channel, SpectralBand band) const
+{
+    return getMean(channel, int(band), std::min(numSegments, numCollected[channel]));
+}
+
+float WelchBandPower::getBinPower(int channel) const
+{
+    return getMean(channel, binValue, std::min(numSegments, numBinCollected[channel]));
+}
+
+float WelchBandPower::getMean(int channel, int value, int numRecent) const
+{
+    if (numRecent == 0)
+        return std::numeric_limits<float>::quiet_NaN();
+
+    // the ring's newest segments sit just before the next slot
+    const float* segments = values.data() + size_t(channel) * maxNumSegments * numValues;
+    int slot = nextSlots[channel];
+    float sum = 0.0f;
+
+    for (int i = 0; i < numRecent; ++i)
+    {
+        slot = slot == 0 ? maxNumSegments - 1 : slot - 1;
+        sum += segments[slot * numValues + value];
+    }
+
+    return bandMap.toDecibels(sum / numRecent);
+}
@@ -0,0 +1,142 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef WelchBandPower_hpp
+#define WelchBandPower_hpp
+
+#include "SpectralBands.hpp"
+
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  Welch estimates of the power of every SpectralBand and of one selected
+ *  bin, for every channel of a stream, from overlapping segments of its
+ *  decimated samples.
+ *
+ *  A segment of fftSize samples completes every hopSize samples. The caller
+ *  transforms it once, e.g. with a BatchedFFT for a group of channels, and
+ *  hands the spectra to ::addSegment, which keeps only the mean power of
+ *  each band and the power of the selected bin. The estimate is the mean of
+ *  the last numSegments segments. So a segment is transformed once, however
+ *  many estimates it takes part in, and the FFT rate follows the hop rather
+ *  than the pixel rate: larger sizes cost little more per second.
+ *
+ *  The channels of a stream are decimated in step, so they complete their
+ *  segments together:
+ *
+ *      // after each decimated sample of each channel of a group
+ *      welch.advance(channel, 1);
+ *      ...
+ *      if (welch.getSamplesToSegmentEnd(begin) == 0)
+ *          welch.addSegment(begin, numGroupChannels, fft.computePowerSpectrum(), BatchedFFT::numLanes);
+ */
+class WelchBandPower
+{
+public:
+    WelchBandPower();
+
+    /**
+     *  Average numSegments segments (at least 1) of fftSize samples,
+     *  hopSize samples apart, of numChannels channels decimated to
+     *  sampleRate. Every channel starts without segments, its first one
+     *  completing after fftSize samples, so the estimate restarts.
+     */
+    void prepare(int numChannels, int fftSize, int numSegments, int hopSize, float sampleRate, int bin);
+
+    /**
+     *  Allocate for numChannels channels and up to maxNumSegments segments,
+     *  so ::prepare within them does not, and keep that many segments of
+     *  every channel from then on
+     */
+    void reserve(int numChannels, int maxNumSegments);
+
+    /**
+     *  Average numSegments segments, at most ::getMaxNumSegments, hopSize
+     *  samples apart, from the next estimate on. Unlike ::prepare this
+     *  keeps the segments collected so far and each channel's progress
+     *  towards its next one; a shorter hop only brings that one forward.
+     */
+    void setAveraging(int numSegments, int hopSize);
+
+    int getNumChannels() const { return int(countdowns.size()); }
+    int getFFTSize() const { return bandMap.getFFTSize(); }
+    int getNumSegments() const { return numSegments; }
+    int getMaxNumSegments() const { return maxNumSegments; }
+    int getHopSize() const { return hopSize; }
+    int getBin() const { return bin; }
+
+    const BandPowerMap& getBandMap() const { return bandMap; }
+
+    /** Report another bin; the segments from before do not count towards it */
+    void setBin(int bin);
+
+    /** Decimated samples a channel still needs to complete its segment */
+    int getSamplesToSegmentEnd(int channel) const { return countdowns[channel]; }
+
+    /** Count numSamples decimated samples of a channel, at most ::getSamplesToSegmentEnd */
+    void advance(int channel, int numSamples);
+
+    /**
+     *  Add the segment the channels begin..begin + numGroupChannels - 1 have
+     *  just completed, given its power spectra ([bin][lane] with numLanes
+     *  lanes, as BatchedFFT::computePowerSpectrum), and start their next one
+     */
+    void addSegment(int begin, int numGroupChannels, const float* power, int numLanes);
+
+    /**
+     *  A channel's averaged power of a band in dB, or NaN before its first
+     *  segment or when the FFT size does not resolve the band
+     */
+    float getBandPower(int channel, SpectralBand band) const;
+
+    /** A channel's averaged power of the selected bin in dB, or NaN before a segment since ::setBin */
+    float getBinPower(int channel) const;
+
+private:
+    // the mean power of each band, then the power of the selected bin
+    static constexpr int numValues = NUM_SPECTRAL_BANDS + 1;
+    static constexpr int binValue = NUM_SPECTRAL_BANDS;
+
+    float getMean(int channel, int value, int numRecent) const;
+
+    BandPowerMap bandMap;
+
+    int numSegments;
+    int maxNumSegments;
+    int hopSize;
+    int bin;
+
+    std::vector<int> countdowns;
+    std::vector<int> numCollected;      // segments, up to maxNumSegments
+    std::vector<int> numBinCollected;   // segments since ::setBin, up to maxNumSegments
+    std::vector<int> nextSlots;
+
+    std::vector<float> values;          // [channel][slot][value], a ring of maxNumSegments segments per channel
+};
+
+}
+
+#endif /* WelchBandPower_hpp */
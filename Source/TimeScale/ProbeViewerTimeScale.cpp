@@ -60,12 +60,12 @@ void ProbeViewerTimeScale::paint(Graphics& g)
         if (division % 4 == 0)
         {
             g.drawLine(xOffset, 0, xOffset, getHeight(), 3);
-            g.drawText(String(division * resolution), xOffset + 6, getHeight()-15, 100, 15, Justification::left, false);
+            g.drawText(String(std::round(division * resolution * 100.0f) / 100.0f), xOffset + 6, getHeight()-15, 100, 15, Justification::left, false);
         }
         else if (division % 2 == 0)
         {
             g.drawLine(xOffset, getHeight() / 2, xOffset, getHeight(), 3);
-            g.drawText(String(division * resolution), xOffset + 6, getHeight()-15, 100, 15, Justification::left, false);
+            g.drawText(String(std::round(division * resolution * 100.0f) / 100.0f), xOffset + 6, getHeight()-15, 100, 15, Justification::left, false);
         }
         else
         {
@@ -81,3 +81,10 @@ void ProbeViewerTimeScale::setMarginOffset(float marginOffset)
 {
     marginWidth = marginOffset;
 }
+
+void ProbeViewerTimeScale::setTimeScale(float timeScale_, float resolution_)
+{
+    timeScale = timeScale_;
+    resolution = resolution_;
+    repaint();
+}
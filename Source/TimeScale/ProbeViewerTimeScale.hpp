@@ -39,6 +39,9 @@ public:
 
     void setMarginOffset(float marginOffset);
 
+    /** Set the window shown, in seconds, and the spacing of its divisions */
+    void setTimeScale(float timeScale, float resolution);
+
 private:
     float timeScale;
     float resolution;
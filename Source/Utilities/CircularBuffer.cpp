@@ -25,16 +25,36 @@
 
 using namespace ProbeViewer;
 
+namespace
+{
+// the pyramid's base bucket is a pixel of the default window, so its
+// levels span 10 s to 5 min 20 s across the display; shorter windows are
+// reduced from the raw samples
+const int pyramidNumLevels = 6;
+
+// room for the buckets of one block on top of a screen of them
+const int pyramidBlockHeadroomSamples = 16384;
+
+// referenced blocks are stored in parts of this many samples, each still
+// in cache from referencing when it is copied and reduced
+const int referenceBlockSamples = 256;
+}
+
 CircularBuffer::CircularBuffer(int id_, float sampleRate_, int bufferLengthInSec) : 
-    samplesReadyForDrawing(false),
     id(id_),
     sampleRate(sampleRate_),
-    isNeeded(true)
+    isNeeded(true),
+    ingestMode(IngestMode::RAW_SAMPLES),
+    ingestEnabled(false),
+    sampleStorage(SampleStorage::FLOAT32),
+    samplesPerPixel(1),
+    spectralSampleRate(0.0f),
+    numPixelColumns(0)
 {
     numChannels = 0;
     previousSize = 0;
+    resetDropStatistics();
     bufferLengthSamples = sampleRate * bufferLengthInSec;
-    dataBuffer = std::make_unique<AudioSampleBuffer>();
 }
 
 CircularBuffer::~CircularBuffer()
@@ -43,6 +63,9 @@ CircularBuffer::~CircularBuffer()
 
 void CircularBuffer::prepareToUpdate()
 {
+    // not acquiring here, so the audio thread cannot be inside addBlock
+    setIngestEnabled(false);
+
     previousSize = numChannels;
     numChannels = 0;
     isNeeded = false;
@@ -105,99 +128,278 @@ void CircularBuffer::updateChannelInfo(Array<ContinuousChannel*> channels)
 
     }
 
-}
+    // the scale of each row follows its channel through the depth ordering
+    rowBitVolts.clear();
+    rowBitVolts.insertMultiple(0, 1.0f, numChannels);
+    rowVoltsToBits.clear();
+    rowVoltsToBits.insertMultiple(0, 1.0f, numChannels);
 
+    for (int i = 0; i < numChannels; i++)
+    {
+        const float bitVolts = channels[i]->getBitVolts();
+
+        if (bitVolts > 0)
+        {
+            rowBitVolts.set(channelOrder[i], bitVolts);
+            rowVoltsToBits.set(channelOrder[i], 1.0f / bitVolts);
+        }
+    }
+
+}
 
-void CircularBuffer::update()
+void CircularBuffer::setIngestMode(IngestMode mode)
 {
+    ingestMode = mode;
+}
 
-    dataBuffer->setSize(numChannels, bufferLengthSamples);
-    dataBuffer->clear();
+void CircularBuffer::setSampleStorage(SampleStorage storage)
+{
+    sampleStorage = storage;
+}
 
-    readIndex.clear();
-    readIndex.insertMultiple(0, 0, numChannels);
-    
-    writeIndex.clear();
-    writeIndex.insertMultiple(0, 0, numChannels);
+void CircularBuffer::setPixelColumnLayout(int samplesPerPixel_, float spectralSampleRate_, int numColumns)
+{
+    samplesPerPixel = samplesPerPixel_;
+    spectralSampleRate = spectralSampleRate_;
+    numPixelColumns = numColumns;
 }
 
-int CircularBuffer::getChannelReadIndex(int channel) const
+void CircularBuffer::setSpikeThresholdFactor(float thresholdFactor)
 {
-    return readIndex[channel];
+    pixelColumns.setSpikeThresholdFactor(thresholdFactor);
+    summaryPyramid.setSpikeThresholdFactor(thresholdFactor);
 }
 
-int CircularBuffer::getNumSamplesReadyForDrawing(int channel) const
+bool CircularBuffer::update(bool keepPixelColumns)
 {
-    int numSamples = writeIndex[channel] - readIndex[channel];
-    if (numSamples < 0)
+    bool isAllocated;
+
+    // only one of the storage forms is kept, the others are freed; the
+    // active one keeps its memory across updates if it is large enough
+    if (ingestMode == IngestMode::RAW_SAMPLES)
+    {
+        isAllocated = ring.prepare(numChannels, bufferLengthSamples, sampleStorage);
+
+        if (!keepPixelColumns)
+            pixelColumns.release();
+
+        isAllocated &= summaryPyramid.prepare(numChannels, samplesPerPixel, pyramidNumLevels,
+                                              numPixelColumns + pyramidBlockHeadroomSamples / jmax(1, samplesPerPixel) + 1,
+                                              SpikeDetector::getRefractorySamples(sampleRate));
+    }
+    else
+    {
+        ring.release();
+        summaryPyramid.release();
+        isAllocated = pixelColumns.prepare(numChannels, samplesPerPixel, sampleRate, spectralSampleRate, numPixelColumns,
+                                           SpikeDetector::getRefractorySamples(sampleRate));
+    }
+
+    isAllocated &= referencer.prepare(numChannels, referenceBlockSamples);
+    rowSources.assign(numChannels, nullptr);
+
+    cursor.reset(ingestMode == IngestMode::RAW_SAMPLES ? bufferLengthSamples : 0);
+
+    // the audio thread must never be handed a null row or column, so a
+    // buffer that did not get all of its storage is not written at all
+    if (!isAllocated)
     {
-        numSamples = bufferLengthSamples - 1 - readIndex[channel] + writeIndex[channel] - 1;
+        setIngestEnabled(false);
+        releaseStorage();
     }
-    
-    return numSamples;
+
+    return isAllocated;
+}
+
+void CircularBuffer::releaseStorage()
+{
+    ring.release();
+    pixelColumns.release();
+    summaryPyramid.release();
+    referencer.release();
+
+    cursor.reset(0);
+}
+
+void CircularBuffer::releasePixelColumns()
+{
+    jassert(ingestMode == IngestMode::RAW_SAMPLES);
+
+    pixelColumns.release();
 }
 
 bool CircularBuffer::hasSamplesReadyForDrawing() const
 {
-    return samplesReadyForDrawing.get();
+    if (ingestMode == IngestMode::PIXEL_COLUMNS)
+        return pixelColumns.hasColumnsReady();
+
+    return cursor.hasItemsReady();
 }
 
-void CircularBuffer::clearSamplesReadyForDrawing()
+CircularBuffer::ReadRange CircularBuffer::beginRead()
 {
-    samplesReadyForDrawing.set(false);
-    
-    for (int i = 0; i < readIndex.size(); ++i)
-    {
-        readIndex.set(i, writeIndex[i]);
-    }
+    const ReadRange range = cursor.beginRead();
+
+    if (range.overrun)
+        recordOverrun(range.numSkipped, range.numSkipped / jmax(1, samplesPerPixel));
+
+    return range;
+}
+
+bool CircularBuffer::isRangeIntact(const ReadRange& range) const
+{
+    return cursor.isRangeIntact(range);
+}
+
+bool CircularBuffer::endRead(const ReadRange& range)
+{
+    return commitRead(range, range.getLength());
+}
+
+bool CircularBuffer::commitRead(const ReadRange& range, int numSamples)
+{
+    const bool intact = cursor.commitRead(range, numSamples);
+
+    if (!intact)
+        ++numTornReads;
+
+    return intact;
+}
+
+template <typename SampleType>
+CircularBuffer::ChannelSpans<SampleType> CircularBuffer::getSpans(const ReadRange& range, int channel) const
+{
+    jassert(channel < numChannels);
+
+    return ring.getSpans<SampleType>(channel, cursor.getIndexForPosition(range.start), range.getLength());
+}
+
+CircularBuffer::ChannelSpans<float> CircularBuffer::getFloatSpans(const ReadRange& range, int channel) const
+{
+    jassert(sampleStorage == SampleStorage::FLOAT32);
+
+    return getSpans<float>(range, channel);
+}
+
+CircularBuffer::ChannelSpans<int16> CircularBuffer::getInt16Spans(const ReadRange& range, int channel) const
+{
+    jassert(sampleStorage == SampleStorage::INT16);
+
+    return getSpans<int16>(range, channel);
+}
+
+CircularBuffer::ReadRange CircularBuffer::beginPixelColumnRead()
+{
+    const ReadRange range = pixelColumns.beginRead();
+
+    // in raw mode these are background columns, which nobody was reading
+    if (range.overrun && ingestMode == IngestMode::PIXEL_COLUMNS)
+        recordOverrun(range.numSkipped * samplesPerPixel, range.numSkipped);
+
+    return range;
+}
+
+bool CircularBuffer::endPixelColumnRead(const ReadRange& range)
+{
+    const bool intact = pixelColumns.endRead(range);
+
+    if (!intact)
+        ++numTornReads;
+
+    return intact;
+}
+
+CircularBuffer::DropStatistics CircularBuffer::getDropStatistics() const
+{
+    DropStatistics statistics;
+
+    statistics.numOverruns = numOverruns.load();
+    statistics.numDroppedSamples = numDroppedSamples.load();
+    statistics.numDroppedPixels = numDroppedPixels.load();
+    statistics.numTornReads = numTornReads.load();
+
+    return statistics;
+}
+
+void CircularBuffer::resetDropStatistics()
+{
+    numOverruns = 0;
+    numDroppedSamples = 0;
+    numDroppedPixels = 0;
+    numTornReads = 0;
+}
+
+void CircularBuffer::recordOverrun(int64 numSamples, int64 numPixels)
+{
+    ++numOverruns;
+    numDroppedSamples += numSamples;
+    numDroppedPixels += numPixels;
 }
 
+void CircularBuffer::clearSamplesReadyForDrawing()
+{
+    cursor.skipToEnd();
+    pixelColumns.skipToEnd();
+}
 
-void CircularBuffer::addData(AudioBuffer<float>& input, int localChanId, int globalChanId, int numSamples)
+void CircularBuffer::addBlock(const AudioBuffer<float>& input, int firstGlobalChannel, int numInputChannels, int numSamples)
 {
-    samplesReadyForDrawing.set(true);
-    ScopedLock dataLock(dataMutex);    
+    jassert(numInputChannels <= numChannels);
+
+    for (int chan = 0; chan < numInputChannels; ++chan)
+        rowSources[channelOrder[chan]] = input.getReadPointer(firstGlobalChannel + chan);
 
-    const int samplesLeft = bufferLengthSamples - writeIndex[localChanId];
+    const ReferenceMode referenceMode = referencer.getMode();
 
-    if (numSamples < samplesLeft)
+    // the reference needs every row of the stream
+    if (referenceMode == ReferenceMode::NONE || numInputChannels != numChannels)
     {
-        dataBuffer->copyFrom(channelOrder[localChanId], // dest channel
-            writeIndex[localChanId],      // dest startSample
-            input,                         // source
-            globalChanId,                  // source channel
-            0,                             // source start sample
-            numSamples);                   // num samples
-
-        writeIndex.set(localChanId, writeIndex[localChanId] + numSamples);
+        addRows(rowSources.data(), numSamples);
+        return;
     }
-    else
+
+    const float** sources = rowSources.data();
+
+    for (int first = 0; first < numSamples; first += referencer.getMaxBlockSamples())
     {
-        const int extraSamples = numSamples - samplesLeft;
-
-        dataBuffer->copyFrom(channelOrder[localChanId],
-            writeIndex[localChanId],
-            input,
-            globalChanId,
-            0,
-            samplesLeft);
-
-        dataBuffer->copyFrom(channelOrder[localChanId],
-            0,
-            input,
-            globalChanId,
-            samplesLeft,
-            extraSamples);
-
-        writeIndex.set(localChanId, extraSamples);
+        const int partSamples = jmin(referencer.getMaxBlockSamples(), numSamples - first);
+
+        addRows(referencer.process(sources, partSamples, referenceMode), partSamples);
+
+        for (int row = 0; row < numChannels; ++row)
+            sources[row] += partSamples;
     }
 }
 
-float CircularBuffer::getSample(int sampIdx, int channel) const
+void CircularBuffer::addRows(const float* const* rows, int numSamples)
 {
-    int localIdx = sampIdx + readIndex[channel];
-    
-    if (localIdx >= bufferLengthSamples) localIdx -= bufferLengthSamples;
-    
-    return dataBuffer->getSample(channel, localIdx);
+    if (ingestMode == IngestMode::PIXEL_COLUMNS)
+    {
+        pixelColumns.beginBlock(numSamples);
+
+        for (int first = 0; first < numChannels; first += SpectralDecimator::numLanes)
+            pixelColumns.addChannelGroup(first, jmin(SpectralDecimator::numLanes, numChannels - first), rows + first, numSamples);
+
+        pixelColumns.finishBlock(numSamples);
+        return;
+    }
+
+    cursor.beginWrite(numSamples);
+    summaryPyramid.beginBlock(numSamples);
+
+    // the rows share the ring's write index, so they all wrap at the same sample
+    for (int row = 0; row < numChannels; ++row)
+    {
+        const float* source = rows[row];
+
+        if (source == nullptr)
+            continue;
+
+        ring.writeRow(row, source, rowVoltsToBits.getReference(row), numSamples);
+        summaryPyramid.addChannel(row, source, numSamples);
+    }
+
+    summaryPyramid.finishBlock(numSamples);
+    cursor.endWrite(numSamples);
+    ring.advance(numSamples);
 }
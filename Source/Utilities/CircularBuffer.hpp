@@ -26,8 +26,26 @@
 
 #include "VisualizerWindowHeaders.h"
 
+#include "RingBufferCursor.hpp"
+#include "SampleRing.hpp"
+#include "../Processing/ChannelReferencer.hpp"
+#include "../Processing/PixelColumnReducer.hpp"
+#include "../Processing/SummaryPyramid.hpp"
+
 namespace ProbeViewer {
 
+/**
+ *  How incoming blocks are stored for the display.
+ */
+enum class IngestMode : int
+{
+    /** Keep every raw sample of the last bufferLengthSec seconds */
+    RAW_SAMPLES,
+
+    /** Reduce on the audio thread and keep only completed pixel columns */
+    PIXEL_COLUMNS
+};
+
 class CircularBuffer
 {
 public:
@@ -37,54 +55,215 @@ public:
     /** Resets buffer*/
     void prepareToUpdate();
 
-    /** Updates buffer settings*/
-    void update();
+    /**
+     *  Allocate the storage for the current settings. Pass keepPixelColumns
+     *  when switching a stream from IngestMode::PIXEL_COLUMNS to
+     *  IngestMode::RAW_SAMPLES, so the columns gathered so far can still be
+     *  drawn before the raw samples; see ::releasePixelColumns.
+     *
+     *  Ingest must be disabled (and the audio thread out of ::addBlock)
+     *  while this is called. Returns false if any of the storage could
+     *  not be reserved, in which case everything is freed and ingest must
+     *  stay disabled.
+     */
+    bool update(bool keepPixelColumns = false);
+
+    /**
+     *  Free all storage. Ingest must be disabled (and the audio thread out
+     *  of ::addBlock) while this is called.
+     */
+    void releaseStorage();
+
+    /**
+     *  Free the pixel columns kept by ::update while in
+     *  IngestMode::RAW_SAMPLES. Safe while ingesting, because the audio
+     *  thread does not touch the columns in that mode.
+     */
+    void releasePixelColumns();
+
+    /**
+     *  Enable or disable writing in ::addBlock. A buffer is created
+     *  disabled; the owner enables it once its storage has been allocated.
+     */
+    void setIngestEnabled(bool shouldIngest) { ingestEnabled.store(shouldIngest); }
+
+    /**
+     *  Returns whether ::addBlock should be called for this buffer. Called
+     *  on the audio thread at the start of each block.
+     */
+    bool isIngestEnabled() const { return ingestEnabled.load(); }
 
     /** Sets the channel number and depth*/
     void updateChannelInfo(Array<ContinuousChannel*> channels);
 
     /**
-     *  Return the current location of the read point for a specific channel.
+     *  Set how blocks are stored. Takes effect on the next call to ::update.
      */
-    int getChannelReadIndex(int channel) const;
+    void setIngestMode(IngestMode mode);
+
+    IngestMode getIngestMode() const { return ingestMode; }
 
     /**
-     *  Return the number of samples that are fresh since the last time
-     *  ::clearSamplesReadyForDrawing was called.
+     *  Set the sample format used in IngestMode::RAW_SAMPLES. Takes effect on
+     *  the next call to ::update.
      */
-    int getNumSamplesReadyForDrawing(int channel) const;
+    void setSampleStorage(SampleStorage storage);
+
+    SampleStorage getSampleStorage() const { return sampleStorage; }
+
+    /**
+     *  Set the pixel layout used in IngestMode::PIXEL_COLUMNS: the number of
+     *  samples reduced into each column, the rate the samples kept for band
+     *  power are decimated to, and the number of columns retained. The
+     *  summary pyramid of IngestMode::RAW_SAMPLES starts from the same
+     *  pixels. Takes effect on the next call to ::update.
+     */
+    void setPixelColumnLayout(int samplesPerPixel, float spectralSampleRate, int numColumns);
+
+    /**
+     *  Return the pixel column reducer, which holds the data in
+     *  IngestMode::PIXEL_COLUMNS.
+     */
+    PixelColumnReducer* getPixelColumns() { return &pixelColumns; }
+
+    /**
+     *  Return the multi-resolution summaries kept alongside the raw samples
+     *  in IngestMode::RAW_SAMPLES, for windows longer than the default one.
+     */
+    SummaryPyramid* getSummaryPyramid() { return &summaryPyramid; }
+
+    /**
+     *  Set the spike threshold, in noise standard deviations of each
+     *  channel, applied while reducing in IngestMode::PIXEL_COLUMNS and in
+     *  the summary pyramid. May be called from any thread.
+     */
+    void setSpikeThresholdFactor(float thresholdFactor);
+
+    /**
+     *  Set the reference subtracted from every channel before it is stored
+     *  or reduced. Takes effect at the next block; may be called from any
+     *  thread.
+     */
+    void setReferenceMode(ReferenceMode mode) { referencer.setMode(mode); }
+
+    ReferenceMode getReferenceMode() const { return referencer.getMode(); }
+
+    /**
+     *  A consistent snapshot of the samples that can be read from this
+     *  buffer, taken with ::beginRead and released with ::endRead.
+     *
+     *  Positions are monotonically increasing sample counts since the last
+     *  call to ::update, so they never wrap.
+     */
+    typedef RingBufferCursor::Range ReadRange;
 
     /**
      *  Returns a value indicating whether or not this CircularBuffer has
-     *  fresh samples since the last time ::clearSamplesReadyForDrawing
-     *  was called.
+     *  fresh samples (or pixel columns) since the last call to ::endRead or
+     *  ::clearSamplesReadyForDrawing.
      */
     bool hasSamplesReadyForDrawing() const;
 
     /**
-     *  Clears the flag and internal state that holds a set of samples and
-     *  advertises them as ready to be drawn with ::hasSamplesReadyForDrawing.
+     *  Take a snapshot of the samples that are ready to be drawn. Samples
+     *  written after this call are not part of the range and stay available
+     *  for the next read.
+     *
+     *  If the writer has lapped the reader, the range is fast-forwarded to
+     *  the oldest sample that is still intact and ReadRange::overrun is set.
      */
-    void clearSamplesReadyForDrawing();
+    ReadRange beginRead();
 
-     /** Adds continuous data*/
-    void addData(AudioBuffer<float>& buffer, int localChanId, int globalChanId, int nSamples);
+    /**
+     *  Returns false if the writer has started overwriting any part of the
+     *  given range since ::beginRead was called, meaning samples read from it
+     *  may be corrupt.
+     */
+    bool isRangeIntact(const ReadRange& range) const;
 
     /**
-     *  Return a single sample at a specific index and from a specific channel.
-     *
-     *  Sample-wise reading should only be done after getting this object's
-     *  mutex from ::getMutex below.
+     *  Mark every sample in the given range as read. Returns the result of
+     *  ::isRangeIntact for the range.
+     */
+    bool endRead(const ReadRange& range);
+
+    /**
+     *  Mark only the first numSamples samples of the range as read. The rest
+     *  are the start of the next ::beginRead range, so a reader that can only
+     *  use whole pixels leaves the incomplete one in place instead of copying
+     *  it out. Returns the result of ::isRangeIntact for the range.
+     */
+    bool commitRead(const ReadRange& range, int numSamples);
+
+    /**
+     *  Take a snapshot of the pixel columns that are ready to be drawn, like
+     *  ::beginRead does for raw samples. Overruns are recorded in the drop
+     *  statistics, except for the background columns drawn in
+     *  IngestMode::RAW_SAMPLES right after a stream switch.
+     */
+    ReadRange beginPixelColumnRead();
+
+    /**
+     *  Mark the given pixel columns as read. Returns false if they were
+     *  overwritten while being read.
+     */
+    bool endPixelColumnRead(const ReadRange& range);
+
+    /**
+     *  What the display lost since the last call to ::resetDropStatistics.
+     */
+    struct DropStatistics
+    {
+        /** Reads that found the writer had lapped the reader */
+        int64 numOverruns = 0;
+
+        int64 numDroppedSamples = 0;
+        int64 numDroppedPixels = 0;
+
+        /** Ranges that were overwritten while being drawn */
+        int64 numTornReads = 0;
+    };
+
+    /** May be called from any thread */
+    DropStatistics getDropStatistics() const;
+
+    void resetDropStatistics();
+
+    /**
+     *  Discard all raw samples and pixel columns that are currently ready
+     *  to be drawn, without counting them as dropped.
      */
-    float getSample(int sampIdx, int channel) const;
+    void clearSamplesReadyForDrawing();
 
     /**
-     *  Return the mutex for locking the internal data buffer during sample read
-     *  access.
+     *  Copy one block of a stream into the buffer and publish it to the
+     *  reader. The stream's channels must occupy numChannels contiguous
+     *  channels of the input buffer, starting at firstGlobalChannel.
      *
-     *  This is not necessary to use when using ::pushBuffer, as it locks itself.
+     *  Called on the audio thread only.
+     */
+    void addBlock(const AudioBuffer<float>& buffer, int firstGlobalChannel, int numChannels, int nSamples);
+
+    /**
+     *  One channel's samples in a ReadRange, as at most two contiguous runs:
+     *  the part before the ring wraps, then the part after it (empty unless
+     *  the range wraps). The runs point into the ring itself and stay valid
+     *  until the range is committed.
      */
-    CriticalSection* getMutex() { return &dataMutex; }
+    template <typename SampleType>
+    using ChannelSpans = SampleRing::Spans<SampleType>;
+
+    /** Return the samples of a display row in the range; SampleStorage::FLOAT32 only */
+    ChannelSpans<float> getFloatSpans(const ReadRange& range, int channel) const;
+
+    /**
+     *  Return the samples of a display row in the range, in units of
+     *  ::getBitVolts; SampleStorage::INT16 only
+     */
+    ChannelSpans<int16> getInt16Spans(const ReadRange& range, int channel) const;
+
+    /** Return the scale of a display row's int16 samples */
+    float getBitVolts(int channel) const { return rowBitVolts[channel]; }
 
     int id;
     int bufferLengthSamples;
@@ -92,20 +271,57 @@ public:
     bool isNeeded;
 
 private:
-    std::unique_ptr<AudioBuffer<float>> dataBuffer;
+    /**
+     *  Raw samples, one row per display channel with every row holding
+     *  bufferLengthSamples floats or int16s (per ::sampleStorage). Its
+     *  write index follows the cursor's write position.
+     */
+    SampleRing ring;
 
-    Array<int> readIndex;
-    Array<int> writeIndex;
-	Array<bool> shouldDraw;
+    template <typename SampleType>
+    ChannelSpans<SampleType> getSpans(const ReadRange& range, int channel) const;
+
+    SampleStorage sampleStorage;
+
+    /** bitVolts of each row, and its inverse for quantizing */
+    Array<float> rowBitVolts;
+    Array<float> rowVoltsToBits;
+
+    RingBufferCursor cursor;
+
+    IngestMode ingestMode;
+
+    std::atomic<bool> ingestEnabled;
+
+    PixelColumnReducer pixelColumns;
+    SummaryPyramid summaryPyramid;
+
+    ChannelReferencer referencer;
+
+    /** The input channel of each display row for the block in ::addBlock */
+    std::vector<const float*> rowSources;
+
+    /**
+     *  Store and reduce numSamples samples of every display row, reading
+     *  row r from rows[r] (skipped if null), and publish them
+     */
+    void addRows(const float* const* rows, int numSamples);
+    int samplesPerPixel;
+    float spectralSampleRate;
+    int numPixelColumns;
 
-    Atomic<int> samplesReadyForDrawing;
     Array<int> channelOrder;
 
     int numChannels;
     int previousSize;
 
-    CriticalSection dataMutex;
+    /** Add one overrun to the drop statistics */
+    void recordOverrun(int64 numSamples, int64 numPixels);
 
+    std::atomic<int64> numOverruns;
+    std::atomic<int64> numDroppedSamples;
+    std::atomic<int64> numDroppedPixels;
+    std::atomic<int64> numTornReads;
 };
 }
 
@@ -0,0 +1,1374 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "ColourMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ProbeViewer;
+
+namespace
+{
+const ColourMapEntry infernoEntries[ColourMap::numEntries] =
+{
+    { 0.001462f, 0.000466f, 0.013866f },
+    { 0.002267f, 0.00127f, 0.01857f },
+    { 0.003299f, 0.002249f, 0.024239f },
+    { 0.004547f, 0.003392f, 0.030909f },
+    { 0.006006f, 0.004692f, 0.038558f },
+    { 0.007676f, 0.006136f, 0.046836f },
+    { 0.009561f, 0.007713f, 0.055143f },
+    { 0.011663f, 0.009417f, 0.06346f },
+    { 0.013995f, 0.011225f, 0.071862f },
+    { 0.016561f, 0.013136f, 0.080282f },
+    { 0.019373f, 0.015133f, 0.088767f },
+    { 0.022447f, 0.017199f, 0.097327f },
+    { 0.025793f, 0.019331f, 0.10593f },
+    { 0.029432f, 0.021503f, 0.114621f },
+    { 0.033385f, 0.023702f, 0.123397f },
+    { 0.037668f, 0.025921f, 0.132232f },
+    { 0.042253f, 0.028139f, 0.141141f },
+    { 0.046915f, 0.030324f, 0.150164f },
+    { 0.051644f, 0.032474f, 0.159254f },
+    { 0.056449f, 0.034569f, 0.168414f },
+    { 0.06134f, 0.03659f, 0.177642f },
+    { 0.066331f, 0.038504f, 0.186962f },
+    { 0.071429f, 0.040294f, 0.196354f },
+    { 0.076637f, 0.041905f, 0.205799f },
+    { 0.081962f, 0.043328f, 0.215289f },
+    { 0.087411f, 0.044556f, 0.224813f },
+    { 0.09299f, 0.045583f, 0.234358f },
+    { 0.098702f, 0.046402f, 0.243904f },
+    { 0.104551f, 0.047008f, 0.25343f },
+    { 0.110536f, 0.047399f, 0.262912f },
+    { 0.116656f, 0.047574f, 0.272321f },
+    { 0.122908f, 0.047536f, 0.281624f },
+    { 0.129285f, 0.047293f, 0.290788f },
+    { 0.135778f, 0.046856f, 0.299776f },
+    { 0.142378f, 0.046242f, 0.308553f },
+    { 0.149073f, 0.045468f, 0.317085f },
+    { 0.15585f, 0.044559f, 0.325338f },
+    { 0.162689f, 0.043554f, 0.333277f },
+    { 0.169575f, 0.042489f, 0.340874f },
+    { 0.176493f, 0.041402f, 0.348111f },
+    { 0.183429f, 0.040329f, 0.354971f },
+    { 0.190367f, 0.039309f, 0.361447f },
+    { 0.197297f, 0.0384f, 0.367535f },
+    { 0.204209f, 0.037632f, 0.373238f },
+    { 0.211095f, 0.03703f, 0.378563f },
+    { 0.217949f, 0.036615f, 0.383522f },
+    { 0.224763f, 0.036405f, 0.388129f },
+    { 0.231538f, 0.036405f, 0.3924f },
+    { 0.238273f, 0.036621f, 0.396353f },
+    { 0.244967f, 0.037055f, 0.400007f },
+    { 0.25162f, 0.037705f, 0.403378f },
+    { 0.258234f, 0.038571f, 0.406485f },
+    { 0.26481f, 0.039647f, 0.409345f },
+    { 0.271347f, 0.040922f, 0.411976f },
+    { 0.27785f, 0.042353f, 0.414392f },
+    { 0.284321f, 0.043933f, 0.416608f },
+    { 0.290763f, 0.045644f, 0.418637f },
+    { 0.297178f, 0.04747f, 0.420491f },
+    { 0.303568f, 0.049396f, 0.422182f },
+    { 0.309935f, 0.051407f, 0.423721f },
+    { 0.316282f, 0.05349f, 0.425116f },
+    { 0.32261f, 0.055634f, 0.426377f },
+    { 0.328921f, 0.057827f, 0.427511f },
+    { 0.335217f, 0.06006f, 0.428524f },
+    { 0.3415f, 0.062325f, 0.429425f },
+    { 0.347771f, 0.064616f, 0.430217f },
+    { 0.354032f, 0.066925f, 0.430906f },
+    { 0.360284f, 0.069247f, 0.431497f },
+    { 0.366529f, 0.071579f, 0.431994f },
+    { 0.372768f, 0.073915f, 0.4324f },
+    { 0.379001f, 0.076253f, 0.432719f },
+    { 0.385228f, 0.078591f, 0.432955f },
+    { 0.391453f, 0.080927f, 0.433109f },
+    { 0.397674f, 0.083257f, 0.433183f },
+    { 0.403894f, 0.08558f, 0.433179f },
+    { 0.410113f, 0.087896f, 0.433098f },
+    { 0.416331f, 0.090203f, 0.432943f },
+    { 0.422549f, 0.092501f, 0.432714f },
+    { 0.428768f, 0.09479f, 0.432412f },
+    { 0.434987f, 0.097069f, 0.432039f },
+    { 0.441207f, 0.099338f, 0.431594f },
+    { 0.447428f, 0.101597f, 0.43108f },
+    { 0.453651f, 0.103848f, 0.430498f },
+    { 0.459875f, 0.106089f, 0.429846f },
+    { 0.4661f, 0.108322f, 0.429125f },
+    { 0.472328f, 0.110547f, 0.428334f },
+    { 0.478558f, 0.112764f, 0.427475f },
+    { 0.484789f, 0.114974f, 0.426548f },
+    { 0.491022f, 0.117179f, 0.425552f },
+    { 0.497257f, 0.119379f, 0.424488f },
+    { 0.503493f, 0.121575f, 0.423356f },
+    { 0.50973f, 0.123769f, 0.422156f },
+    { 0.515967f, 0.12596f, 0.420887f },
+    { 0.522206f, 0.12815f, 0.419549f },
+    { 0.528444f, 0.130341f, 0.418142f },
+    { 0.534683f, 0.132534f, 0.416667f },
+    { 0.54092f, 0.134729f, 0.415123f },
+    { 0.547157f, 0.136929f, 0.413511f },
+    { 0.553392f, 0.139134f, 0.411829f },
+    { 0.559624f, 0.141346f, 0.410078f },
+    { 0.565854f, 0.143567f, 0.408258f },
+    { 0.572081f, 0.145797f, 0.406369f },
+    { 0.578304f, 0.148039f, 0.404411f },
+    { 0.584521f, 0.150294f, 0.402385f },
+    { 0.590734f, 0.152563f, 0.40029f },
+    { 0.59694f, 0.154848f, 0.398125f },
+    { 0.603139f, 0.157151f, 0.395891f },
+    { 0.60933f, 0.159474f, 0.393589f },
+    { 0.615513f, 0.161817f, 0.391219f },
+    { 0.621685f, 0.164184f, 0.388781f },
+    { 0.627847f, 0.166575f, 0.386276f },
+    { 0.633998f, 0.168992f, 0.383704f },
+    { 0.640135f, 0.171438f, 0.381065f },
+    { 0.64626f, 0.173914f, 0.378359f },
+    { 0.652369f, 0.176421f, 0.375586f },
+    { 0.658463f, 0.178962f, 0.372748f },
+    { 0.66454f, 0.181539f, 0.369846f },
+    { 0.670599f, 0.184153f, 0.366879f },
+    { 0.676638f, 0.186807f, 0.363849f },
+    { 0.682656f, 0.189501f, 0.360757f },
+    { 0.688653f, 0.192239f, 0.357603f },
+    { 0.694627f, 0.195021f, 0.354388f },
+    { 0.700576f, 0.197851f, 0.351113f },
+    { 0.7065f, 0.200728f, 0.347777f },
+    { 0.712396f, 0.203656f, 0.344383f },
+    { 0.718264f, 0.206636f, 0.340931f },
+    { 0.724103f, 0.20967f, 0.337424f },
+    { 0.729909f, 0.212759f, 0.333861f },
+    { 0.735683f, 0.215906f, 0.330245f },
+    { 0.741423f, 0.219112f, 0.326576f },
+    { 0.747127f, 0.222378f, 0.322856f },
+    { 0.752794f, 0.225706f, 0.319085f },
+    { 0.758422f, 0.229097f, 0.315266f },
+    { 0.76401f, 0.232554f, 0.311399f },
+    { 0.769556f, 0.236077f, 0.307485f },
+    { 0.775059f, 0.239667f, 0.303526f },
+    { 0.780517f, 0.243327f, 0.299523f },
+    { 0.785929f, 0.247056f, 0.295477f },
+    { 0.791293f, 0.250856f, 0.29139f },
+    { 0.796607f, 0.254728f, 0.287264f },
+    { 0.801871f, 0.258674f, 0.283099f },
+    { 0.807082f, 0.262692f, 0.278898f },
+    { 0.812239f, 0.266786f, 0.274661f },
+    { 0.817341f, 0.270954f, 0.27039f },
+    { 0.822386f, 0.275197f, 0.266085f },
+    { 0.827372f, 0.279517f, 0.26175f },
+    { 0.832299f, 0.283913f, 0.257383f },
+    { 0.837165f, 0.288385f, 0.252988f },
+    { 0.841969f, 0.292933f, 0.248564f },
+    { 0.846709f, 0.297559f, 0.244113f },
+    { 0.851384f, 0.30226f, 0.239636f },
+    { 0.855992f, 0.307038f, 0.235133f },
+    { 0.860533f, 0.311892f, 0.230606f },
+    { 0.865006f, 0.316822f, 0.226055f },
+    { 0.869409f, 0.321827f, 0.221482f },
+    { 0.873741f, 0.326906f, 0.216886f },
+    { 0.878001f, 0.33206f, 0.212268f },
+    { 0.882188f, 0.337287f, 0.207628f },
+    { 0.886302f, 0.342586f, 0.202968f },
+    { 0.890341f, 0.347957f, 0.198286f },
+    { 0.894305f, 0.353399f, 0.193584f },
+    { 0.898192f, 0.358911f, 0.18886f },
+    { 0.902003f, 0.364492f, 0.184116f },
+    { 0.905735f, 0.37014f, 0.17935f },
+    { 0.90939f, 0.375856f, 0.174563f },
+    { 0.912966f, 0.381636f, 0.169755f },
+    { 0.916462f, 0.387481f, 0.164924f },
+    { 0.919879f, 0.393389f, 0.16007f },
+    { 0.923215f, 0.399359f, 0.155193f },
+    { 0.92647f, 0.405389f, 0.150292f },
+    { 0.929644f, 0.411479f, 0.145367f },
+    { 0.932737f, 0.417627f, 0.140417f },
+    { 0.935747f, 0.423831f, 0.13544f },
+    { 0.938675f, 0.430091f, 0.130438f },
+    { 0.941521f, 0.436405f, 0.125409f },
+    { 0.944285f, 0.442772f, 0.120354f },
+    { 0.946965f, 0.449191f, 0.115272f },
+    { 0.949562f, 0.45566f, 0.110164f },
+    { 0.952075f, 0.462178f, 0.105031f },
+    { 0.954506f, 0.468744f, 0.099874f },
+    { 0.956852f, 0.475356f, 0.094695f },
+    { 0.959114f, 0.482014f, 0.089499f },
+    { 0.961293f, 0.488716f, 0.084289f },
+    { 0.963387f, 0.495462f, 0.079073f },
+    { 0.965397f, 0.502249f, 0.073859f },
+    { 0.967322f, 0.509078f, 0.068659f },
+    { 0.969163f, 0.515946f, 0.063488f },
+    { 0.970919f, 0.522853f, 0.058367f },
+    { 0.97259f, 0.529798f, 0.053324f },
+    { 0.974176f, 0.53678f, 0.048392f },
+    { 0.975677f, 0.543798f, 0.043618f },
+    { 0.977092f, 0.55085f, 0.03905f },
+    { 0.978422f, 0.557937f, 0.034931f },
+    { 0.979666f, 0.565057f, 0.031409f },
+    { 0.980824f, 0.572209f, 0.028508f },
+    { 0.981895f, 0.579392f, 0.02625f },
+    { 0.982881f, 0.586606f, 0.024661f },
+    { 0.983779f, 0.593849f, 0.02377f },
+    { 0.984591f, 0.601122f, 0.023606f },
+    { 0.985315f, 0.608422f, 0.024202f },
+    { 0.985952f, 0.61575f, 0.025592f },
+    { 0.986502f, 0.623105f, 0.027814f },
+    { 0.986964f, 0.630485f, 0.030908f },
+    { 0.987337f, 0.63789f, 0.034916f },
+    { 0.987622f, 0.64532f, 0.039886f },
+    { 0.987819f, 0.652773f, 0.045581f },
+    { 0.987926f, 0.66025f, 0.05175f },
+    { 0.987945f, 0.667748f, 0.058329f },
+    { 0.987874f, 0.675267f, 0.065257f },
+    { 0.987714f, 0.682807f, 0.072489f },
+    { 0.987464f, 0.690366f, 0.07999f },
+    { 0.987124f, 0.697944f, 0.087731f },
+    { 0.986694f, 0.70554f, 0.095694f },
+    { 0.986175f, 0.713153f, 0.103863f },
+    { 0.985566f, 0.720782f, 0.112229f },
+    { 0.984865f, 0.728427f, 0.120785f },
+    { 0.984075f, 0.736087f, 0.129527f },
+    { 0.983196f, 0.743758f, 0.138453f },
+    { 0.982228f, 0.751442f, 0.147565f },
+    { 0.981173f, 0.759135f, 0.156863f },
+    { 0.980032f, 0.766837f, 0.166353f },
+    { 0.978806f, 0.774545f, 0.176037f },
+    { 0.977497f, 0.782258f, 0.185923f },
+    { 0.976108f, 0.789974f, 0.196018f },
+    { 0.974638f, 0.797692f, 0.206332f },
+    { 0.973088f, 0.805409f, 0.216877f },
+    { 0.971468f, 0.813122f, 0.227658f },
+    { 0.969783f, 0.820825f, 0.238686f },
+    { 0.968041f, 0.828515f, 0.249972f },
+    { 0.966243f, 0.836191f, 0.261534f },
+    { 0.964394f, 0.843848f, 0.273391f },
+    { 0.962517f, 0.851476f, 0.285546f },
+    { 0.960626f, 0.859069f, 0.29801f },
+    { 0.95872f, 0.866624f, 0.31082f },
+    { 0.956834f, 0.874129f, 0.323974f },
+    { 0.954997f, 0.881569f, 0.337475f },
+    { 0.953215f, 0.888942f, 0.351369f },
+    { 0.951546f, 0.896226f, 0.365627f },
+    { 0.950018f, 0.903409f, 0.380271f },
+    { 0.948683f, 0.910473f, 0.395289f },
+    { 0.947594f, 0.917399f, 0.410665f },
+    { 0.946809f, 0.924168f, 0.426373f },
+    { 0.946392f, 0.930761f, 0.442367f },
+    { 0.946403f, 0.937159f, 0.458592f },
+    { 0.946903f, 0.943348f, 0.47497f },
+    { 0.947937f, 0.949318f, 0.491426f },
+    { 0.949545f, 0.955063f, 0.50786f },
+    { 0.95174f, 0.960587f, 0.524203f },
+    { 0.954529f, 0.965896f, 0.540361f },
+    { 0.957896f, 0.971003f, 0.556275f },
+    { 0.961812f, 0.975924f, 0.571925f },
+    { 0.966249f, 0.980678f, 0.587206f },
+    { 0.971162f, 0.985282f, 0.602154f },
+    { 0.976511f, 0.989753f, 0.61676f },
+    { 0.982257f, 0.994109f, 0.631017f },
+    { 0.988362f, 0.998364f, 0.644924f }
+};
+
+const ColourMapEntry magmaEntries[ColourMap::numEntries] =
+{
+    { 0.001462f, 0.000466f, 0.013866f },
+    { 0.002258f, 0.001295f, 0.018331f },
+    { 0.003279f, 0.002305f, 0.023708f },
+    { 0.004512f, 0.00349f, 0.029965f },
+    { 0.00595f, 0.004843f, 0.03713f },
+    { 0.007588f, 0.006356f, 0.044973f },
+    { 0.009426f, 0.008022f, 0.052844f },
+    { 0.011465f, 0.009828f, 0.06075f },
+    { 0.013708f, 0.011771f, 0.068667f },
+    { 0.016156f, 0.01384f, 0.076603f },
+    { 0.018815f, 0.016026f, 0.084584f },
+    { 0.021692f, 0.01832f, 0.09261f },
+    { 0.024792f, 0.020715f, 0.100676f },
+    { 0.028123f, 0.023201f, 0.108787f },
+    { 0.031696f, 0.025765f, 0.116965f },
+    { 0.03552f, 0.028397f, 0.125209f },
+    { 0.039608f, 0.03109f, 0.133515f },
+    { 0.04383f, 0.03383f, 0.141886f },
+    { 0.048062f, 0.036607f, 0.150327f },
+    { 0.05232f, 0.039407f, 0.158841f },
+    { 0.056615f, 0.04216f, 0.167446f },
+    { 0.060949f, 0.044794f, 0.176129f },
+    { 0.06533f, 0.047318f, 0.184892f },
+    { 0.069764f, 0.049726f, 0.193735f },
+    { 0.074257f, 0.052017f, 0.20266f },
+    { 0.078815f, 0.054184f, 0.211667f },
+    { 0.083446f, 0.056225f, 0.220755f },
+    { 0.088155f, 0.058133f, 0.229922f },
+    { 0.092949f, 0.059904f, 0.239164f },
+    { 0.097833f, 0.061531f, 0.248477f },
+    { 0.102815f, 0.06301f, 0.257854f },
+    { 0.107899f, 0.064335f, 0.267289f },
+    { 0.113094f, 0.065492f, 0.276784f },
+    { 0.118405f, 0.066479f, 0.286321f },
+    { 0.123833f, 0.067295f, 0.295879f },
+    { 0.12938f, 0.067935f, 0.305443f },
+    { 0.135053f, 0.068391f, 0.315f },
+    { 0.140858f, 0.068654f, 0.324538f },
+    { 0.146785f, 0.068738f, 0.334011f },
+    { 0.152839f, 0.068637f, 0.343404f },
+    { 0.159018f, 0.068354f, 0.352688f },
+    { 0.165308f, 0.067911f, 0.361816f },
+    { 0.171713f, 0.067305f, 0.370771f },
+    { 0.178212f, 0.066576f, 0.379497f },
+    { 0.184801f, 0.065732f, 0.387973f },
+    { 0.19146f, 0.064818f, 0.396152f },
+    { 0.198177f, 0.063862f, 0.404009f },
+    { 0.204935f, 0.062907f, 0.411514f },
+    { 0.211718f, 0.061992f, 0.418647f },
+    { 0.218512f, 0.061158f, 0.425392f },
+    { 0.225302f, 0.060445f, 0.431742f },
+    { 0.232077f, 0.059889f, 0.437695f },
+    { 0.238826f, 0.059517f, 0.443256f },
+    { 0.245543f, 0.059352f, 0.448436f },
+    { 0.25222f, 0.059415f, 0.453248f },
+    { 0.258857f, 0.059706f, 0.45771f },
+    { 0.265447f, 0.060237f, 0.46184f },
+    { 0.271994f, 0.060994f, 0.46566f },
+    { 0.278493f, 0.061978f, 0.46919f },
+    { 0.284951f, 0.063168f, 0.472451f },
+    { 0.291366f, 0.064553f, 0.475462f },
+    { 0.29774f, 0.066117f, 0.478243f },
+    { 0.304081f, 0.067835f, 0.480812f },
+    { 0.310382f, 0.069702f, 0.483186f },
+    { 0.316654f, 0.07169f, 0.48538f },
+    { 0.322899f, 0.073782f, 0.487408f },
+    { 0.329114f, 0.075972f, 0.489287f },
+    { 0.335308f, 0.078236f, 0.491024f },
+    { 0.341482f, 0.080564f, 0.492631f },
+    { 0.347636f, 0.082946f, 0.494121f },
+    { 0.353773f, 0.085373f, 0.495501f },
+    { 0.359898f, 0.087831f, 0.496778f },
+    { 0.366012f, 0.090314f, 0.49796f },
+    { 0.372116f, 0.092816f, 0.499053f },
+    { 0.378211f, 0.095332f, 0.500067f },
+    { 0.384299f, 0.097855f, 0.501002f },
+    { 0.390384f, 0.100379f, 0.501864f },
+    { 0.396467f, 0.102902f, 0.502658f },
+    { 0.402548f, 0.10542f, 0.503386f },
+    { 0.408629f, 0.10793f, 0.504052f },
+    { 0.414709f, 0.110431f, 0.504662f },
+    { 0.420791f, 0.11292f, 0.505215f },
+    { 0.426877f, 0.115395f, 0.505714f },
+    { 0.432967f, 0.117855f, 0.50616f },
+    { 0.439062f, 0.120298f, 0.506555f },
+    { 0.445163f, 0.122724f, 0.506901f },
+    { 0.451271f, 0.125132f, 0.507198f },
+    { 0.457386f, 0.127522f, 0.507448f },
+    { 0.463508f, 0.129893f, 0.507652f },
+    { 0.46964f, 0.132245f, 0.507809f },
+    { 0.47578f, 0.134577f, 0.507921f },
+    { 0.481929f, 0.136891f, 0.507989f },
+    { 0.488088f, 0.139186f, 0.508011f },
+    { 0.494258f, 0.141462f, 0.507988f },
+    { 0.500438f, 0.143719f, 0.50792f },
+    { 0.506629f, 0.145958f, 0.507806f },
+    { 0.512831f, 0.148179f, 0.507648f },
+    { 0.519045f, 0.150383f, 0.507443f },
+    { 0.52527f, 0.152569f, 0.507192f },
+    { 0.531507f, 0.154739f, 0.506895f },
+    { 0.537755f, 0.156894f, 0.506551f },
+    { 0.544015f, 0.159033f, 0.506159f },
+    { 0.550287f, 0.161158f, 0.505719f },
+    { 0.556571f, 0.163269f, 0.50523f },
+    { 0.562866f, 0.165368f, 0.504692f },
+    { 0.569172f, 0.167454f, 0.504105f },
+    { 0.57549f, 0.16953f, 0.503466f },
+    { 0.581819f, 0.171596f, 0.502777f },
+    { 0.588158f, 0.173652f, 0.502035f },
+    { 0.594508f, 0.175701f, 0.501241f },
+    { 0.600868f, 0.177743f, 0.500394f },
+    { 0.607238f, 0.179779f, 0.499492f },
+    { 0.613617f, 0.181811f, 0.498536f },
+    { 0.620005f, 0.18384f, 0.497524f },
+    { 0.626401f, 0.185867f, 0.496456f },
+    { 0.632805f, 0.187893f, 0.495332f },
+    { 0.639216f, 0.189921f, 0.49415f },
+    { 0.645633f, 0.191952f, 0.49291f },
+    { 0.652056f, 0.193986f, 0.491611f },
+    { 0.658483f, 0.196027f, 0.490253f },
+    { 0.664915f, 0.198075f, 0.488836f },
+    { 0.671349f, 0.200133f, 0.487358f },
+    { 0.677786f, 0.202203f, 0.485819f },
+    { 0.684224f, 0.204286f, 0.484219f },
+    { 0.690661f, 0.206384f, 0.482558f },
+    { 0.697098f, 0.208501f, 0.480835f },
+    { 0.703532f, 0.210638f, 0.479049f },
+    { 0.709962f, 0.212797f, 0.477201f },
+    { 0.716387f, 0.214982f, 0.47529f },
+    { 0.722805f, 0.217194f, 0.473316f },
+    { 0.729216f, 0.219437f, 0.471279f },
+    { 0.735616f, 0.221713f, 0.46918f },
+    { 0.742004f, 0.224025f, 0.467018f },
+    { 0.748378f, 0.226377f, 0.464794f },
+    { 0.754737f, 0.228772f, 0.462509f },
+    { 0.761077f, 0.231214f, 0.460162f },
+    { 0.767398f, 0.233705f, 0.457755f },
+    { 0.773695f, 0.236249f, 0.455289f },
+    { 0.779968f, 0.238851f, 0.452765f },
+    { 0.786212f, 0.241514f, 0.450184f },
+    { 0.792427f, 0.244242f, 0.447543f },
+    { 0.798608f, 0.24704f, 0.444848f },
+    { 0.804752f, 0.249911f, 0.442102f },
+    { 0.810855f, 0.252861f, 0.439305f },
+    { 0.816914f, 0.255895f, 0.436461f },
+    { 0.822926f, 0.259016f, 0.433573f },
+    { 0.828886f, 0.262229f, 0.430644f },
+    { 0.834791f, 0.26554f, 0.427671f },
+    { 0.840636f, 0.268953f, 0.424666f },
+    { 0.846416f, 0.272473f, 0.421631f },
+    { 0.852126f, 0.276106f, 0.418573f },
+    { 0.857763f, 0.279857f, 0.415496f },
+    { 0.86332f, 0.283729f, 0.412403f },
+    { 0.868793f, 0.287728f, 0.409303f },
+    { 0.874176f, 0.291859f, 0.406205f },
+    { 0.879464f, 0.296125f, 0.403118f },
+    { 0.884651f, 0.30053f, 0.400047f },
+    { 0.889731f, 0.305079f, 0.397002f },
+    { 0.8947f, 0.309773f, 0.393995f },
+    { 0.899552f, 0.314616f, 0.391037f },
+    { 0.904281f, 0.31961f, 0.388137f },
+    { 0.908884f, 0.324755f, 0.385308f },
+    { 0.913354f, 0.330052f, 0.382563f },
+    { 0.917689f, 0.3355f, 0.379915f },
+    { 0.921884f, 0.341098f, 0.377376f },
+    { 0.925937f, 0.346844f, 0.374959f },
+    { 0.929845f, 0.352734f, 0.372677f },
+    { 0.933606f, 0.358764f, 0.370541f },
+    { 0.937221f, 0.364929f, 0.368567f },
+    { 0.940687f, 0.371224f, 0.366762f },
+    { 0.944006f, 0.377643f, 0.365136f },
+    { 0.94718f, 0.384178f, 0.363701f },
+    { 0.95021f, 0.39082f, 0.362468f },
+    { 0.953099f, 0.397563f, 0.361438f },
+    { 0.955849f, 0.4044f, 0.360619f },
+    { 0.958464f, 0.411324f, 0.360014f },
+    { 0.960949f, 0.418323f, 0.35963f },
+    { 0.96331f, 0.42539f, 0.359469f },
+    { 0.965549f, 0.432519f, 0.359529f },
+    { 0.967671f, 0.439703f, 0.35981f },
+    { 0.96968f, 0.446936f, 0.360311f },
+    { 0.971582f, 0.45421f, 0.36103f },
+    { 0.973381f, 0.46152f, 0.361965f },
+    { 0.975082f, 0.468861f, 0.363111f },
+    { 0.97669f, 0.476226f, 0.364466f },
+    { 0.97821f, 0.483612f, 0.366025f },
+    { 0.979645f, 0.491014f, 0.367783f },
+    { 0.981f, 0.498428f, 0.369734f },
+    { 0.982279f, 0.505851f, 0.371874f },
+    { 0.983485f, 0.51328f, 0.374198f },
+    { 0.984622f, 0.520713f, 0.376698f },
+    { 0.985693f, 0.528148f, 0.379371f },
+    { 0.9867f, 0.535582f, 0.38221f },
+    { 0.987646f, 0.543015f, 0.38521f },
+    { 0.988533f, 0.550446f, 0.388365f },
+    { 0.989363f, 0.557873f, 0.391671f },
+    { 0.990138f, 0.565296f, 0.395122f },
+    { 0.990871f, 0.572706f, 0.398714f },
+    { 0.991558f, 0.580107f, 0.402441f },
+    { 0.992196f, 0.587502f, 0.406299f },
+    { 0.992785f, 0.594891f, 0.410283f },
+    { 0.993326f, 0.602275f, 0.41439f },
+    { 0.993834f, 0.609644f, 0.418613f },
+    { 0.994309f, 0.616999f, 0.42295f },
+    { 0.994738f, 0.62435f, 0.427397f },
+    { 0.995122f, 0.631696f, 0.431951f },
+    { 0.99548f, 0.639027f, 0.436607f },
+    { 0.99581f, 0.646344f, 0.441361f },
+    { 0.996096f, 0.653659f, 0.446213f },
+    { 0.996341f, 0.660969f, 0.45116f },
+    { 0.99658f, 0.668256f, 0.456192f },
+    { 0.996775f, 0.675541f, 0.461314f },
+    { 0.996925f, 0.682828f, 0.466526f },
+    { 0.997077f, 0.690088f, 0.471811f },
+    { 0.997186f, 0.697349f, 0.477182f },
+    { 0.997254f, 0.704611f, 0.482635f },
+    { 0.997325f, 0.711848f, 0.488154f },
+    { 0.997351f, 0.719089f, 0.493755f },
+    { 0.997351f, 0.726324f, 0.499428f },
+    { 0.997341f, 0.733545f, 0.505167f },
+    { 0.997285f, 0.740772f, 0.510983f },
+    { 0.997228f, 0.747981f, 0.516859f },
+    { 0.997138f, 0.75519f, 0.522806f },
+    { 0.997019f, 0.762398f, 0.528821f },
+    { 0.996898f, 0.769591f, 0.534892f },
+    { 0.996727f, 0.776795f, 0.541039f },
+    { 0.996571f, 0.783977f, 0.547233f },
+    { 0.996369f, 0.791167f, 0.553499f },
+    { 0.996162f, 0.798348f, 0.55982f },
+    { 0.995932f, 0.805527f, 0.566202f },
+    { 0.99568f, 0.812706f, 0.572645f },
+    { 0.995424f, 0.819875f, 0.57914f },
+    { 0.995131f, 0.827052f, 0.585701f },
+    { 0.994851f, 0.834213f, 0.592307f },
+    { 0.994524f, 0.841387f, 0.598983f },
+    { 0.994222f, 0.84854f, 0.605696f },
+    { 0.993866f, 0.855711f, 0.612482f },
+    { 0.993545f, 0.862859f, 0.619299f },
+    { 0.99317f, 0.870024f, 0.626189f },
+    { 0.992831f, 0.877168f, 0.633109f },
+    { 0.99244f, 0.88433f, 0.640099f },
+    { 0.992089f, 0.89147f, 0.647116f },
+    { 0.991688f, 0.898627f, 0.654202f },
+    { 0.991332f, 0.905763f, 0.661309f },
+    { 0.99093f, 0.912915f, 0.668481f },
+    { 0.99057f, 0.920049f, 0.675675f },
+    { 0.990175f, 0.927196f, 0.682926f },
+    { 0.989815f, 0.934329f, 0.690198f },
+    { 0.989434f, 0.94147f, 0.697519f },
+    { 0.989077f, 0.948604f, 0.704863f },
+    { 0.988717f, 0.955742f, 0.712242f },
+    { 0.988367f, 0.962878f, 0.719649f },
+    { 0.988033f, 0.970012f, 0.727077f },
+    { 0.987691f, 0.977154f, 0.734536f },
+    { 0.987387f, 0.984288f, 0.742002f },
+    { 0.987053f, 0.991438f, 0.749504f }
+};
+
+const ColourMapEntry plasmaEntries[ColourMap::numEntries] =
+{
+    { 0.050383f, 0.029803f, 0.527975f },
+    { 0.063536f, 0.028426f, 0.533124f },
+    { 0.075353f, 0.027206f, 0.538007f },
+    { 0.086222f, 0.026125f, 0.542658f },
+    { 0.096379f, 0.025165f, 0.547103f },
+    { 0.10598f, 0.024309f, 0.551368f },
+    { 0.115124f, 0.023556f, 0.555468f },
+    { 0.123903f, 0.022878f, 0.559423f },
+    { 0.132381f, 0.022258f, 0.56325f },
+    { 0.140603f, 0.021687f, 0.566959f },
+    { 0.148607f, 0.021154f, 0.570562f },
+    { 0.156421f, 0.020651f, 0.574065f },
+    { 0.16407f, 0.020171f, 0.577478f },
+    { 0.171574f, 0.019706f, 0.580806f },
+    { 0.17895f, 0.019252f, 0.584054f },
+    { 0.186213f, 0.018803f, 0.587228f },
+    { 0.193374f, 0.018354f, 0.59033f },
+    { 0.200445f, 0.017902f, 0.593364f },
+    { 0.207435f, 0.017442f, 0.596333f },
+    { 0.21435f, 0.016973f, 0.599239f },
+    { 0.221197f, 0.016497f, 0.602083f },
+    { 0.227983f, 0.016007f, 0.604867f },
+    { 0.234715f, 0.015502f, 0.607592f },
+    { 0.241396f, 0.014979f, 0.610259f },
+    { 0.248032f, 0.014439f, 0.612868f },
+    { 0.254627f, 0.013882f, 0.615419f },
+    { 0.261183f, 0.013308f, 0.617911f },
+    { 0.267703f, 0.012716f, 0.620346f },
+    { 0.274191f, 0.012109f, 0.622722f },
+    { 0.280648f, 0.011488f, 0.625038f },
+    { 0.287076f, 0.010855f, 0.627295f },
+    { 0.293478f, 0.010213f, 0.62949f },
+    { 0.299855f, 0.009561f, 0.631624f },
+    { 0.30621f, 0.008902f, 0.633694f },
+    { 0.312543f, 0.008239f, 0.6357f },
+    { 0.318856f, 0.007576f, 0.63764f },
+    { 0.32515f, 0.006915f, 0.639512f },
+    { 0.331426f, 0.006261f, 0.641316f },
+    { 0.337683f, 0.005618f, 0.643049f },
+    { 0.343925f, 0.004991f, 0.64471f },
+    { 0.35015f, 0.004382f, 0.646298f },
+    { 0.356359f, 0.003798f, 0.64781f },
+    { 0.362553f, 0.003243f, 0.649245f },
+    { 0.368733f, 0.002724f, 0.650601f },
+    { 0.374897f, 0.002245f, 0.651876f },
+    { 0.381047f, 0.001814f, 0.653068f },
+    { 0.387183f, 0.001434f, 0.654177f },
+    { 0.393304f, 0.001114f, 0.655199f },
+    { 0.399411f, 0.000859f, 0.656133f },
+    { 0.405503f, 0.000678f, 0.656977f },
+    { 0.41158f, 0.000577f, 0.65773f },
+    { 0.417642f, 0.000564f, 0.65839f },
+    { 0.423689f, 0.000646f, 0.658956f },
+    { 0.429719f, 0.000831f, 0.659425f },
+    { 0.435734f, 0.001127f, 0.659797f },
+    { 0.441732f, 0.00154f, 0.660069f },
+    { 0.447714f, 0.00208f, 0.66024f },
+    { 0.453677f, 0.002755f, 0.66031f },
+    { 0.459623f, 0.003574f, 0.660277f },
+    { 0.46555f, 0.004545f, 0.660139f },
+    { 0.471457f, 0.005678f, 0.659897f },
+    { 0.477344f, 0.00698f, 0.659549f },
+    { 0.48321f, 0.00846f, 0.659095f },
+    { 0.489055f, 0.010127f, 0.658534f },
+    { 0.494877f, 0.01199f, 0.657865f },
+    { 0.500678f, 0.014055f, 0.657088f },
+    { 0.506454f, 0.016333f, 0.656202f },
+    { 0.512206f, 0.018833f, 0.655209f },
+    { 0.517933f, 0.021563f, 0.654109f },
+    { 0.523633f, 0.024532f, 0.652901f },
+    { 0.529306f, 0.027747f, 0.651586f },
+    { 0.534952f, 0.031217f, 0.650165f },
+    { 0.54057f, 0.03495f, 0.64864f },
+    { 0.546157f, 0.038954f, 0.64701f },
+    { 0.551715f, 0.043136f, 0.645277f },
+    { 0.557243f, 0.047331f, 0.643443f },
+    { 0.562738f, 0.051545f, 0.641509f },
+    { 0.568201f, 0.055778f, 0.639477f },
+    { 0.573632f, 0.060028f, 0.637349f },
+    { 0.579029f, 0.064296f, 0.635126f },
+    { 0.584391f, 0.068579f, 0.632812f },
+    { 0.589719f, 0.072878f, 0.630408f },
+    { 0.595011f, 0.07719f, 0.627917f },
+    { 0.600266f, 0.081516f, 0.625342f },
+    { 0.605485f, 0.085854f, 0.622686f },
+    { 0.610667f, 0.090204f, 0.619951f },
+    { 0.615812f, 0.094564f, 0.61714f },
+    { 0.620919f, 0.098934f, 0.614257f },
+    { 0.625987f, 0.103312f, 0.611305f },
+    { 0.631017f, 0.107699f, 0.608287f },
+    { 0.636008f, 0.112092f, 0.605205f },
+    { 0.640959f, 0.116492f, 0.602065f },
+    { 0.645872f, 0.120898f, 0.598867f },
+    { 0.650746f, 0.125309f, 0.595617f },
+    { 0.65558f, 0.129725f, 0.592317f },
+    { 0.660374f, 0.134144f, 0.588971f },
+    { 0.665129f, 0.138566f, 0.585582f },
+    { 0.669845f, 0.142992f, 0.582154f },
+    { 0.674522f, 0.147419f, 0.578688f },
+    { 0.67916f, 0.151848f, 0.575189f },
+    { 0.683758f, 0.156278f, 0.57166f },
+    { 0.688318f, 0.160709f, 0.568103f },
+    { 0.69284f, 0.165141f, 0.564522f },
+    { 0.697324f, 0.169573f, 0.560919f },
+    { 0.701769f, 0.174005f, 0.557296f },
+    { 0.706178f, 0.178437f, 0.553657f },
+    { 0.710549f, 0.182868f, 0.550004f },
+    { 0.714883f, 0.187299f, 0.546338f },
+    { 0.719181f, 0.191729f, 0.542663f },
+    { 0.723444f, 0.196158f, 0.538981f },
+    { 0.72767f, 0.200586f, 0.535293f },
+    { 0.731862f, 0.205013f, 0.531601f },
+    { 0.736019f, 0.209439f, 0.527908f },
+    { 0.740143f, 0.213864f, 0.524216f },
+    { 0.744232f, 0.218288f, 0.520524f },
+    { 0.748289f, 0.222711f, 0.516834f },
+    { 0.752312f, 0.227133f, 0.513149f },
+    { 0.756304f, 0.231555f, 0.509468f },
+    { 0.760264f, 0.235976f, 0.505794f },
+    { 0.764193f, 0.240396f, 0.502126f },
+    { 0.76809f, 0.244817f, 0.498465f },
+    { 0.771958f, 0.249237f, 0.494813f },
+    { 0.775796f, 0.253658f, 0.491171f },
+    { 0.779604f, 0.258078f, 0.487539f },
+    { 0.783383f, 0.2625f, 0.483918f },
+    { 0.787133f, 0.266922f, 0.480307f },
+    { 0.790855f, 0.271345f, 0.476706f },
+    { 0.794549f, 0.27577f, 0.473117f },
+    { 0.798216f, 0.280197f, 0.469538f },
+    { 0.801855f, 0.284626f, 0.465971f },
+    { 0.805467f, 0.289057f, 0.462415f },
+    { 0.809052f, 0.293491f, 0.45887f },
+    { 0.812612f, 0.297928f, 0.455338f },
+    { 0.816144f, 0.302368f, 0.451816f },
+    { 0.819651f, 0.306812f, 0.448306f },
+    { 0.823132f, 0.311261f, 0.444806f },
+    { 0.826588f, 0.315714f, 0.441316f },
+    { 0.830018f, 0.320172f, 0.437836f },
+    { 0.833422f, 0.324635f, 0.434366f },
+    { 0.836801f, 0.329105f, 0.430905f },
+    { 0.840155f, 0.33358f, 0.427455f },
+    { 0.843484f, 0.338062f, 0.424013f },
+    { 0.846788f, 0.342551f, 0.420579f },
+    { 0.850066f, 0.347048f, 0.417153f },
+    { 0.853319f, 0.351553f, 0.413734f },
+    { 0.856547f, 0.356066f, 0.410322f },
+    { 0.85975f, 0.360588f, 0.406917f },
+    { 0.862927f, 0.365119f, 0.403519f },
+    { 0.866078f, 0.36966f, 0.400126f },
+    { 0.869203f, 0.374212f, 0.396738f },
+    { 0.872303f, 0.378774f, 0.393355f },
+    { 0.875376f, 0.383347f, 0.389976f },
+    { 0.878423f, 0.387932f, 0.3866f },
+    { 0.881443f, 0.392529f, 0.383229f },
+    { 0.884436f, 0.397139f, 0.37986f },
+    { 0.887402f, 0.401762f, 0.376494f },
+    { 0.89034f, 0.406398f, 0.37313f },
+    { 0.89325f, 0.411048f, 0.369768f },
+    { 0.896131f, 0.415712f, 0.366407f },
+    { 0.898984f, 0.420392f, 0.363047f },
+    { 0.901807f, 0.425087f, 0.359688f },
+    { 0.904601f, 0.429797f, 0.356329f },
+    { 0.907365f, 0.434524f, 0.35297f },
+    { 0.910098f, 0.439268f, 0.34961f },
+    { 0.9128f, 0.444029f, 0.346251f },
+    { 0.915471f, 0.448807f, 0.34289f },
+    { 0.918109f, 0.453603f, 0.339529f },
+    { 0.920714f, 0.458417f, 0.336166f },
+    { 0.923287f, 0.463251f, 0.332801f },
+    { 0.925825f, 0.468103f, 0.329435f },
+    { 0.928329f, 0.472975f, 0.326067f },
+    { 0.930798f, 0.477867f, 0.322697f },
+    { 0.933232f, 0.48278f, 0.319325f },
+    { 0.93563f, 0.487712f, 0.315952f },
+    { 0.93799f, 0.492667f, 0.312575f },
+    { 0.940313f, 0.497642f, 0.309197f },
+    { 0.942598f, 0.502639f, 0.305816f },
+    { 0.944844f, 0.507658f, 0.302433f },
+    { 0.947051f, 0.512699f, 0.299049f },
+    { 0.949217f, 0.517763f, 0.295662f },
+    { 0.951344f, 0.52285f, 0.292275f },
+    { 0.953428f, 0.52796f, 0.288883f },
+    { 0.95547f, 0.533093f, 0.28549f },
+    { 0.957469f, 0.53825f, 0.282096f },
+    { 0.959424f, 0.543431f, 0.278701f },
+    { 0.961336f, 0.548636f, 0.275305f },
+    { 0.963203f, 0.553865f, 0.271909f },
+    { 0.965024f, 0.559118f, 0.268513f },
+    { 0.966798f, 0.564396f, 0.265118f },
+    { 0.968526f, 0.5697f, 0.261721f },
+    { 0.970205f, 0.575028f, 0.258325f },
+    { 0.971835f, 0.580382f, 0.254931f },
+    { 0.973416f, 0.585761f, 0.25154f },
+    { 0.974947f, 0.591165f, 0.248151f },
+    { 0.976428f, 0.596595f, 0.244767f },
+    { 0.977856f, 0.602051f, 0.241387f },
+    { 0.979233f, 0.607532f, 0.238013f },
+    { 0.980556f, 0.613039f, 0.234646f },
+    { 0.981826f, 0.618572f, 0.231287f },
+    { 0.983041f, 0.624131f, 0.227937f },
+    { 0.984199f, 0.629718f, 0.224595f },
+    { 0.985301f, 0.63533f, 0.221265f },
+    { 0.986345f, 0.640969f, 0.217948f },
+    { 0.987332f, 0.646633f, 0.214648f },
+    { 0.98826f, 0.652325f, 0.211364f },
+    { 0.989128f, 0.658043f, 0.2081f },
+    { 0.989935f, 0.663787f, 0.204859f },
+    { 0.990681f, 0.669558f, 0.201642f },
+    { 0.991365f, 0.675355f, 0.198453f },
+    { 0.991985f, 0.681179f, 0.195295f },
+    { 0.992541f, 0.68703f, 0.19217f },
+    { 0.993032f, 0.692907f, 0.189084f },
+    { 0.993456f, 0.69881f, 0.186041f },
+    { 0.993814f, 0.704741f, 0.183043f },
+    { 0.994103f, 0.710698f, 0.180097f },
+    { 0.994324f, 0.716681f, 0.177208f },
+    { 0.994474f, 0.722691f, 0.174381f },
+    { 0.994553f, 0.728728f, 0.171622f },
+    { 0.994561f, 0.734791f, 0.168938f },
+    { 0.994495f, 0.74088f, 0.166335f },
+    { 0.994355f, 0.746995f, 0.163821f },
+    { 0.994141f, 0.753137f, 0.161404f },
+    { 0.993851f, 0.759304f, 0.159092f },
+    { 0.993482f, 0.765499f, 0.156891f },
+    { 0.993033f, 0.77172f, 0.154808f },
+    { 0.992505f, 0.777967f, 0.152855f },
+    { 0.991897f, 0.784239f, 0.151042f },
+    { 0.991209f, 0.790537f, 0.149377f },
+    { 0.990439f, 0.796859f, 0.14787f },
+    { 0.989587f, 0.803205f, 0.146529f },
+    { 0.988648f, 0.809579f, 0.145357f },
+    { 0.987621f, 0.815978f, 0.144363f },
+    { 0.986509f, 0.822401f, 0.143557f },
+    { 0.985314f, 0.828846f, 0.142945f },
+    { 0.984031f, 0.835315f, 0.142528f },
+    { 0.982653f, 0.841812f, 0.142303f },
+    { 0.98119f, 0.848329f, 0.142279f },
+    { 0.979644f, 0.854866f, 0.142453f },
+    { 0.977995f, 0.861432f, 0.142808f },
+    { 0.976265f, 0.868016f, 0.143351f },
+    { 0.974443f, 0.874622f, 0.144061f },
+    { 0.97253f, 0.88125f, 0.144923f },
+    { 0.970533f, 0.887896f, 0.145919f },
+    { 0.968443f, 0.894564f, 0.147014f },
+    { 0.966271f, 0.901249f, 0.14818f },
+    { 0.964021f, 0.90795f, 0.14937f },
+    { 0.961681f, 0.914672f, 0.15052f },
+    { 0.959276f, 0.921407f, 0.151566f },
+    { 0.956808f, 0.928152f, 0.152409f },
+    { 0.954287f, 0.934908f, 0.152921f },
+    { 0.951726f, 0.941671f, 0.152925f },
+    { 0.949151f, 0.948435f, 0.152178f },
+    { 0.946602f, 0.95519f, 0.150328f },
+    { 0.944152f, 0.961916f, 0.146861f },
+    { 0.941896f, 0.96859f, 0.140956f },
+    { 0.940015f, 0.975158f, 0.131326f }
+};
+
+const ColourMapEntry viridisEntries[ColourMap::numEntries] =
+{
+    { 0.267004f, 0.004874f, 0.329415f },
+    { 0.26851f, 0.009605f, 0.335427f },
+    { 0.269944f, 0.014625f, 0.341379f },
+    { 0.271305f, 0.019942f, 0.347269f },
+    { 0.272594f, 0.025563f, 0.353093f },
+    { 0.273809f, 0.031497f, 0.358853f },
+    { 0.274952f, 0.037752f, 0.364543f },
+    { 0.276022f, 0.044167f, 0.370164f },
+    { 0.277018f, 0.050344f, 0.375715f },
+    { 0.277941f, 0.056324f, 0.381191f },
+    { 0.278791f, 0.062145f, 0.386592f },
+    { 0.279566f, 0.067836f, 0.391917f },
+    { 0.280267f, 0.073417f, 0.397163f },
+    { 0.280894f, 0.078907f, 0.402329f },
+    { 0.281446f, 0.08432f, 0.407414f },
+    { 0.281924f, 0.089666f, 0.412415f },
+    { 0.282327f, 0.094955f, 0.417331f },
+    { 0.282656f, 0.100196f, 0.42216f },
+    { 0.28291f, 0.105393f, 0.426902f },
+    { 0.283091f, 0.110553f, 0.431554f },
+    { 0.283197f, 0.11568f, 0.436115f },
+    { 0.283229f, 0.120777f, 0.440584f },
+    { 0.283187f, 0.125848f, 0.44496f },
+    { 0.283072f, 0.130895f, 0.449241f },
+    { 0.282884f, 0.13592f, 0.453427f },
+    { 0.282623f, 0.140926f, 0.457517f },
+    { 0.28229f, 0.145912f, 0.46151f },
+    { 0.281887f, 0.150881f, 0.465405f },
+    { 0.281412f, 0.155834f, 0.469201f },
+    { 0.280868f, 0.160771f, 0.472899f },
+    { 0.280255f, 0.165693f, 0.476498f },
+    { 0.279574f, 0.170599f, 0.479997f },
+    { 0.278826f, 0.17549f, 0.483397f },
+    { 0.278012f, 0.180367f, 0.486697f },
+    { 0.277134f, 0.185228f, 0.489898f },
+    { 0.276194f, 0.190074f, 0.493001f },
+    { 0.275191f, 0.194905f, 0.496005f },
+    { 0.274128f, 0.199721f, 0.498911f },
+    { 0.273006f, 0.20452f, 0.501721f },
+    { 0.271828f, 0.209303f, 0.504434f },
+    { 0.270595f, 0.214069f, 0.507052f },
+    { 0.269308f, 0.218818f, 0.509577f },
+    { 0.267968f, 0.223549f, 0.512008f },
+    { 0.26658f, 0.228262f, 0.514349f },
+    { 0.265145f, 0.232956f, 0.516599f },
+    { 0.263663f, 0.237631f, 0.518762f },
+    { 0.262138f, 0.242286f, 0.520837f },
+    { 0.260571f, 0.246922f, 0.522828f },
+    { 0.258965f, 0.251537f, 0.524736f },
+    { 0.257322f, 0.25613f, 0.526563f },
+    { 0.255645f, 0.260703f, 0.528312f },
+    { 0.253935f, 0.265254f, 0.529983f },
+    { 0.252194f, 0.269783f, 0.531579f },
+    { 0.250425f, 0.27429f, 0.533103f },
+    { 0.248629f, 0.278775f, 0.534556f },
+    { 0.246811f, 0.283237f, 0.535941f },
+    { 0.244972f, 0.287675f, 0.53726f },
+    { 0.243113f, 0.292092f, 0.538516f },
+    { 0.241237f, 0.296485f, 0.539709f },
+    { 0.239346f, 0.300855f, 0.540844f },
+    { 0.237441f, 0.305202f, 0.541921f },
+    { 0.235526f, 0.309527f, 0.542944f },
+    { 0.233603f, 0.313828f, 0.543914f },
+    { 0.231674f, 0.318106f, 0.544834f },
+    { 0.229739f, 0.322361f, 0.545706f },
+    { 0.227802f, 0.326594f, 0.546532f },
+    { 0.225863f, 0.330805f, 0.547314f },
+    { 0.223925f, 0.334994f, 0.548053f },
+    { 0.221989f, 0.339161f, 0.548752f },
+    { 0.220057f, 0.343307f, 0.549413f },
+    { 0.21813f, 0.347432f, 0.550038f },
+    { 0.21621f, 0.351535f, 0.550627f },
+    { 0.214298f, 0.355619f, 0.551184f },
+    { 0.212395f, 0.359683f, 0.55171f },
+    { 0.210503f, 0.363727f, 0.552206f },
+    { 0.208623f, 0.367752f, 0.552675f },
+    { 0.206756f, 0.371758f, 0.553117f },
+    { 0.204903f, 0.375746f, 0.553533f },
+    { 0.203063f, 0.379716f, 0.553925f },
+    { 0.201239f, 0.38367f, 0.554294f },
+    { 0.19943f, 0.387607f, 0.554642f },
+    { 0.197636f, 0.391528f, 0.554969f },
+    { 0.19586f, 0.395433f, 0.555276f },
+    { 0.1941f, 0.399323f, 0.555565f },
+    { 0.192357f, 0.403199f, 0.555836f },
+    { 0.190631f, 0.407061f, 0.556089f },
+    { 0.188923f, 0.41091f, 0.556326f },
+    { 0.187231f, 0.414746f, 0.556547f },
+    { 0.185556f, 0.41857f, 0.556753f },
+    { 0.183898f, 0.422383f, 0.556944f },
+    { 0.182256f, 0.426184f, 0.55712f },
+    { 0.180629f, 0.429975f, 0.557282f },
+    { 0.179019f, 0.433756f, 0.55743f },
+    { 0.177423f, 0.437527f, 0.557565f },
+    { 0.175841f, 0.44129f, 0.557685f },
+    { 0.174274f, 0.445044f, 0.557792f },
+    { 0.172719f, 0.448791f, 0.557885f },
+    { 0.171176f, 0.45253f, 0.557965f },
+    { 0.169646f, 0.456262f, 0.55803f },
+    { 0.168126f, 0.459988f, 0.558082f },
+    { 0.166617f, 0.463708f, 0.558119f },
+    { 0.165117f, 0.467423f, 0.558141f },
+    { 0.163625f, 0.471133f, 0.558148f },
+    { 0.162142f, 0.474838f, 0.55814f },
+    { 0.160665f, 0.47854f, 0.558115f },
+    { 0.159194f, 0.482237f, 0.558073f },
+    { 0.157729f, 0.485932f, 0.558013f },
+    { 0.15627f, 0.489624f, 0.557936f },
+    { 0.154815f, 0.493313f, 0.55784f },
+    { 0.153364f, 0.497f, 0.557724f },
+    { 0.151918f, 0.500685f, 0.557587f },
+    { 0.150476f, 0.504369f, 0.55743f },
+    { 0.149039f, 0.508051f, 0.55725f },
+    { 0.147607f, 0.511733f, 0.557049f },
+    { 0.14618f, 0.515413f, 0.556823f },
+    { 0.144759f, 0.519093f, 0.556572f },
+    { 0.143343f, 0.522773f, 0.556295f },
+    { 0.141935f, 0.526453f, 0.555991f },
+    { 0.140536f, 0.530132f, 0.555659f },
+    { 0.139147f, 0.533812f, 0.555298f },
+    { 0.13777f, 0.537492f, 0.554906f },
+    { 0.136408f, 0.541173f, 0.554483f },
+    { 0.135066f, 0.544853f, 0.554029f },
+    { 0.133743f, 0.548535f, 0.553541f },
+    { 0.132444f, 0.552216f, 0.553018f },
+    { 0.131172f, 0.555899f, 0.552459f },
+    { 0.129933f, 0.559582f, 0.551864f },
+    { 0.128729f, 0.563265f, 0.551229f },
+    { 0.127568f, 0.566949f, 0.550556f },
+    { 0.126453f, 0.570633f, 0.549841f },
+    { 0.125394f, 0.574318f, 0.549086f },
+    { 0.124395f, 0.578002f, 0.548287f },
+    { 0.123463f, 0.581687f, 0.547445f },
+    { 0.122606f, 0.585371f, 0.546557f },
+    { 0.121831f, 0.589055f, 0.545623f },
+    { 0.121148f, 0.592739f, 0.544641f },
+    { 0.120565f, 0.596422f, 0.543611f },
+    { 0.120092f, 0.600104f, 0.54253f },
+    { 0.119738f, 0.603785f, 0.5414f },
+    { 0.119512f, 0.607464f, 0.540218f },
+    { 0.119423f, 0.611141f, 0.538982f },
+    { 0.119483f, 0.614817f, 0.537692f },
+    { 0.119699f, 0.61849f, 0.536347f },
+    { 0.120081f, 0.622161f, 0.534946f },
+    { 0.120638f, 0.625828f, 0.533488f },
+    { 0.12138f, 0.629492f, 0.531973f },
+    { 0.122312f, 0.633153f, 0.530398f },
+    { 0.123444f, 0.636809f, 0.528763f },
+    { 0.12478f, 0.640461f, 0.527068f },
+    { 0.126326f, 0.644107f, 0.525311f },
+    { 0.128087f, 0.647749f, 0.523491f },
+    { 0.130067f, 0.651384f, 0.521608f },
+    { 0.132268f, 0.655014f, 0.519661f },
+    { 0.134692f, 0.658636f, 0.517649f },
+    { 0.137339f, 0.662252f, 0.515571f },
+    { 0.14021f, 0.665859f, 0.513427f },
+    { 0.143303f, 0.669459f, 0.511215f },
+    { 0.146616f, 0.67305f, 0.508936f },
+    { 0.150148f, 0.676631f, 0.506589f },
+    { 0.153894f, 0.680203f, 0.504172f },
+    { 0.157851f, 0.683765f, 0.501686f },
+    { 0.162016f, 0.687316f, 0.499129f },
+    { 0.166383f, 0.690856f, 0.496502f },
+    { 0.170948f, 0.694384f, 0.493803f },
+    { 0.175707f, 0.6979f, 0.491033f },
+    { 0.180653f, 0.701402f, 0.488189f },
+    { 0.185783f, 0.704891f, 0.485273f },
+    { 0.19109f, 0.708366f, 0.482284f },
+    { 0.196571f, 0.711827f, 0.479221f },
+    { 0.202219f, 0.715272f, 0.476084f },
+    { 0.20803f, 0.718701f, 0.472873f },
+    { 0.214f, 0.722114f, 0.469588f },
+    { 0.220124f, 0.725509f, 0.466226f },
+    { 0.226397f, 0.728888f, 0.462789f },
+    { 0.232815f, 0.732247f, 0.459277f },
+    { 0.239374f, 0.735588f, 0.455688f },
+    { 0.24607f, 0.73891f, 0.452024f },
+    { 0.252899f, 0.742211f, 0.448284f },
+    { 0.259857f, 0.745492f, 0.444467f },
+    { 0.266941f, 0.748751f, 0.440573f },
+    { 0.274149f, 0.751988f, 0.436601f },
+    { 0.281477f, 0.755203f, 0.432552f },
+    { 0.288921f, 0.758394f, 0.428426f },
+    { 0.296479f, 0.761561f, 0.424223f },
+    { 0.304148f, 0.764704f, 0.419943f },
+    { 0.311925f, 0.767822f, 0.415586f },
+    { 0.319809f, 0.770914f, 0.411152f },
+    { 0.327796f, 0.77398f, 0.40664f },
+    { 0.335885f, 0.777018f, 0.402049f },
+    { 0.344074f, 0.780029f, 0.397381f },
+    { 0.35236f, 0.783011f, 0.392636f },
+    { 0.360741f, 0.785964f, 0.387814f },
+    { 0.369214f, 0.788888f, 0.382914f },
+    { 0.377779f, 0.791781f, 0.377939f },
+    { 0.386433f, 0.794644f, 0.372886f },
+    { 0.395174f, 0.797475f, 0.367757f },
+    { 0.404001f, 0.800275f, 0.362552f },
+    { 0.412913f, 0.803041f, 0.357269f },
+    { 0.421908f, 0.805774f, 0.35191f },
+    { 0.430983f, 0.808473f, 0.346476f },
+    { 0.440137f, 0.811138f, 0.340967f },
+    { 0.449368f, 0.813768f, 0.335384f },
+    { 0.458674f, 0.816363f, 0.329727f },
+    { 0.468053f, 0.818921f, 0.323998f },
+    { 0.477504f, 0.821444f, 0.318195f },
+    { 0.487026f, 0.823929f, 0.312321f },
+    { 0.496615f, 0.826376f, 0.306377f },
+    { 0.506271f, 0.828786f, 0.300362f },
+    { 0.515992f, 0.831158f, 0.294279f },
+    { 0.525776f, 0.833491f, 0.288127f },
+    { 0.535621f, 0.835785f, 0.281908f },
+    { 0.545524f, 0.838039f, 0.275626f },
+    { 0.555484f, 0.840254f, 0.269281f },
+    { 0.565498f, 0.84243f, 0.262877f },
+    { 0.575563f, 0.844566f, 0.256415f },
+    { 0.585678f, 0.846661f, 0.249897f },
+    { 0.595839f, 0.848717f, 0.243329f },
+    { 0.606045f, 0.850733f, 0.236712f },
+    { 0.616293f, 0.852709f, 0.230052f },
+    { 0.626579f, 0.854645f, 0.223353f },
+    { 0.636902f, 0.856542f, 0.21662f },
+    { 0.647257f, 0.8584f, 0.209861f },
+    { 0.657642f, 0.860219f, 0.203082f },
+    { 0.668054f, 0.861999f, 0.196293f },
+    { 0.678489f, 0.863742f, 0.189503f },
+    { 0.688944f, 0.865448f, 0.182725f },
+    { 0.699415f, 0.867117f, 0.175971f },
+    { 0.709898f, 0.868751f, 0.169257f },
+    { 0.720391f, 0.87035f, 0.162603f },
+    { 0.730889f, 0.871916f, 0.156029f },
+    { 0.741388f, 0.873449f, 0.149561f },
+    { 0.751884f, 0.874951f, 0.143228f },
+    { 0.762373f, 0.876424f, 0.137064f },
+    { 0.772852f, 0.877868f, 0.131109f },
+    { 0.783315f, 0.879285f, 0.125405f },
+    { 0.79376f, 0.880678f, 0.120005f },
+    { 0.804182f, 0.882046f, 0.114965f },
+    { 0.814576f, 0.883393f, 0.110347f },
+    { 0.82494f, 0.88472f, 0.106217f },
+    { 0.83527f, 0.886029f, 0.102646f },
+    { 0.845561f, 0.887322f, 0.099702f },
+    { 0.85581f, 0.888601f, 0.097452f },
+    { 0.866013f, 0.889868f, 0.095953f },
+    { 0.876168f, 0.891125f, 0.09525f },
+    { 0.886271f, 0.892374f, 0.095374f },
+    { 0.89632f, 0.893616f, 0.096335f },
+    { 0.906311f, 0.894855f, 0.098125f },
+    { 0.916242f, 0.896091f, 0.100717f },
+    { 0.926106f, 0.89733f, 0.104071f },
+    { 0.935904f, 0.89857f, 0.108131f },
+    { 0.945636f, 0.899815f, 0.112838f },
+    { 0.9553f, 0.901065f, 0.118128f },
+    { 0.964894f, 0.902323f, 0.123941f },
+    { 0.974417f, 0.90359f, 0.130215f },
+    { 0.983868f, 0.904867f, 0.136897f },
+    { 0.993248f, 0.906157f, 0.143936f }
+};
+
+const ColourMapEntry jetEntries[ColourMap::numEntries] =
+{
+    { 0.0f, 0.0f, 0.5f },
+    { 0.0f, 0.0f, 0.5178253f },
+    { 0.0f, 0.0f, 0.5356506f },
+    { 0.0f, 0.0f, 0.5534759f },
+    { 0.0f, 0.0f, 0.5713012f },
+    { 0.0f, 0.0f, 0.5891266f },
+    { 0.0f, 0.0f, 0.6069519f },
+    { 0.0f, 0.0f, 0.6247772f },
+    { 0.0f, 0.0f, 0.6426025f },
+    { 0.0f, 0.0f, 0.6604278f },
+    { 0.0f, 0.0f, 0.6782531f },
+    { 0.0f, 0.0f, 0.6960784f },
+    { 0.0f, 0.0f, 0.7139037f },
+    { 0.0f, 0.0f, 0.73172903f },
+    { 0.0f, 0.0f, 0.7495544f },
+    { 0.0f, 0.0f, 0.7673797f },
+    { 0.0f, 0.0f, 0.785205f },
+    { 0.0f, 0.0f, 0.8030303f },
+    { 0.0f, 0.0f, 0.8208556f },
+    { 0.0f, 0.0f, 0.8386809f },
+    { 0.0f, 0.0f, 0.8565062f },
+    { 0.0f, 0.0f, 0.87433153f },
+    { 0.0f, 0.0f, 0.89215684f },
+    { 0.0f, 0.0f, 0.9099822f },
+    { 0.0f, 0.0f, 0.9278075f },
+    { 0.0f, 0.0f, 0.9456328f },
+    { 0.0f, 0.0f, 0.9634581f },
+    { 0.0f, 0.0f, 0.9812834f },
+    { 0.0f, 0.0f, 0.99910873f },
+    { 0.0f, 0.0f, 1.0f },
+    { 0.0f, 0.0f, 1.0f },
+    { 0.0f, 0.0f, 1.0f },
+    { 0.0f, 0.0019607844f, 1.0f },
+    { 0.0f, 0.01764706f, 1.0f },
+    { 0.0f, 0.033333335f, 1.0f },
+    { 0.0f, 0.04901961f, 1.0f },
+    { 0.0f, 0.064705886f, 1.0f },
+    { 0.0f, 0.08039216f, 1.0f },
+    { 0.0f, 0.09607843f, 1.0f },
+    { 0.0f, 0.11176471f, 1.0f },
+    { 0.0f, 0.12745099f, 1.0f },
+    { 0.0f, 0.14313726f, 1.0f },
+    { 0.0f, 0.15882353f, 1.0f },
+    { 0.0f, 0.17450981f, 1.0f },
+    { 0.0f, 0.19019608f, 1.0f },
+    { 0.0f, 0.20588236f, 1.0f },
+    { 0.0f, 0.22156863f, 1.0f },
+    { 0.0f, 0.2372549f, 1.0f },
+    { 0.0f, 0.2529412f, 1.0f },
+    { 0.0f, 0.26862746f, 1.0f },
+    { 0.0f, 0.28431374f, 1.0f },
+    { 0.0f, 0.3f, 1.0f },
+    { 0.0f, 0.3156863f, 1.0f },
+    { 0.0f, 0.33137256f, 1.0f },
+    { 0.0f, 0.34705883f, 1.0f },
+    { 0.0f, 0.3627451f, 1.0f },
+    { 0.0f, 0.37843138f, 1.0f },
+    { 0.0f, 0.39411765f, 1.0f },
+    { 0.0f, 0.40980393f, 1.0f },
+    { 0.0f, 0.4254902f, 1.0f },
+    { 0.0f, 0.44117647f, 1.0f },
+    { 0.0f, 0.45686275f, 1.0f },
+    { 0.0f, 0.47254902f, 1.0f },
+    { 0.0f, 0.4882353f, 1.0f },
+    { 0.0f, 0.50392157f, 1.0f },
+    { 0.0f, 0.51960784f, 1.0f },
+    { 0.0f, 0.5352941f, 1.0f },
+    { 0.0f, 0.5509804f, 1.0f },
+    { 0.0f, 0.56666666f, 1.0f },
+    { 0.0f, 0.58235294f, 1.0f },
+    { 0.0f, 0.5980392f, 1.0f },
+    { 0.0f, 0.6137255f, 1.0f },
+    { 0.0f, 0.62941176f, 1.0f },
+    { 0.0f, 0.64509803f, 1.0f },
+    { 0.0f, 0.6607843f, 1.0f },
+    { 0.0f, 0.6764706f, 1.0f },
+    { 0.0f, 0.69215685f, 1.0f },
+    { 0.0f, 0.7078431f, 1.0f },
+    { 0.0f, 0.7235294f, 1.0f },
+    { 0.0f, 0.7392157f, 1.0f },
+    { 0.0f, 0.75490195f, 1.0f },
+    { 0.0f, 0.7705882f, 1.0f },
+    { 0.0f, 0.7862745f, 1.0f },
+    { 0.0f, 0.80196077f, 1.0f },
+    { 0.0f, 0.81764704f, 1.0f },
+    { 0.0f, 0.8333333f, 1.0f },
+    { 0.0f, 0.8490196f, 1.0f },
+    { 0.0f, 0.86470586f, 0.9962049f },
+    { 0.0f, 0.88039213f, 0.9835547f },
+    { 0.0f, 0.8960784f, 0.97090447f },
+    { 0.009487666f, 0.9117647f, 0.9582543f },
+    { 0.022137888f, 0.92745095f, 0.945604f },
+    { 0.03478811f, 0.9431372f, 0.93295383f },
+    { 0.04743833f, 0.9588235f, 0.9203036f },
+    { 0.060088553f, 0.9745098f, 0.9076534f },
+    { 0.072738774f, 0.99019605f, 0.89500314f },
+    { 0.085388996f, 1.0f, 0.88235295f },
+    { 0.09803922f, 1.0f, 0.8697027f },
+    { 0.11068944f, 1.0f, 0.8570525f },
+    { 0.12333966f, 1.0f, 0.84440225f },
+    { 0.13598987f, 1.0f, 0.83175206f },
+    { 0.1486401f, 1.0f, 0.8191018f },
+    { 0.16129032f, 1.0f, 0.8064516f },
+    { 0.17394054f, 1.0f, 0.79380137f },
+    { 0.18659076f, 1.0f, 0.7811512f },
+    { 0.19924098f, 1.0f, 0.7685009f },
+    { 0.2118912f, 1.0f, 0.75585073f },
+    { 0.22454143f, 1.0f, 0.7432005f },
+    { 0.23719165f, 1.0f, 0.7305503f },
+    { 0.24984187f, 1.0f, 0.71790004f },
+    { 0.2624921f, 1.0f, 0.70524985f },
+    { 0.2751423f, 1.0f, 0.6925996f },
+    { 0.28779253f, 1.0f, 0.6799494f },
+    { 0.30044276f, 1.0f, 0.66729915f },
+    { 0.31309298f, 1.0f, 0.65464896f },
+    { 0.3257432f, 1.0f, 0.6419987f },
+    { 0.33839342f, 1.0f, 0.6293485f },
+    { 0.35104364f, 1.0f, 0.61669827f },
+    { 0.36369386f, 1.0f, 0.6040481f },
+    { 0.37634408f, 1.0f, 0.5913978f },
+    { 0.3889943f, 1.0f, 0.57874763f },
+    { 0.40164453f, 1.0f, 0.5660974f },
+    { 0.41429475f, 1.0f, 0.5534472f },
+    { 0.42694497f, 1.0f, 0.54079694f },
+    { 0.4395952f, 1.0f, 0.52814674f },
+    { 0.4522454f, 1.0f, 0.5154965f },
+    { 0.46489564f, 1.0f, 0.5028463f },
+    { 0.47754586f, 1.0f, 0.49019608f },
+    { 0.49019608f, 1.0f, 0.47754586f },
+    { 0.5028463f, 1.0f, 0.46489564f },
+    { 0.5154965f, 1.0f, 0.4522454f },
+    { 0.52814674f, 1.0f, 0.4395952f },
+    { 0.54079694f, 1.0f, 0.42694497f },
+    { 0.5534472f, 1.0f, 0.41429475f },
+    { 0.5660974f, 1.0f, 0.40164453f },
+    { 0.57874763f, 1.0f, 0.3889943f },
+    { 0.5913978f, 1.0f, 0.37634408f },
+    { 0.6040481f, 1.0f, 0.36369386f },
+    { 0.61669827f, 1.0f, 0.35104364f },
+    { 0.6293485f, 1.0f, 0.33839342f },
+    { 0.6419987f, 1.0f, 0.3257432f },
+    { 0.65464896f, 1.0f, 0.31309298f },
+    { 0.66729915f, 1.0f, 0.30044276f },
+    { 0.6799494f, 1.0f, 0.28779253f },
+    { 0.6925996f, 1.0f, 0.2751423f },
+    { 0.70524985f, 1.0f, 0.2624921f },
+    { 0.71790004f, 1.0f, 0.24984187f },
+    { 0.7305503f, 1.0f, 0.23719165f },
+    { 0.7432005f, 1.0f, 0.22454143f },
+    { 0.75585073f, 1.0f, 0.2118912f },
+    { 0.7685009f, 1.0f, 0.19924098f },
+    { 0.7811512f, 1.0f, 0.18659076f },
+    { 0.79380137f, 1.0f, 0.17394054f },
+    { 0.8064516f, 1.0f, 0.16129032f },
+    { 0.8191018f, 1.0f, 0.1486401f },
+    { 0.83175206f, 1.0f, 0.13598987f },
+    { 0.84440225f, 1.0f, 0.12333966f },
+    { 0.8570525f, 1.0f, 0.11068944f },
+    { 0.8697027f, 1.0f, 0.09803922f },
+    { 0.88235295f, 1.0f, 0.085388996f },
+    { 0.89500314f, 1.0f, 0.072738774f },
+    { 0.9076534f, 1.0f, 0.060088553f },
+    { 0.9203036f, 1.0f, 0.04743833f },
+    { 0.93295383f, 1.0f, 0.03478811f },
+    { 0.945604f, 0.98838055f, 0.022137888f },
+    { 0.9582543f, 0.9738562f, 0.009487666f },
+    { 0.97090447f, 0.95933187f, 0.0f },
+    { 0.9835547f, 0.9448075f, 0.0f },
+    { 0.9962049f, 0.93028325f, 0.0f },
+    { 1.0f, 0.9157589f, 0.0f },
+    { 1.0f, 0.90123457f, 0.0f },
+    { 1.0f, 0.8867102f, 0.0f },
+    { 1.0f, 0.8721859f, 0.0f },
+    { 1.0f, 0.8576616f, 0.0f },
+    { 1.0f, 0.84313726f, 0.0f },
+    { 1.0f, 0.8286129f, 0.0f },
+    { 1.0f, 0.8140886f, 0.0f },
+    { 1.0f, 0.79956424f, 0.0f },
+    { 1.0f, 0.78503996f, 0.0f },
+    { 1.0f, 0.7705156f, 0.0f },
+    { 1.0f, 0.7559913f, 0.0f },
+    { 1.0f, 0.74146694f, 0.0f },
+    { 1.0f, 0.72694266f, 0.0f },
+    { 1.0f, 0.7124183f, 0.0f },
+    { 1.0f, 0.697894f, 0.0f },
+    { 1.0f, 0.68336964f, 0.0f },
+    { 1.0f, 0.6688453f, 0.0f },
+    { 1.0f, 0.654321f, 0.0f },
+    { 1.0f, 0.6397967f, 0.0f },
+    { 1.0f, 0.62527233f, 0.0f },
+    { 1.0f, 0.610748f, 0.0f },
+    { 1.0f, 0.59622365f, 0.0f },
+    { 1.0f, 0.5816994f, 0.0f },
+    { 1.0f, 0.56717503f, 0.0f },
+    { 1.0f, 0.5526507f, 0.0f },
+    { 1.0f, 0.53812635f, 0.0f },
+    { 1.0f, 0.523602f, 0.0f },
+    { 1.0f, 0.5090777f, 0.0f },
+    { 1.0f, 0.4945534f, 0.0f },
+    { 1.0f, 0.48002905f, 0.0f },
+    { 1.0f, 0.4655047f, 0.0f },
+    { 1.0f, 0.4509804f, 0.0f },
+    { 1.0f, 0.43645605f, 0.0f },
+    { 1.0f, 0.42193174f, 0.0f },
+    { 1.0f, 0.4074074f, 0.0f },
+    { 1.0f, 0.3928831f, 0.0f },
+    { 1.0f, 0.37835875f, 0.0f },
+    { 1.0f, 0.3638344f, 0.0f },
+    { 1.0f, 0.3493101f, 0.0f },
+    { 1.0f, 0.33478576f, 0.0f },
+    { 1.0f, 0.32026145f, 0.0f },
+    { 1.0f, 0.3057371f, 0.0f },
+    { 1.0f, 0.29121277f, 0.0f },
+    { 1.0f, 0.27668846f, 0.0f },
+    { 1.0f, 0.26216412f, 0.0f },
+    { 1.0f, 0.24763979f, 0.0f },
+    { 1.0f, 0.23311546f, 0.0f },
+    { 1.0f, 0.21859114f, 0.0f },
+    { 1.0f, 0.20406681f, 0.0f },
+    { 1.0f, 0.18954249f, 0.0f },
+    { 1.0f, 0.17501816f, 0.0f },
+    { 1.0f, 0.16049382f, 0.0f },
+    { 1.0f, 0.1459695f, 0.0f },
+    { 1.0f, 0.13144517f, 0.0f },
+    { 1.0f, 0.11692084f, 0.0f },
+    { 1.0f, 0.10239651f, 0.0f },
+    { 1.0f, 0.087872185f, 0.0f },
+    { 0.99910873f, 0.07334786f, 0.0f },
+    { 0.9812834f, 0.05882353f, 0.0f },
+    { 0.9634581f, 0.0442992f, 0.0f },
+    { 0.9456328f, 0.029774873f, 0.0f },
+    { 0.9278075f, 0.015250545f, 0.0f },
+    { 0.9099822f, 0.0007262164f, 0.0f },
+    { 0.89215684f, 0.0f, 0.0f },
+    { 0.87433153f, 0.0f, 0.0f },
+    { 0.8565062f, 0.0f, 0.0f },
+    { 0.8386809f, 0.0f, 0.0f },
+    { 0.8208556f, 0.0f, 0.0f },
+    { 0.8030303f, 0.0f, 0.0f },
+    { 0.785205f, 0.0f, 0.0f },
+    { 0.7673797f, 0.0f, 0.0f },
+    { 0.7495544f, 0.0f, 0.0f },
+    { 0.73172903f, 0.0f, 0.0f },
+    { 0.7139037f, 0.0f, 0.0f },
+    { 0.6960784f, 0.0f, 0.0f },
+    { 0.6782531f, 0.0f, 0.0f },
+    { 0.6604278f, 0.0f, 0.0f },
+    { 0.6426025f, 0.0f, 0.0f },
+    { 0.6247772f, 0.0f, 0.0f },
+    { 0.6069519f, 0.0f, 0.0f },
+    { 0.5891266f, 0.0f, 0.0f },
+    { 0.5713012f, 0.0f, 0.0f },
+    { 0.5534759f, 0.0f, 0.0f },
+    { 0.5356506f, 0.0f, 0.0f },
+    { 0.5178253f, 0.0f, 0.0f },
+    { 0.5f, 0.0f, 0.0f }
+};
+}
+
+#pragma mark - ColourMap -
+
+const ColourMapEntry* ColourMap::getEntries(ColourSchemeId colourScheme)
+{
+    switch (colourScheme)
+    {
+        case ColourSchemeId::MAGMA:
+            return magmaEntries;
+
+        case ColourSchemeId::PLASMA:
+            return plasmaEntries;
+
+        case ColourSchemeId::VIRIDIS:
+            return viridisEntries;
+
+        case ColourSchemeId::JET:
+            return jetEntries;
+
+        case ColourSchemeId::INFERNO:
+        default:
+            return infernoEntries;
+    }
+}
+
+int ColourMap::getIndexForNormalizedValue(float val)
+{
+    // NaN fails every comparison and ends up past the end, as it did when
+    // the entries were looked up one threshold after another
+    if (!(val <= 1.0f))
+        return numEntries - 1;
+
+    if (val <= 0.0f)
+        return 0;
+
+    return std::max(0, int(std::ceil(val * numEntries)) - 1);
+}
+
+const ColourMapEntry& ColourMap::getEntryForNormalizedValue(float val, ColourSchemeId colourScheme)
+{
+    return getEntries(colourScheme)[getIndexForNormalizedValue(val)];
+}
@@ -0,0 +1,75 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef ColourMap_hpp
+#define ColourMap_hpp
+
+namespace ProbeViewer {
+
+/**
+ *  Color mapping enumeration describing a predefined set of colors for values
+ *  0-1. The maps used and described by these values are derived from libmatplot.
+ */
+enum class ColourSchemeId : int
+{
+    INFERNO,
+    VIRIDIS,
+    PLASMA,
+    MAGMA,
+    JET
+};
+
+/** One colour of a colour map, each component in [0, 1] */
+struct ColourMapEntry
+{
+    float red;
+    float green;
+    float blue;
+};
+
+/**
+ *  The lookup tables behind ColourScheme, without JUCE, so the mapping can
+ *  be used and timed on its own
+ */
+namespace ColourMap
+{
+    /** Entries of every scheme, evenly spaced over [0, 1] */
+    constexpr int numEntries = 256;
+
+    /** The numEntries entries of a scheme, for values from 0 to 1 */
+    const ColourMapEntry* getEntries(ColourSchemeId colourScheme);
+
+    /**
+     *  Index of the entry for a value, assuming normalized [0,1) and
+     *  clipping at the bounds. Entry k covers (k / numEntries, (k + 1) /
+     *  numEntries]; NaN maps to the last entry.
+     */
+    int getIndexForNormalizedValue(float val);
+
+    /** The entry of a scheme for a value, as ::getIndexForNormalizedValue */
+    const ColourMapEntry& getEntryForNormalizedValue(float val, ColourSchemeId colourScheme);
+}
+
+}
+
+#endif /* ColourMap_hpp */
@@ -11,27 +11,16 @@
 
 #include "VisualizerWindowHeaders.h"
 
-namespace ProbeViewer {
+#include "ColourMap.hpp"
 
-/**
- *  Color mapping enumeration describing a predefined set of colors for values
- *  0-1. The maps used and described by these values are derived from libmatplot.
- */
-enum class ColourSchemeId : int
-{
-    INFERNO,
-    VIRIDIS,
-    PLASMA,
-    MAGMA,
-    JET
-};
+namespace ProbeViewer {
 
 namespace ColourScheme
 {
     /**
      *  Get the color mapping for a given value, assuming normalized [0,1) and
      *  clipping at the bounds. The color mapping used can be set using
-     *  ColourScheme::setColourScheme
+     *  ColourScheme::setColourScheme. The entries come from ColourMap.
      */
     Colour getColourForNormalizedValue(float val);
 
@@ -0,0 +1,169 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "MemoryArena.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace ProbeViewer;
+
+namespace
+{
+#if defined(__linux__)
+constexpr size_t hugePageSize = size_t(2) << 20;
+#endif
+
+size_t roundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+/** Map numBytes (possibly rounded up in mappedSize) and fault every page in */
+uint8_t* mapMemory(size_t numBytes, size_t& mappedSize)
+{
+#if defined(__linux__)
+    void* address = MAP_FAILED;
+
+#if defined(PROBE_VIEWER_HUGE_PAGES) && defined(MAP_HUGETLB)
+    mappedSize = roundUp(numBytes, hugePageSize);
+    address = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+    // no reserved huge pages (or not asked for), use regular ones
+    if (address == MAP_FAILED)
+    {
+        mappedSize = roundUp(numBytes, size_t(sysconf(_SC_PAGESIZE)));
+        address = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (address == MAP_FAILED)
+            return nullptr;
+
+#if defined(MADV_HUGEPAGE)
+        if (mappedSize >= hugePageSize)
+            madvise(address, mappedSize, MADV_HUGEPAGE);
+#endif
+    }
+
+    // touch every page now, on the message thread
+    std::memset(address, 0, mappedSize);
+
+#if defined(PROBE_VIEWER_LOCK_MEMORY)
+    // best effort: without CAP_IPC_LOCK or enough RLIMIT_MEMLOCK this fails and the pages stay swappable
+    mlock(address, mappedSize);
+#endif
+
+    return static_cast<uint8_t*>(address);
+#else
+    mappedSize = numBytes;
+
+    // calloc may hand out lazily committed pages, so write them explicitly
+    void* address = std::malloc(numBytes);
+
+    if (address != nullptr)
+        std::memset(address, 0, numBytes);
+
+    return static_cast<uint8_t*>(address);
+#endif
+}
+
+void unmapMemory(uint8_t* address, size_t mappedSize)
+{
+    if (address == nullptr)
+        return;
+
+#if defined(__linux__)
+    munmap(address, mappedSize);
+#else
+    (void) mappedSize;
+    std::free(address);
+#endif
+}
+}
+
+MemoryArena::MemoryArena()
+    : data(nullptr)
+    , capacity(0)
+    , numBytesUsed(0)
+    , mappedSize(0)
+{ }
+
+MemoryArena::~MemoryArena()
+{
+    release();
+}
+
+bool MemoryArena::reserve(size_t numBytes)
+{
+    if (numBytes <= capacity)
+        return true;
+
+    release();
+
+    // the base is only page aligned off Linux, so keep room to align the first piece
+    data = mapMemory(numBytes + defaultAlignment, mappedSize);
+    capacity = data != nullptr ? numBytes : 0;
+
+    return data != nullptr;
+}
+
+void MemoryArena::rewind()
+{
+    numBytesUsed = 0;
+}
+
+void* MemoryArena::allocate(size_t numBytes)
+{
+    if (data == nullptr)
+        return nullptr;
+
+    const auto base = reinterpret_cast<uintptr_t>(data);
+    const size_t start = roundUp(base + numBytesUsed, defaultAlignment) - base;
+
+    if (start + numBytes > capacity + defaultAlignment)
+        return nullptr;
+
+    numBytesUsed = start + numBytes;
+
+    return data + start;
+}
+
+void MemoryArena::release()
+{
+    unmapMemory(data, mappedSize);
+
+    data = nullptr;
+    capacity = 0;
+    numBytesUsed = 0;
+    mappedSize = 0;
+}
+
+size_t MemoryArena::getPaddedSize(size_t numBytes)
+{
+    return roundUp(numBytes, defaultAlignment);
+}
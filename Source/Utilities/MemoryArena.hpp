@@ -0,0 +1,99 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef MemoryArena_hpp
+#define MemoryArena_hpp
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ProbeViewer {
+
+/**
+ *  A grow-only block of memory that its owner carves into aligned pieces
+ *  and reuses every time its layout changes, so reconfiguring does not
+ *  return memory to the system only to fault it back in on the audio
+ *  thread.
+ *
+ *  New memory is pre-faulted when it is mapped. On Linux it is advised for
+ *  transparent huge pages, and can be backed by MAP_HUGETLB pages or locked
+ *  with mlock when built with PROBE_VIEWER_HUGE_PAGES or
+ *  PROBE_VIEWER_LOCK_MEMORY.
+ *
+ *  Not thread-safe: the owner must make sure nothing uses the pieces while
+ *  it calls ::reserve, ::rewind or ::release.
+ */
+class MemoryArena
+{
+public:
+    /** Alignment of every piece, a cache line */
+    static constexpr size_t defaultAlignment = 64;
+
+    MemoryArena();
+    ~MemoryArena();
+
+    /**
+     *  Make sure at least numBytes can be allocated after a ::rewind. The
+     *  memory is only remapped (losing its contents) if it has to grow.
+     *  Returns false, holding no memory, if the system could not map it.
+     */
+    bool reserve(size_t numBytes);
+
+    /** Forget every piece, keeping the memory */
+    void rewind();
+
+    /**
+     *  Return the next piece of numBytes, aligned to defaultAlignment, or
+     *  nullptr if it does not fit in the reserved memory (or ::reserve
+     *  failed). The contents are whatever the previous layout left there.
+     */
+    void* allocate(size_t numBytes);
+
+    template <typename Type>
+    Type* allocateArray(size_t numItems) { return static_cast<Type*>(allocate(numItems * sizeof(Type))); }
+
+    /** Return the memory to the system */
+    void release();
+
+    /** Bytes to ::reserve for a piece of numBytes, including its alignment */
+    static size_t getPaddedSize(size_t numBytes);
+
+    size_t getCapacity() const { return capacity; }
+
+    size_t getNumBytesUsed() const { return numBytesUsed; }
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+private:
+    uint8_t* data;
+    size_t capacity;
+    size_t numBytesUsed;
+
+    /** Size of the mapping, which may exceed capacity when rounded to huge pages */
+    size_t mappedSize;
+};
+
+}
+
+#endif /* MemoryArena_hpp */
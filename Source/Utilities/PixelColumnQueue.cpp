@@ -0,0 +1,91 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "PixelColumnQueue.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace ProbeViewer;
+
+PixelColumnQueue::PixelColumnQueue()
+    : numValues(0)
+    , capacity(0)
+    , writePosition(0)
+    , readPosition(0)
+{ }
+
+void PixelColumnQueue::prepare(int numValues_, int capacity_)
+{
+    numValues = std::max(0, numValues_);
+    capacity = std::max(0, capacity_);
+
+    columns.assign(size_t(numValues) * capacity, 0.0f);
+
+    writePosition.store(0, std::memory_order_relaxed);
+    readPosition.store(0, std::memory_order_relaxed);
+}
+
+float* PixelColumnQueue::getColumn(int64_t position)
+{
+    return columns.data() + size_t(position % capacity) * numValues;
+}
+
+int PixelColumnQueue::getNumFree() const
+{
+    // acquire, so the consumer is done reading the columns it popped
+    const int64_t read = readPosition.load(std::memory_order_acquire);
+    return capacity - int(writePosition.load(std::memory_order_relaxed) - read);
+}
+
+float* PixelColumnQueue::getWritableColumn(int index)
+{
+    assert(index < getNumFree());
+    return getColumn(writePosition.load(std::memory_order_relaxed) + index);
+}
+
+void PixelColumnQueue::finishPush(int numColumns)
+{
+    assert(numColumns <= getNumFree());
+    writePosition.store(writePosition.load(std::memory_order_relaxed) + numColumns, std::memory_order_release);
+}
+
+int PixelColumnQueue::getNumReady() const
+{
+    const int64_t written = writePosition.load(std::memory_order_acquire);
+    return int(written - readPosition.load(std::memory_order_relaxed));
+}
+
+const float* PixelColumnQueue::getReadableColumn(int index) const
+{
+    assert(index < getNumReady());
+    const int64_t position = readPosition.load(std::memory_order_relaxed) + index;
+    return columns.data() + size_t(position % capacity) * numValues;
+}
+
+void PixelColumnQueue::pop(int numColumns)
+{
+    assert(numColumns <= getNumReady());
+    readPosition.store(readPosition.load(std::memory_order_relaxed) + numColumns, std::memory_order_release);
+}
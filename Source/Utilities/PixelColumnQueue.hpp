@@ -0,0 +1,97 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef PixelColumnQueue_hpp
+#define PixelColumnQueue_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  A bounded, lock-free single-producer / single-consumer queue of pixel
+ *  columns, each holding the same number of values. How the values are
+ *  laid out within a column is up to the producer and consumer.
+ *
+ *  The analysis thread fills columns in place: it asks how many are free,
+ *  writes up to that many with ::getWritableColumn, then publishes them
+ *  with ::finishPush. The renderer reads the published columns with
+ *  ::getReadableColumn and frees them with ::pop. When the queue is full
+ *  the producer simply produces less, leaving its input unread.
+ */
+class PixelColumnQueue
+{
+public:
+    PixelColumnQueue();
+
+    /**
+     *  Size the queue and empty it. Not thread-safe; neither side may use
+     *  the queue meanwhile.
+     */
+    void prepare(int numValues, int capacity);
+
+    int getNumValues() const { return numValues; }
+    int getCapacity() const { return capacity; }
+
+    // PRODUCER SIDE
+
+    /** Number of columns that can be written before the next ::finishPush */
+    int getNumFree() const;
+
+    /** The index-th unpublished column; index must be below ::getNumFree */
+    float* getWritableColumn(int index);
+
+    /** Publish the first numColumns unpublished columns to the consumer */
+    void finishPush(int numColumns);
+
+    // CONSUMER SIDE
+
+    /** Number of published columns that have not been popped */
+    int getNumReady() const;
+
+    /** The index-th published column, oldest first */
+    const float* getReadableColumn(int index) const;
+
+    /** Free the oldest numColumns published columns */
+    void pop(int numColumns);
+
+private:
+    float* getColumn(int64_t position);
+
+    int numValues;
+    int capacity;
+
+    std::vector<float> columns;     // capacity x numValues
+
+    // the producer owns writePosition and the consumer readPosition; each
+    // only reads the other's, on its own cache line
+    alignas(64) std::atomic<int64_t> writePosition;
+    alignas(64) std::atomic<int64_t> readPosition;
+};
+
+}
+
+#endif /* PixelColumnQueue_hpp */
@@ -0,0 +1,142 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "RingBufferCursor.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace ProbeViewer;
+
+RingBufferCursor::RingBufferCursor()
+    : capacity(0)
+    , writePosition(0)
+    , readPosition(0)
+    , reservedWritePosition(0)
+    , publishedWritePosition(0)
+    , maxBlockSize(0)
+{ }
+
+void RingBufferCursor::reset(int capacity_)
+{
+    capacity = capacity_;
+
+    writePosition = 0;
+    readPosition = 0;
+
+    reservedWritePosition.store(0);
+    publishedWritePosition.store(0);
+    maxBlockSize.store(0);
+}
+
+int RingBufferCursor::getIndexForPosition(int64_t position) const
+{
+    return capacity > 0 ? int(position % capacity) : 0;
+}
+
+void RingBufferCursor::beginWrite(int numItems)
+{
+    if (numItems > maxBlockSize.load(std::memory_order_relaxed))
+        maxBlockSize.store(numItems, std::memory_order_relaxed);
+
+    // the reservation must be visible before any slot of the block is
+    // overwritten, so that readers can tell their range was clobbered
+    reservedWritePosition.store(writePosition + numItems, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void RingBufferCursor::endWrite(int numItems)
+{
+    writePosition += numItems;
+
+    publishedWritePosition.store(writePosition, std::memory_order_release);
+}
+
+bool RingBufferCursor::hasItemsReady() const
+{
+    return publishedWritePosition.load(std::memory_order_acquire) != readPosition;
+}
+
+RingBufferCursor::Range RingBufferCursor::beginRead()
+{
+    Range range;
+
+    range.start = readPosition;
+    range.end = publishedWritePosition.load(std::memory_order_acquire);
+
+    // keep one block of headroom so the writer's next block does not land
+    // on slots that are still being read
+    const int64_t maxReadable = std::max(0, capacity - maxBlockSize.load(std::memory_order_relaxed));
+
+    if (range.end - range.start > maxReadable)
+    {
+        range.numSkipped = range.end - maxReadable - range.start;
+        range.start = range.end - maxReadable;
+        range.overrun = true;
+
+        readPosition = range.start;
+    }
+
+    return range;
+}
+
+bool RingBufferCursor::isRangeIntact(const Range& range) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return range.start >= reservedWritePosition.load(std::memory_order_relaxed) - capacity;
+}
+
+bool RingBufferCursor::endRead(const Range& range)
+{
+    return commitRead(range, range.getLength());
+}
+
+bool RingBufferCursor::commitRead(const Range& range, int64_t numItems)
+{
+    assert(numItems >= 0 && numItems <= range.getLength());
+
+    const bool intact = isRangeIntact(range);
+
+    readPosition = range.start + numItems;
+
+    return intact;
+}
+
+void RingBufferCursor::skipToEnd()
+{
+    readPosition = publishedWritePosition.load(std::memory_order_acquire);
+}
+
+void RingBufferCursor::skipOverrun()
+{
+    beginRead();
+}
+
+void RingBufferCursor::seek(int64_t position)
+{
+    const int64_t published = publishedWritePosition.load(std::memory_order_acquire);
+    const int64_t maxReadable = std::max(0, capacity - maxBlockSize.load(std::memory_order_relaxed));
+
+    readPosition = std::min(published, std::max(position, std::max(int64_t(0), published - maxReadable)));
+}
@@ -0,0 +1,145 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef RingBufferCursor_hpp
+#define RingBufferCursor_hpp
+
+#include <atomic>
+#include <cstdint>
+
+namespace ProbeViewer {
+
+/**
+ *  Read and write positions for a single-producer/single-consumer ring of
+ *  a fixed number of slots. The cursor does not own any storage; it only
+ *  tells each side which slots it may touch.
+ *
+ *  Positions are monotonically increasing slot counts, so they never wrap
+ *  and a lapped reader can always be detected.
+ */
+class RingBufferCursor
+{
+public:
+    /**
+     *  A consistent snapshot of the readable slots, from ::beginRead.
+     */
+    struct Range
+    {
+        int64_t start = 0;
+        int64_t end = 0;
+
+        /** True if the writer lapped the reader and the oldest slots were skipped */
+        bool overrun = false;
+
+        /** Number of slots skipped because of the overrun */
+        int64_t numSkipped = 0;
+
+        int getLength() const { return int(end - start); }
+    };
+
+    RingBufferCursor();
+
+    /** Set the number of slots and rewind both sides. Not thread-safe. */
+    void reset(int capacity);
+
+    int getCapacity() const { return capacity; }
+
+    /** Map a position to its slot index */
+    int getIndexForPosition(int64_t position) const;
+
+    // WRITER SIDE (one thread only)
+
+    /**
+     *  Announce that the next numItems slots are about to be overwritten.
+     *  Readers check this reservation to detect ranges that were clobbered
+     *  while they were reading them.
+     */
+    void beginWrite(int numItems);
+
+    /** Publish the slots announced by ::beginWrite to the reader */
+    void endWrite(int numItems);
+
+    /** Position of the first slot that has not been published yet */
+    int64_t getWritePosition() const { return writePosition; }
+
+    // READER SIDE (one thread only)
+
+    /** Returns true if slots were published since the last read */
+    bool hasItemsReady() const;
+
+    /**
+     *  Take a snapshot of the slots that can be read. If the writer has
+     *  lapped the reader, the range starts at the oldest slot that is still
+     *  intact and Range::overrun is set.
+     */
+    Range beginRead();
+
+    /** Returns false if the writer started overwriting any slot of the range */
+    bool isRangeIntact(const Range& range) const;
+
+    /** Mark the range as read; returns the result of ::isRangeIntact */
+    bool endRead(const Range& range);
+
+    /**
+     *  Mark only the first numItems slots of the range as read, leaving the
+     *  rest to start the next range; returns the result of ::isRangeIntact
+     */
+    bool commitRead(const Range& range, int64_t numItems);
+
+    /** Discard every published slot */
+    void skipToEnd();
+
+    /**
+     *  Fast-forward past the slots the writer has lapped, as ::beginRead
+     *  would, without taking a range
+     */
+    void skipOverrun();
+
+    /**
+     *  Move the read position, clamped to the published slots that are
+     *  still intact. Seeking backwards re-reads slots that were read before.
+     */
+    void seek(int64_t position);
+
+    /** Position of the first slot that has not been read yet */
+    int64_t getReadPosition() const { return readPosition; }
+
+private:
+    int capacity;
+
+    // writer state, only touched by the producer
+    int64_t writePosition;
+
+    // reader state, only touched by the consumer
+    int64_t readPosition;
+
+    std::atomic<int64_t> reservedWritePosition;
+    std::atomic<int64_t> publishedWritePosition;
+
+    /** Largest block seen, kept free between the reader and the writer */
+    std::atomic<int> maxBlockSize;
+};
+
+}
+
+#endif /* RingBufferCursor_hpp */
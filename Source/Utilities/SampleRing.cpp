@@ -0,0 +1,147 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#include "SampleRing.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace ProbeViewer;
+
+namespace
+{
+/** Scale floats to int16 with rounding and saturation; written so it auto-vectorizes */
+void quantizeToInt16(int16_t* dest, const float* source, float scale, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float scaled = std::min(32767.0f, std::max(-32768.0f, source[i] * scale));
+        dest[i] = int16_t(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+    }
+}
+}
+
+#pragma mark - SampleRing -
+
+SampleRing::SampleRing()
+    : numRows(0)
+    , length(0)
+    , storage(SampleStorage::FLOAT32)
+    , writeIndex(0)
+    , firstRow(nullptr)
+    , rowStride(0)
+{ }
+
+bool SampleRing::prepare(int numRows_, int length_, SampleStorage storage_)
+{
+    numRows = std::max(0, numRows_);
+    length = std::max(0, length_);
+    storage = storage_;
+    writeIndex = 0;
+
+    // every row starts on a cache line, and is followed by at least one full
+    // line of padding so a vector load at any sample stays inside the row
+    const size_t bytesPerSample = storage == SampleStorage::INT16 ? sizeof(int16_t) : sizeof(float);
+    const size_t rowBytes = size_t(length) * bytesPerSample;
+    rowStride = (rowBytes + rowAlignment - 1) / rowAlignment * rowAlignment + rowAlignment;
+
+    // not cleared: the owner never lets the reader see a slot before it is written
+    if (!rowMemory.reserve(MemoryArena::getPaddedSize(size_t(numRows) * rowStride)))
+    {
+        release();
+        return false;
+    }
+
+    rowMemory.rewind();
+
+    firstRow = static_cast<uint8_t*>(rowMemory.allocate(size_t(numRows) * rowStride));
+
+    return true;
+}
+
+void SampleRing::release()
+{
+    rowMemory.release();
+    firstRow = nullptr;
+    rowStride = 0;
+    numRows = 0;
+    length = 0;
+    writeIndex = 0;
+}
+
+void SampleRing::writeRow(int row, const float* source, float voltsToBits, int numSamples)
+{
+    assert(firstRow != nullptr && row < numRows && numSamples <= length);
+
+    const int samplesBeforeWrap = std::min(numSamples, length - writeIndex);
+    const int samplesAfterWrap = numSamples - samplesBeforeWrap;
+
+    if (storage == SampleStorage::INT16)
+    {
+        int16_t* dest = getRow<int16_t>(row);
+
+        quantizeToInt16(dest + writeIndex, source, voltsToBits, samplesBeforeWrap);
+
+        if (samplesAfterWrap > 0)
+            quantizeToInt16(dest, source + samplesBeforeWrap, voltsToBits, samplesAfterWrap);
+    }
+    else
+    {
+        float* dest = getRow<float>(row);
+
+        std::memcpy(dest + writeIndex, source, sizeof(float) * size_t(samplesBeforeWrap));
+
+        if (samplesAfterWrap > 0)
+            std::memcpy(dest, source + samplesBeforeWrap, sizeof(float) * size_t(samplesAfterWrap));
+    }
+}
+
+void SampleRing::advance(int numSamples)
+{
+    writeIndex += numSamples;
+
+    if (writeIndex >= length)
+        writeIndex -= length;
+}
+
+template <typename SampleType>
+SampleRing::Spans<SampleType> SampleRing::getSpans(int row, int startIndex, int numSamples) const
+{
+    assert(firstRow != nullptr && row < numRows && startIndex < length && numSamples <= length);
+    assert((storage == SampleStorage::INT16) == (sizeof(SampleType) == sizeof(int16_t)));
+
+    const SampleType* samples = getRow<SampleType>(row);
+
+    Spans<SampleType> spans;
+
+    spans.first = samples + startIndex;
+    spans.firstSize = std::min(numSamples, length - startIndex);
+    spans.second = samples;
+    spans.secondSize = numSamples - spans.firstSize;
+
+    return spans;
+}
+
+template SampleRing::Spans<float> SampleRing::getSpans<float>(int, int, int) const;
+template SampleRing::Spans<int16_t> SampleRing::getSpans<int16_t>(int, int, int) const;
@@ -0,0 +1,145 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+#ifndef SampleRing_hpp
+#define SampleRing_hpp
+
+#include "MemoryArena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ProbeViewer {
+
+/**
+ *  Sample format used for raw sample storage.
+ */
+enum class SampleStorage : int
+{
+    /** Store the incoming floats unchanged */
+    FLOAT32,
+
+    /**
+     *  Quantize to int16 in units of each channel's bitVolts. Halves memory
+     *  and bandwidth; exact for data that comes straight from an ADC.
+     */
+    INT16
+};
+
+/**
+ *  The raw samples of every display row of a stream, in a ring shared by
+ *  the rows: they are all written at the same index, so they all wrap at
+ *  the same sample.
+ *
+ *  The writer stores a block with ::writeRow for every row, then moves
+ *  the write index past it with ::advance. Which samples may be read is
+ *  up to the owner (see RingBufferCursor); ::getSpans returns them in
+ *  place, as at most two contiguous runs per row.
+ *
+ *  Not thread-safe beyond that: ::prepare and ::release must not overlap
+ *  any other call.
+ */
+class SampleRing
+{
+public:
+    SampleRing();
+
+    /**
+     *  One row's samples between two ring indices, as at most two
+     *  contiguous runs: the part before the ring wraps, then the part after
+     *  it (empty unless the range wraps).
+     */
+    template <typename SampleType>
+    struct Spans
+    {
+        const SampleType* first = nullptr;
+        int firstSize = 0;
+        const SampleType* second = nullptr;
+        int secondSize = 0;
+    };
+
+    /**
+     *  Lay out numRows rows of length samples in storage's format, reusing
+     *  the memory of the previous layout when it is large enough, and
+     *  rewind the write index. The samples are not cleared. Returns false,
+     *  holding no memory, if the rows could not be reserved.
+     */
+    bool prepare(int numRows, int length, SampleStorage storage);
+
+    /** Free the rows */
+    void release();
+
+    bool isPrepared() const { return firstRow != nullptr; }
+
+    int getNumRows() const { return numRows; }
+    int getLength() const { return length; }
+    SampleStorage getStorage() const { return storage; }
+
+    /** The index the next block is written at */
+    int getWriteIndex() const { return writeIndex; }
+
+    /**
+     *  Store numSamples samples of a row at the write index, wrapping
+     *  around the end of the ring. In SampleStorage::INT16 each sample is
+     *  multiplied by voltsToBits, rounded and saturated; otherwise
+     *  voltsToBits is ignored.
+     */
+    void writeRow(int row, const float* source, float voltsToBits, int numSamples);
+
+    /** Move the write index past a block written to every row */
+    void advance(int numSamples);
+
+    /**
+     *  Return the numSamples samples of a row from the ring index
+     *  startIndex on. SampleType must match the storage format.
+     */
+    template <typename SampleType>
+    Spans<SampleType> getSpans(int row, int startIndex, int numSamples) const;
+
+    SampleRing(const SampleRing&) = delete;
+    SampleRing& operator=(const SampleRing&) = delete;
+
+private:
+    /** Alignment of every row, in bytes */
+    static constexpr size_t rowAlignment = MemoryArena::defaultAlignment;
+
+    template <typename SampleType>
+    SampleType* getRow(int row) const { return reinterpret_cast<SampleType*>(firstRow + size_t(row) * rowStride); }
+
+    int numRows;
+    int length;
+    SampleStorage storage;
+    int writeIndex;
+
+    /**
+     *  Rows of length floats or int16s (per storage), rowStride bytes apart
+     *  starting at firstRow
+     */
+    MemoryArena rowMemory;
+    uint8_t* firstRow;
+    size_t rowStride;
+};
+
+}
+
+#endif /* SampleRing_hpp */
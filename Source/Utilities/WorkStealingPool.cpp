@@ -0,0 +1,232 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+
+using namespace ProbeViewer;
+
+namespace
+{
+uint64_t packRange(int begin, int end)
+{
+    return uint64_t(uint32_t(begin)) | (uint64_t(uint32_t(end)) << 32);
+}
+
+int getRangeBegin(uint64_t range) { return int(uint32_t(range)); }
+int getRangeEnd(uint64_t range) { return int(uint32_t(range >> 32)); }
+}
+
+WorkStealingPool::WorkStealingPool(int maxThreads)
+    : jobFunction(nullptr)
+    , jobContext(nullptr)
+    , jobNumItems(0)
+    , jobChunkSize(1)
+    , generation(0)
+    , numBusyWorkers(0)
+    , shouldExit(false)
+{
+    setMaxThreads(maxThreads);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    stopWorkers();
+}
+
+void WorkStealingPool::setMaxThreads(int maxThreads)
+{
+    const int numCores = std::max(1, int(std::thread::hardware_concurrency()));
+    const int numThreads = maxThreads > 0 ? std::min(maxThreads, numCores) : numCores;
+
+    if (queues != nullptr && numThreads == getNumThreads())
+        return;
+
+    stopWorkers();
+
+    queues.reset(new ChunkQueue[numThreads]);
+    startWorkers(numThreads - 1);
+}
+
+void WorkStealingPool::startWorkers(int numWorkers)
+{
+    shouldExit = false;
+
+    // each worker waits for the generation after the current one, so a job
+    // posted before it first takes the lock is not missed
+    for (int i = 1; i <= numWorkers; ++i)
+        workers.emplace_back([this, i, startGeneration = generation] { workerLoop(i, startGeneration); });
+}
+
+void WorkStealingPool::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shouldExit = true;
+    }
+
+    startCondition.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+
+    workers.clear();
+}
+
+void WorkStealingPool::workerLoop(int threadIndex, uint64_t seenGeneration)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCondition.wait(lock, [&] { return shouldExit || generation != seenGeneration; });
+
+            if (shouldExit)
+                return;
+
+            seenGeneration = generation;
+        }
+
+        work(threadIndex);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (--numBusyWorkers == 0)
+            doneCondition.notify_one();
+    }
+}
+
+void WorkStealingPool::run(int numItems, int chunkSize, ChunkFunction function, void* context)
+{
+    if (numItems <= 0)
+        return;
+
+    chunkSize = std::max(1, chunkSize);
+    const int numChunks = (numItems + chunkSize - 1) / chunkSize;
+
+    if (workers.empty() || numChunks == 1)
+    {
+        for (int begin = 0; begin < numItems; begin += chunkSize)
+            function(context, begin, std::min(numItems, begin + chunkSize), 0);
+
+        return;
+    }
+
+    // deal out contiguous shares, so without stealing each thread keeps to
+    // neighbouring channels
+    const int numThreads = getNumThreads();
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        const int begin = int(int64_t(numChunks) * i / numThreads);
+        const int end = int(int64_t(numChunks) * (i + 1) / numThreads);
+        queues[i].range.store(packRange(begin, end), std::memory_order_relaxed);
+    }
+
+    {
+        // releasing the lock publishes the shares and the job to the workers
+        std::lock_guard<std::mutex> lock(mutex);
+
+        jobFunction = function;
+        jobContext = context;
+        jobNumItems = numItems;
+        jobChunkSize = chunkSize;
+
+        numBusyWorkers = int(workers.size());
+        ++generation;
+    }
+
+    startCondition.notify_all();
+
+    work(0);
+
+    // the workers may still be inside the job, which lives on our stack
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return numBusyWorkers == 0; });
+}
+
+void WorkStealingPool::work(int threadIndex)
+{
+    const int numThreads = getNumThreads();
+    int chunk;
+
+    auto runChunk = [this, threadIndex](int chunkIndex)
+    {
+        const int begin = chunkIndex * jobChunkSize;
+        jobFunction(jobContext, begin, std::min(jobNumItems, begin + jobChunkSize), threadIndex);
+    };
+
+    while (popFront(queues[threadIndex], chunk))
+        runChunk(chunk);
+
+    // no chunks are added during a job, so one pass over the others is enough
+    for (int offset = 1; offset < numThreads; ++offset)
+    {
+        ChunkQueue& victim = queues[(threadIndex + offset) % numThreads];
+
+        while (stealBack(victim, chunk))
+            runChunk(chunk);
+    }
+}
+
+bool WorkStealingPool::popFront(ChunkQueue& queue, int& chunk)
+{
+    uint64_t range = queue.range.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const int begin = getRangeBegin(range);
+        const int end = getRangeEnd(range);
+
+        if (begin >= end)
+            return false;
+
+        if (queue.range.compare_exchange_weak(range, packRange(begin + 1, end), std::memory_order_acq_rel))
+        {
+            chunk = begin;
+            return true;
+        }
+    }
+}
+
+bool WorkStealingPool::stealBack(ChunkQueue& queue, int& chunk)
+{
+    uint64_t range = queue.range.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const int begin = getRangeBegin(range);
+        const int end = getRangeEnd(range);
+
+        if (begin >= end)
+            return false;
+
+        if (queue.range.compare_exchange_weak(range, packRange(begin, end - 1), std::memory_order_acq_rel))
+        {
+            chunk = end - 1;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ ------------------------------------------------------------------
+
+ This file is part of the Open Ephys GUI
+ Copyright (C) 2017 Open Ephys
+
+ ------------------------------------------------------------------
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ */
+
+
+#ifndef WorkStealingPool_hpp
+#define WorkStealingPool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ProbeViewer {
+
+/**
+ *  A small fork-join pool for splitting a loop over channels across cores.
+ *
+ *  ::parallelFor cuts the items into chunks and deals every participant
+ *  (the workers plus the calling thread) a contiguous share of them. A
+ *  participant that runs out takes chunks from the back of another one's
+ *  share, so uneven chunks (say, channels that need an FFT) even out.
+ *
+ *  Which thread runs a chunk is not deterministic, but every item is run
+ *  exactly once, so work that only touches its own items produces the same
+ *  output whatever the scheduling.
+ *
+ *  ::parallelFor must only be called from one thread at a time, and
+ *  allocates nothing once the pool is started.
+ */
+class WorkStealingPool
+{
+public:
+    /** Creates a pool using up to maxThreads threads, the caller included; 0 for every core */
+    explicit WorkStealingPool(int maxThreads = 0);
+    ~WorkStealingPool();
+
+    /**
+     *  Cap the number of threads, the caller included, so that several
+     *  instances can share the machine; 0 for every core. Restarts the
+     *  workers; must not be called during ::parallelFor.
+     */
+    void setMaxThreads(int maxThreads);
+
+    /** Number of threads a ::parallelFor runs on, the caller included */
+    int getNumThreads() const { return int(workers.size()) + 1; }
+
+    /**
+     *  Call fn(begin, end, threadIndex) for consecutive chunks of at most
+     *  chunkSize items covering [0, numItems), and return once every chunk
+     *  has run. threadIndex is in [0, ::getNumThreads) and identifies the
+     *  thread running the chunk, e.g. to pick its scratch buffers; the
+     *  calling thread is 0.
+     */
+    template <typename Function>
+    void parallelFor(int numItems, int chunkSize, Function&& fn)
+    {
+        typedef typename std::remove_reference<Function>::type FunctionType;
+
+        run(numItems, chunkSize,
+            [](void* context, int begin, int end, int threadIndex)
+            {
+                (*static_cast<FunctionType*>(context))(begin, end, threadIndex);
+            },
+            const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+private:
+    typedef void (*ChunkFunction)(void* context, int begin, int end, int threadIndex);
+
+    /** One participant's share of chunks, packed as begin | end << 32 so owner and thieves can CAS it */
+    struct alignas(64) ChunkQueue
+    {
+        std::atomic<uint64_t> range { 0 };
+    };
+
+    void run(int numItems, int chunkSize, ChunkFunction function, void* context);
+
+    /** Run chunks from the participant's own share, then from the others' */
+    void work(int threadIndex);
+
+    bool popFront(ChunkQueue& queue, int& chunk);
+    bool stealBack(ChunkQueue& queue, int& chunk);
+
+    void startWorkers(int numWorkers);
+    void stopWorkers();
+    void workerLoop(int threadIndex, uint64_t seenGeneration);
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<ChunkQueue[]> queues;
+
+    // the job being run, written before generation is bumped
+    ChunkFunction jobFunction;
+    void* jobContext;
+    int jobNumItems;
+    int jobChunkSize;
+
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    uint64_t generation;
+    int numBusyWorkers;
+    bool shouldExit;
+};
+
+}
+
+#endif /* WorkStealingPool_hpp */